@@ -30,8 +30,8 @@
 #include <fstream>
 #include <filesystem>
 #include <ftp/ftp_exception.hpp>
+#include <ftp/stream/file_output_stream.hpp>
 #include <ftp/stream/istream_adapter.hpp>
-#include <ftp/stream/ostream_adapter.hpp>
 
 command_handler::command_handler()
 {
@@ -359,6 +359,9 @@ void command_handler::put(const std::vector<std::string> & args)
         throw cmdline_exception("usage: put local-file [ remote-file ]");
     }
 
+    /* Not mapped: a file truncated by another process during the upload
+     * must not crash the client.
+     */
     std::ifstream ifs(local_file, std::ios_base::binary);
 
     if (!ifs)
@@ -367,6 +370,15 @@ void command_handler::put(const std::vector<std::string> & args)
     }
 
     transfer_callback transfer_cb;
+
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(local_file, ec);
+
+    if (!ec)
+    {
+        transfer_cb.set_total_size(size);
+    }
+
     ftp_client_.upload_file(ftp::istream_adapter(ifs), remote_file, false, &transfer_cb);
 }
 
@@ -404,15 +416,23 @@ void command_handler::get(const std::vector<std::string> & args)
         throw cmdline_exception("File '%1%' already exists.", local_file);
     }
 
-    std::ofstream ofs(local_file, std::ios_base::binary);
+    ftp::replies replies;
 
-    if (!ofs)
     {
-        throw cmdline_exception("Cannot create file '%1%'.", local_file);
-    }
+        /* Do not pollute the page cache with large files. */
+        ftp::file_output_stream dst(local_file, ftp::file_output_stream::cache_mode::drop_behind);
 
-    transfer_callback transfer_cb;
-    ftp::replies replies = ftp_client_.download_file(ftp::ostream_adapter(ofs), remote_file, &transfer_cb);
+        ftp::file_size_reply size_reply = ftp_client_.get_file_size(remote_file);
+
+        if (size_reply.get_size())
+        {
+            dst.preallocate(size_reply.get_size().value());
+        }
+
+        transfer_callback transfer_cb;
+        transfer_cb.set_total_size(size_reply.get_size());
+        replies = ftp_client_.download_file(dst, remote_file, &transfer_cb);
+    }
 
     /* Delete the created file in case of errors. */
     if (!replies.is_positive())
@@ -23,45 +23,43 @@
  */
 
 #include "transfer_callback.hpp"
+#include <boost/format.hpp>
 #include <iostream>
 
-transfer_callback::transfer_callback()
-    : line_len_(0)
-{}
-
 void transfer_callback::begin()
 {
-    time_ = std::chrono::steady_clock::now();
-
-    std::string str = "Transmitting data...";
-    line_len_ = str.size();
+    ftp::progress_reporter::begin();
 
-    std::cout << str;
+    std::cout << "Transmitting data...";
     std::cout.flush();
 }
 
-void transfer_callback::notify(std::size_t bytes_transferred)
+void transfer_callback::end()
+{
+    ftp::progress_reporter::end();
+
+    std::cout << std::endl;
+}
+
+void transfer_callback::on_progress(const ftp::progress & progress)
 {
-    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-    std::chrono::seconds elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - time_);
+    std::cout << "\r" << progress.bytes_transferred << " bytes";
 
-    if (elapsed.count() > 1)
+    if (progress.total_size && progress.total_size.value() > 0)
     {
-        time_ = now;
+        std::cout << boost::format(" (%1%%%)") % (progress.bytes_transferred * 100 / progress.total_size.value());
+    }
+
+    std::cout << boost::format(", %.1f KiB/s") % (progress.throughput / 1024);
 
-        if (line_len_ >= 80)
-        {
-            line_len_ = 0;
-            std::cout << std::endl;
-        }
+    if (progress.eta && !progress.done)
+    {
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(progress.eta.value()).count();
 
-        line_len_++;
-        std::cout << ".";
-        std::cout.flush();
+        std::cout << boost::format(", %1%:%2$02d left") % (seconds / 60) % (seconds % 60);
     }
-}
 
-void transfer_callback::end()
-{
-    std::cout << std::endl;
+    /* Clear the rest of the previous line. */
+    std::cout << "          ";
+    std::cout.flush();
 }
@@ -25,23 +25,19 @@
 #ifndef TRANSFER_CALLBACK_HPP
 #define TRANSFER_CALLBACK_HPP
 
-#include <ftp/transfer_callback.hpp>
-#include <chrono>
+#include <ftp/progress_reporter.hpp>
 
-class transfer_callback : public ftp::transfer_callback
+class transfer_callback : public ftp::progress_reporter
 {
 public:
-    transfer_callback();
+    transfer_callback() = default;
 
     void begin() override;
 
-    void notify(std::size_t bytes_transferred) override;
-
     void end() override;
 
-private:
-    std::size_t line_len_;
-    std::chrono::steady_clock::time_point time_;
+protected:
+    void on_progress(const ftp::progress & progress) override;
 };
 
 #endif //TRANSFER_CALLBACK_HPP
@@ -23,15 +23,13 @@
  */
 
 #include <iostream>
-#include <fstream>
 #include <exception>
 #include <memory>
+#include <ftp/async_logger.hpp>
 #include <ftp/client.hpp>
+#include <ftp/stream/file_output_stream.hpp>
 #include "reply_handlers.hpp"
 
-namespace
-{
-
 /*
  * Save logs in the following format:
  *   -- Connected to localhost on port 2121.
@@ -43,59 +41,19 @@ namespace
  *   ...
  *   -> QUIT
  *   <- 221 Goodbye.
+ *
+ * The log is written on a separate thread, so it does not slow down the session.
  */
-class logger : public ftp::observer
-{
-public:
-    explicit logger(const std::string & filename)
-    {
-        log_file_.open(filename, std::ofstream::out | std::ofstream::trunc);
-        if (!log_file_)
-        {
-            throw std::runtime_error("Cannot create a log file.");
-        }
-    }
-
-private:
-    void on_connected(std::string_view hostname, std::uint16_t port) override
-    {
-        log_file_ << "-- Connected to " << hostname << " on port " << port << "." << std::endl;
-    }
-
-    void on_request(std::string_view command) override
-    {
-        log_file_ << "-> ";
-
-        /* Do not log user's password. */
-        if (command.compare(0, 4, "PASS") == 0)
-        {
-            log_file_ << "PASS *****";
-        }
-        else
-        {
-            log_file_ << command;
-        }
-
-        log_file_ << std::endl;
-    }
-
-    void on_reply(const ftp::reply & reply) override
-    {
-        log_file_ << "<- " << reply.get_status_string() << std::endl;
-    }
-
-    std::ofstream log_file_;
-};
-
-} // namespace
-
 int main(int argc, char *argv[])
 {
     try
     {
+        ftp::file_output_stream log_file("ftp.log");
+        auto logger = std::make_shared<ftp::async_logger>(log_file);
+
         ftp::client client;
 
-        client.add_observer(std::make_shared<logger>("ftp.log"));
+        client.add_observer(logger);
 
         handle_reply(client.connect("localhost", 2121, "user", "password"));
 
@@ -103,6 +61,8 @@ int main(int argc, char *argv[])
 
         handle_reply(client.disconnect());
 
+        logger->flush();
+
         return EXIT_SUCCESS;
     }
     catch (const std::exception & ex)
@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_ASYNC_LOGGER_HPP
+#define LIBFTP_ASYNC_LOGGER_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/observer.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <ftp/detail/log_ring.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ftp
+{
+
+/* An observer that logs the connections, the requests and the replies on a separate thread.
+ * The events are passed to the writer thread through a lock-free ring, so logging does
+ * not wait for the destination stream. If the ring is full, the event is dropped.
+ * The passwords of the PASS command are masked.
+ *
+ * The text format is the following:
+ *   -- Connected to localhost on port 2121.
+ *   -> USER user
+ *   <- 331 Username ok, send password.
+ *
+ * The binary format is a sequence of records, the integers are little-endian:
+ *   8 bytes  nanoseconds since the epoch of the system clock
+ *   1 byte   the event type (see event_type)
+ *   2 bytes  the size of the data
+ *   the data, as in the text format without the prefix
+ *
+ * An error of the destination stream is thrown by the next flush(), the following
+ * events are dropped. The events logged before the destruction are written.
+ */
+class FTP_EXPORT async_logger : public observer
+{
+public:
+    enum class format
+    {
+        text,
+        binary
+    };
+
+    enum class event_type : std::uint8_t
+    {
+        connected = 0,
+        request = 1,
+        reply = 2
+    };
+
+    static constexpr std::size_t default_capacity = 1024;
+
+    static constexpr std::chrono::milliseconds default_flush_interval = std::chrono::milliseconds(100);
+
+    /* The longer events are truncated. */
+    static constexpr std::size_t max_event_size = detail::log_ring::max_data_size;
+
+    /* The writer thread writes the events and flushes the destination once per flush interval. */
+    explicit async_logger(output_stream & dst,
+                          format log_format = format::text,
+                          std::size_t capacity = default_capacity,
+                          std::chrono::milliseconds flush_interval = default_flush_interval);
+
+    async_logger(const async_logger &) = delete;
+
+    async_logger & operator=(const async_logger &) = delete;
+
+    ~async_logger() override;
+
+    void on_connected(std::string_view hostname, std::uint16_t port) override;
+
+    void on_request(std::string_view command) override;
+
+    void on_reply(const reply & reply) override;
+
+    /* Waits until the events logged so far are written and flushes the destination. */
+    void flush();
+
+    [[nodiscard]] format get_format() const;
+
+    /* The number of the events dropped because the ring was full or the destination failed. */
+    [[nodiscard]] std::uint64_t get_dropped_count() const;
+
+    /* The number of the events longer than max_event_size. */
+    [[nodiscard]] std::uint64_t get_truncated_count() const;
+
+private:
+    void log(event_type type, std::string_view data);
+
+    void run();
+
+    /* Writes the events in the ring and flushes the destination. */
+    void write_events();
+
+    void format_event(const detail::log_ring::record & record);
+
+    const format format_;
+    const std::chrono::milliseconds flush_interval_;
+    output_stream & dst_;
+    detail::log_ring ring_;
+    std::atomic<std::uint64_t> dropped_count_;
+    std::atomic<std::uint64_t> truncated_count_;
+    /* Used by the writer thread only. */
+    std::string buffer_;
+    std::mutex mutex_;
+    std::condition_variable writer_cv_;
+    std::condition_variable flushed_cv_;
+    /* The number of the events flush() waits for. */
+    std::uint64_t flush_target_;
+    /* The number of the events taken from the ring and flushed. */
+    std::uint64_t flushed_count_;
+    bool stopping_;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_ASYNC_LOGGER_HPP
@@ -27,25 +27,44 @@
 
 #include <ftp/export.hpp>
 #include <ftp/observer.hpp>
+#include <ftp/features_reply.hpp>
+#include <ftp/file_hash_reply.hpp>
 #include <ftp/file_list_reply.hpp>
 #include <ftp/file_modified_time_reply.hpp>
 #include <ftp/file_size_reply.hpp>
+#include <ftp/hash_algorithm.hpp>
+#include <ftp/rate_limiter.hpp>
 #include <ftp/replies.hpp>
 #include <ftp/reply.hpp>
+#include <ftp/resolver.hpp>
+#include <ftp/retry_policy.hpp>
+#include <ftp/socket_options.hpp>
 #include <ftp/ssl.hpp>
+#include <ftp/timeouts.hpp>
 #include <ftp/transfer_callback.hpp>
 #include <ftp/transfer_mode.hpp>
 #include <ftp/transfer_type.hpp>
+#include <ftp/transmission_mode.hpp>
+#include <ftp/stream/download_stream.hpp>
 #include <ftp/stream/input_stream.hpp>
 #include <ftp/stream/output_stream.hpp>
+#include <ftp/stream/upload_stream.hpp>
+#include <ftp/detail/command_queue.hpp>
 #include <ftp/detail/control_connection.hpp>
 #include <ftp/detail/data_connection.hpp>
+#include <ftp/detail/data_listener.hpp>
 #include <ftp/detail/net_context.hpp>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <string_view>
 #include <optional>
 #include <memory>
+#include <functional>
 #include <list>
+#include <mutex>
+#include <vector>
+#include <utility>
 
 namespace ftp
 {
@@ -89,10 +108,51 @@ public:
 
     replies download_file(output_stream && dst, std::string_view path, transfer_callback * transfer_cb = nullptr);
 
+    /* Restarts the download from the restart marker (REST command), e.g. the
+     * marker returned by get_last_restart_marker(). The data is appended to dst.
+     */
+    replies resume_download(output_stream & dst,
+                            std::string_view path,
+                            std::string_view restart_marker,
+                            transfer_callback * transfer_cb = nullptr);
+
+    replies resume_download(output_stream && dst,
+                            std::string_view path,
+                            std::string_view restart_marker,
+                            transfer_callback * transfer_cb = nullptr);
+
     replies upload_file(input_stream & src, std::string_view path, bool upload_unique = false, transfer_callback * transfer_cb = nullptr);
 
     replies upload_file(input_stream && src, std::string_view path, bool upload_unique = false, transfer_callback * transfer_cb = nullptr);
 
+    /* Restarts the upload at the restart marker (REST command), e.g. a byte offset:
+     * the server writes the data from the marker on, keeping the rest of the file.
+     * Some servers accept only an offset within the size of the file.
+     */
+    replies resume_upload(input_stream & src,
+                          std::string_view path,
+                          std::string_view restart_marker,
+                          transfer_callback * transfer_cb = nullptr);
+
+    replies resume_upload(input_stream && src,
+                          std::string_view path,
+                          std::string_view restart_marker,
+                          transfer_callback * transfer_cb = nullptr);
+
+    /* Starts a download read at the pace of the caller. The stream is not open
+     * if the server refuses the transfer, its replies are returned by close().
+     * Until the stream is closed, the other calls on the client throw ftp_exception
+     * (except abort_transfer(), add_observer() and remove_observer()). An aborted
+     * stream reads the end of the file and close() returns the replies of ABOR.
+     * Throws ftp_exception in the block transmission mode.
+     */
+    download_stream_ptr open_download(std::string_view path);
+
+    /* Starts an upload written at the pace of the caller, see open_download().
+     * The upload must be finished by close(), its replies tell whether the file is complete.
+     */
+    upload_stream_ptr open_upload(std::string_view path, bool upload_unique = false);
+
     replies append_file(input_stream & src, std::string_view path, transfer_callback * transfer_cb = nullptr);
 
     replies append_file(input_stream && src, std::string_view path, transfer_callback * transfer_cb = nullptr);
@@ -111,12 +171,28 @@ public:
 
     file_modified_time_reply get_file_modified_time(std::string_view path);
 
+    /* Returns the hash of a remote file computed by the server. Uses the HASH
+     * command and falls back to the XCRC, XMD5, XSHA1, XSHA256 and XSHA512 commands
+     * if the server does not support it.
+     */
+    file_hash_reply get_file_hash(std::string_view path, hash_algorithm algorithm);
+
+    /* Compares the hash of a remote file with the hash of the last transfer.
+     * Throws ftp_exception if the transfer hash is not available.
+     */
+    bool verify_file(std::string_view path);
+
+    bool verify_file(std::string_view path, hash_algorithm algorithm, std::string_view expected_hash);
+
     reply get_status(const std::optional<std::string_view> & path = std::nullopt);
 
     reply get_system_type();
 
     reply get_help(const std::optional<std::string_view> & command = std::nullopt);
 
+    /* Returns the extensions supported by the server (RFC 2389). */
+    features_reply get_features();
+
     reply get_site_commands();
 
     reply send_site_command(std::string_view command);
@@ -125,6 +201,20 @@ public:
 
     std::optional<reply> disconnect(bool graceful = true);
 
+    /* Aborts the running download or upload from another thread. The data connection
+     * is shut down at once and the transfer returns the replies of the ABOR command.
+     * If the transfer is starting, it is aborted as soon as the data connection is open.
+     */
+    void abort_transfer();
+
+    /* Sends ABOR preceded by the Telnet IP and Synch sequence as TCP urgent data (RFC 959),
+     * so that the server handles it ahead of the pending data. Off by default, since many
+     * servers do not handle it. Not used on an SSL/TLS control connection.
+     */
+    void set_urgent_abort(bool urgent_abort);
+
+    [[nodiscard]] bool get_urgent_abort() const;
+
     void set_transfer_mode(transfer_mode mode);
 
     [[nodiscard]] transfer_mode get_transfer_mode() const;
@@ -133,6 +223,26 @@ public:
 
     [[nodiscard]] transfer_type get_transfer_type() const;
 
+    /* Sets the transmission mode of the data connection (MODE command).
+     * MODE Z compresses the transferred data with deflate. The server advertises
+     * it as the "MODE Z" feature, see get_features().
+     * MODE B keeps the data connection open across transfers and lets the server
+     * send restart markers, see get_last_restart_marker().
+     * Throws ftp_exception if MODE Z is requested and the library is built without zlib.
+     */
+    reply set_transmission_mode(transmission_mode mode);
+
+    [[nodiscard]] transmission_mode get_transmission_mode() const;
+
+    /* Returns the last restart marker received during the last download in block mode.
+     * The data preceding the marker has been written to the output stream.
+     */
+    [[nodiscard]] std::optional<std::string> get_last_restart_marker() const;
+
+    /* Observers may be added and removed from any thread, also while a command is
+     * running, e.g. from the observer itself. A command already running keeps
+     * notifying the observers it started with.
+     */
     void add_observer(std::shared_ptr<observer> observer);
 
     void remove_observer(std::shared_ptr<observer> observer);
@@ -141,7 +251,117 @@ public:
 
     [[nodiscard]] bool get_rfc2428_support() const;
 
+    /* Sets the range of local ports to listen on in the active transfer mode,
+     * both bounds are inclusive. 0, 0 (the default) means an ephemeral port.
+     * The listening socket is kept open across transfers.
+     */
+    void set_active_port_range(std::uint16_t first_port, std::uint16_t last_port);
+
+    [[nodiscard]] std::pair<std::uint16_t, std::uint16_t> get_active_port_range() const;
+
+    /* Sets the backlog of the listening socket in the active transfer mode. */
+    void set_active_listen_backlog(int backlog);
+
+    [[nodiscard]] int get_active_listen_backlog() const;
+
+    /* Enables computing the hash of the transferred data during downloads and uploads,
+     * so that it can be compared with the hash of the remote file. In MODE Z the hash
+     * covers the uncompressed data. The hash is not computed for the transfers that
+     * do not cover the whole file as stored (resumed ones and the ASCII transfer type).
+     */
+    void set_transfer_hash_algorithm(const std::optional<hash_algorithm> & algorithm);
+
+    [[nodiscard]] std::optional<hash_algorithm> get_transfer_hash_algorithm() const;
+
+    /* Returns the hash of the last successfully completed download or upload,
+     * if the transfer hash algorithm was set and the transfer is hashed.
+     */
+    [[nodiscard]] std::optional<std::string> get_last_transfer_hash() const;
+
+    /* Sets the resolver used to resolve hostnames on connect.
+     * If not set (or nullptr), the default resolver is used. See get_default_resolver().
+     */
+    void set_resolver(resolver_ptr resolver);
+
+    [[nodiscard]] resolver_ptr get_resolver() const;
+
+    /* Limits the bandwidth of downloads, uploads and file lists.
+     * Share a limiter (or its parent) between clients to limit them together,
+     * set a new limiter with this one as the parent to limit a single transfer.
+     * nullptr removes the limit.
+     */
+    void set_rate_limiter(rate_limiter_ptr rate_limiter);
+
+    [[nodiscard]] rate_limiter_ptr get_rate_limiter() const;
+
+    /* Sets the size of the chunks the data is transferred in, 8 KiB by default.
+     * Larger chunks take fewer system calls per transferred byte.
+     * In block mode a chunk is limited to the maximum block size (65535 bytes).
+     */
+    void set_transfer_buffer_size(std::size_t size);
+
+    [[nodiscard]] std::size_t get_transfer_buffer_size() const;
+
+    /* Sets the timeouts of the connections, the reply and the transfer.
+     * A timed out operation throws ftp_exception with the error code
+     * error::connect_timeout, error::reply_timeout or error::transfer_timeout.
+     */
+    void set_timeouts(const timeouts & timeouts);
+
+    [[nodiscard]] timeouts get_timeouts() const;
+
+    /* Sets the point in time all the operations must be completed by, for example
+     * a whole session of transfers. An operation still running at the deadline throws
+     * ftp_exception with the error code error::deadline_exceeded. std::nullopt removes it.
+     */
+    void set_deadline(const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> get_deadline() const;
+
+    /* Sets the policy of retrying the failed downloads, nullptr (the default) disables retries.
+     * If the control connection is lost, the client reconnects, logs in with the credentials
+     * of the last login, and restores the working directory and the transmission mode.
+     * In the binary transfer type the download is resumed (REST command) after the data
+     * already written to the output stream. In the ASCII transfer type only the downloads
+     * that have not written any data are retried.
+     */
+    void set_retry_policy(retry_policy_ptr retry_policy);
+
+    [[nodiscard]] retry_policy_ptr get_retry_policy() const;
+
+    /* Sets the options of the control connection socket, applied on the next connect.
+     * If the control connection is bound to a local address or device, the data
+     * connections are opened from the same one, unless their options set another.
+     */
+    void set_control_socket_options(const socket_options & options);
+
+    [[nodiscard]] socket_options get_control_socket_options() const;
+
+    /* Sets the options of the data connection sockets, applied to each new data connection. */
+    void set_data_socket_options(const socket_options & options);
+
+    [[nodiscard]] socket_options get_data_socket_options() const;
+
+    /* Enables sharing the client between threads. The operations called from several
+     * threads are run one at a time, in the order they are called, each waiting for
+     * the earlier ones to complete. abort_transfer(), add_observer() and remove_observer()
+     * never wait. Off by default. Must be set before the client is shared.
+     */
+    void set_thread_safe(bool thread_safe);
+
+    [[nodiscard]] bool is_thread_safe() const;
+
 private:
+    friend class session;
+    friend class download_stream;
+    friend class upload_stream;
+
+    /* Runs the connections on a shared net context, see session_manager. */
+    client(detail::net_context_ptr net_context, ssl::context_ptr && ssl_context);
+
+    /* Waits for the turn of the calling thread if the client is thread-safe. */
+    [[nodiscard]] std::unique_lock<detail::command_queue> lock_commands() const;
+
     void send(std::string_view command);
 
     reply recv();
@@ -154,18 +374,56 @@ private:
 
     reply process_login(std::string_view username, std::string_view password, replies & replies);
 
-    replies process_download(output_stream & dst, std::string_view path, transfer_callback * transfer_cb);
+    replies process_download(output_stream & dst,
+                             std::string_view path,
+                             const std::optional<std::string_view> & restart_marker,
+                             transfer_callback * transfer_cb);
+
+    replies process_download_attempt(output_stream & dst,
+                                     std::string_view path,
+                                     const std::optional<std::string_view> & restart_marker,
+                                     transfer_callback * transfer_cb);
 
-    replies process_upload(std::string_view command, input_stream & src, std::string_view path, transfer_callback * transfer_cb);
+    /* Opens a new session to the last connected server in the state of the current one. */
+    void reconnect();
 
-    reply process_abort(replies & replies);
+    replies process_upload(std::string_view command,
+                           input_stream & src,
+                           std::string_view path,
+                           const std::optional<std::string_view> & restart_marker,
+                           transfer_callback * transfer_cb);
 
+    reply process_abort(replies & replies, bool data_connection_closed = false);
+
+    /* Runs the transfer, so that abort_transfer() can interrupt it.
+     * Returns true if the transfer is aborted.
+     */
+    bool run_transfer(detail::data_connection & connection, const std::function<void()> & transfer);
+
+    /* Exposes the data connection to abort_transfer(), nullptr withdraws it.
+     * The connection is interrupted at once if the abort is requested already.
+     */
+    void set_active_connection(detail::data_connection * connection);
+
+    void reset_abort();
+
+    [[nodiscard]] bool is_abort_requested();
+
+    /* Returns nullptr if the data is transferred without conversion. */
     input_stream_ptr create_input_stream(input_stream & src);
 
     output_stream_ptr create_output_stream(output_stream & dst);
 
     detail::data_connection_ptr create_data_connection(std::string_view command, replies & replies);
 
+    void finish_data_connection(detail::data_connection_ptr connection, replies & replies);
+
+    void reset_data_connection();
+
+    detail::hasher_ptr create_transfer_hasher(const std::optional<std::string_view> & restart_marker);
+
+    void finish_transfer_hash(detail::hasher * hasher, const replies & replies);
+
     void ssl_handshake_data_connection(detail::data_connection & connection, ssl::context & ssl_context);
 
     detail::data_connection_ptr process_epsv_command(std::string_view command, replies & replies);
@@ -188,6 +446,14 @@ private:
 
     static std::string make_type_command(transfer_type type);
 
+    static std::string make_mode_command(transmission_mode mode);
+
+    [[nodiscard]] socket_options make_data_socket_options() const;
+
+    using observer_list = std::list<std::shared_ptr<observer>>;
+
+    [[nodiscard]] std::shared_ptr<const observer_list> get_observers() const;
+
     void notify_connected(std::string_view hostname, std::uint16_t port);
 
     void notify_request(std::string_view command);
@@ -200,9 +466,45 @@ private:
     transfer_type transfer_type_;
     ssl::context_ptr ssl_context_;
     bool rfc2428_support_;
-    detail::net_context net_context_;
+    resolver_ptr resolver_;
+    rate_limiter_ptr rate_limiter_;
+    retry_policy_ptr retry_policy_;
+    std::size_t transfer_buffer_size_;
+    timeouts timeouts_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
+    socket_options control_socket_options_;
+    socket_options data_socket_options_;
+    std::optional<hash_algorithm> transfer_hash_algorithm_;
+    std::optional<hash_algorithm> last_transfer_hash_algorithm_;
+    std::optional<std::string> last_transfer_hash_;
+    std::optional<hash_algorithm> selected_hash_algorithm_;
+    bool hash_command_supported_;
+    transmission_mode transmission_mode_;
+    std::optional<std::string> last_restart_marker_;
+    /* The session state restored by reconnect(). */
+    std::string hostname_;
+    std::uint16_t port_;
+    std::optional<std::string> username_;
+    std::string password_;
+    /* The CWD and CDUP commands since the login, a CWD to an absolute path clears them. */
+    std::vector<std::string> directory_commands_;
+    bool urgent_abort_;
+    /* Guards the running transfer against abort_transfer() called from another thread. */
+    std::mutex transfer_mutex_;
+    detail::data_connection * active_connection_;
+    bool abort_requested_;
+    std::atomic<bool> thread_safe_;
+    /* Set by an open download_stream or upload_stream, which owns the command lock. */
+    bool stream_open_;
+    mutable detail::command_queue command_queue_;
+    detail::net_context_ptr net_context_;
     detail::control_connection control_connection_;
-    std::list<std::shared_ptr<observer>> observers_;
+    detail::data_listener data_listener_;
+    /* The data connection kept open in block mode. */
+    detail::data_connection_ptr data_connection_;
+    /* Copied on write, so that the notifications run without the lock. */
+    mutable std::mutex observers_mutex_;
+    std::shared_ptr<const observer_list> observers_;
 };
 
 } // namespace ftp
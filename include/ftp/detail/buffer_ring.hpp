@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_BUFFER_RING_HPP
+#define LIBFTP_BUFFER_RING_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace ftp::detail
+{
+
+/* A fixed set of buffers passed between a producer and a consumer thread.
+ * The producer takes free buffers, fills them and passes them to the consumer,
+ * which returns them once the data is processed.
+ */
+class FTP_EXPORT_INTERNAL buffer_ring
+{
+public:
+    struct buffer
+    {
+        std::vector<char> data;
+        std::size_t size = 0;
+    };
+
+    buffer_ring(std::size_t buffer_size, std::size_t buffer_count);
+
+    buffer_ring(const buffer_ring &) = delete;
+
+    buffer_ring & operator=(const buffer_ring &) = delete;
+
+    [[nodiscard]] std::size_t get_buffer_size() const;
+
+    /* Blocks until a buffer is free. Returns nullptr if the ring is closed. */
+    buffer * get_free();
+
+    void put_free(buffer *buffer);
+
+    /* Blocks until a buffer is filled. Returns nullptr if the ring is closed,
+     * or if the producer has finished and all the filled buffers are taken.
+     */
+    buffer * get_filled();
+
+    void put_filled(buffer *buffer);
+
+    /* The producer has no more data. */
+    void finish();
+
+    /* Wakes up both sides, the buffers are not passed anymore. */
+    void close();
+
+    /* Blocks until the consumer has returned all the filled buffers. */
+    void wait_consumed();
+
+private:
+    std::vector<buffer> buffers_;
+    std::mutex mutex_;
+    std::condition_variable free_cv_;
+    std::condition_variable filled_cv_;
+    std::deque<buffer *> free_;
+    std::deque<buffer *> filled_;
+    bool finished_;
+    bool closed_;
+};
+
+} // namespace ftp::detail
+#endif //LIBFTP_BUFFER_RING_HPP
@@ -0,0 +1,66 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_COMMAND_QUEUE_HPP
+#define LIBFTP_COMMAND_QUEUE_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace ftp::detail
+{
+
+/* Runs the commands submitted by several threads one at a time, in the order
+ * of submission. A thread running a command may submit nested commands.
+ * Meets the Lockable requirements, so it is used with std::unique_lock.
+ */
+class FTP_EXPORT_INTERNAL command_queue
+{
+public:
+    command_queue();
+
+    command_queue(const command_queue &) = delete;
+
+    command_queue & operator=(const command_queue &) = delete;
+
+    /* Waits until the commands submitted earlier are completed. */
+    void lock();
+
+    void unlock();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::uint64_t next_ticket_;
+    std::uint64_t running_ticket_;
+    std::thread::id owner_;
+    std::size_t depth_;
+};
+
+} // namespace ftp::detail
+#endif //LIBFTP_COMMAND_QUEUE_HPP
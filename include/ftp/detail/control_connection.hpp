@@ -26,10 +26,15 @@
 #define LIBFTP_CONTROL_CONNECTION_HPP
 
 #include <ftp/reply.hpp>
+#include <ftp/resolver.hpp>
+#include <ftp/socket_options.hpp>
+#include <ftp/timeouts.hpp>
 #include <ftp/detail/net_context.hpp>
 #include <ftp/detail/socket_base.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/context.hpp>
+#include <chrono>
+#include <optional>
 
 namespace ftp::detail
 {
@@ -43,10 +48,16 @@ public:
 
     control_connection & operator=(const control_connection &) = delete;
 
-    void connect(std::string_view hostname, std::uint16_t port);
+    void connect(std::string_view hostname,
+                 std::uint16_t port,
+                 resolver & resolver,
+                 const socket_options & options = socket_options());
 
     [[nodiscard]] bool is_connected() const;
 
+    void set_timeouts(const timeouts & timeouts,
+                      const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
     void set_ssl(boost::asio::ssl::context *ssl_context);
 
     [[nodiscard]] bool is_ssl() const;
@@ -59,6 +70,9 @@ public:
 
     void send(std::string_view command);
 
+    /* Sends the data as TCP urgent data. Not available over TLS. */
+    void send_urgent(std::string_view data);
+
     reply recv();
 
     void disconnect();
@@ -72,8 +86,15 @@ private:
 
     static bool is_last_line(std::string_view line, std::uint16_t status_code);
 
+    void set_reply_deadline();
+
+    void translate_reply_timeout(boost::system::error_code & ec) const;
+
+    boost::asio::io_context & io_context_;
     std::string buffer_;
     socket_base_ptr socket_;
+    timeouts timeouts_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
 };
 
 } // namespace ftp::detail
@@ -1,7 +1,7 @@
 /*
  * MIT License
  *
- * Copyright (c) 2023 Denis Kovalchuk
+ * Copyright (c) 2024 Denis Kovalchuk
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -22,27 +22,37 @@
  * SOFTWARE.
  */
 
-#ifndef LIBFTP_BINARY_OSTREAM_HPP
-#define LIBFTP_BINARY_OSTREAM_HPP
+
+#ifndef LIBFTP_COUNTING_OSTREAM_HPP
+#define LIBFTP_COUNTING_OSTREAM_HPP
 
 #include <ftp/detail/export_internal.hpp>
 #include <ftp/stream/output_stream.hpp>
+#include <cstdint>
 
 namespace ftp::detail
 {
 
-class FTP_EXPORT_INTERNAL binary_ostream : public output_stream
+/* Passes the data to the destination stream and counts its bytes. */
+class FTP_EXPORT_INTERNAL counting_ostream : public output_stream
 {
 public:
-    explicit binary_ostream(output_stream & dst);
+    explicit counting_ostream(output_stream & dst);
 
     void write(char *buf, std::size_t size) override;
 
     void flush() override;
 
+    char * prepare(std::size_t & size) override;
+
+    void commit(std::size_t size) override;
+
+    [[nodiscard]] std::uint64_t get_size() const;
+
 private:
     output_stream & dst_;
+    std::uint64_t size_;
 };
 
 } // namespace ftp::detail
-#endif //LIBFTP_BINARY_OSTREAM_HPP
+#endif //LIBFTP_COUNTING_OSTREAM_HPP
@@ -25,14 +25,23 @@
 #ifndef LIBFTP_DATA_CONNECTION_HPP
 #define LIBFTP_DATA_CONNECTION_HPP
 
+#include <ftp/rate_limiter.hpp>
+#include <ftp/socket_options.hpp>
+#include <ftp/timeouts.hpp>
 #include <ftp/stream/input_stream.hpp>
 #include <ftp/stream/output_stream.hpp>
 #include <ftp/transfer_callback.hpp>
+#include <ftp/transmission_mode.hpp>
+#include <ftp/detail/hasher.hpp>
 #include <ftp/detail/net_context.hpp>
 #include <ftp/detail/socket_base.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl/context.hpp>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 
 namespace ftp::detail
@@ -47,29 +56,130 @@ public:
 
     data_connection & operator=(const data_connection &) = delete;
 
+    /* Set before connecting or accepting. */
+    void set_socket_options(const socket_options & options);
+
+    void set_timeouts(const timeouts & timeouts,
+                      const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
     void connect(std::string_view ip, std::uint16_t port);
 
     void connect(const boost::asio::ip::tcp::endpoint & endpoint);
 
-    void listen(const boost::asio::ip::tcp::endpoint & endpoint);
-
-    void accept();
+    /* Connections from other hosts than the peer_address are closed, and the next one is accepted. */
+    void accept(boost::asio::ip::tcp::acceptor & acceptor,
+                const boost::asio::ip::address & peer_address,
+                boost::system::error_code & ec);
 
     void set_ssl(boost::asio::ssl::context *ssl_context, SSL_SESSION *ssl_session = nullptr);
 
     void ssl_handshake();
 
-    void send(input_stream & stream, transfer_callback * transfer_cb);
+    void set_transmission_mode(transmission_mode mode);
+
+    /* The bytes sent and received over the data connection, including
+     * the block headers and the compressed data, are taken from the rate_limiter.
+     */
+    void set_rate_limiter(rate_limiter_ptr rate_limiter);
+
+    /* The size of the chunks read from the socket and the stream, one system call each. */
+    void set_buffer_size(std::size_t size);
+
+    static constexpr std::size_t default_buffer_size = 8192;
+
+    void send(input_stream & stream, transfer_callback * transfer_cb, hasher * hasher = nullptr);
 
-    void recv(output_stream & stream, transfer_callback * transfer_cb);
+    /* In block mode the last restart marker sent by the server is stored in the restart_marker. */
+    void recv(output_stream & stream,
+              transfer_callback * transfer_cb,
+              hasher * hasher = nullptr,
+              std::optional<std::string> * restart_marker = nullptr);
+
+    /* Receives the next chunk of the data as is, for a transfer read at the pace of the caller.
+     * Returns 0 at the end of the data.
+     */
+    std::size_t read_some(char *data, std::size_t size);
+
+    /* Sends the data as is, for a transfer written at the pace of the caller. */
+    void write_some(const char *data, std::size_t size);
 
     void disconnect(bool graceful = true);
 
-    [[nodiscard]] boost::asio::ip::tcp::endpoint get_listen_endpoint() const;
+    /* Shuts the socket down from another thread, so that the running
+     * transfer stops at once. Thread-safe, as long as the connection
+     * is not closed or destroyed meanwhile.
+     */
+    void interrupt();
+
+    /* Closes the socket without the TLS and TCP shutdown. */
+    void close();
 
 private:
+    /* The transfer loops are instantiated for each final socket class,
+     * so that the socket calls are not virtual.
+     */
+    template<typename SocketType>
+    void send_data(SocketType & socket, input_stream & stream, transfer_callback * transfer_cb, hasher * hasher);
+
+    template<typename SocketType>
+    void recv_data(SocketType & socket,
+                   output_stream & stream,
+                   transfer_callback * transfer_cb,
+                   hasher * hasher,
+                   std::optional<std::string> * restart_marker);
+
+    template<typename SocketType>
+    void recv_stream(SocketType & socket, output_stream & stream, transfer_callback * transfer_cb, hasher * hasher);
+
+    template<typename SocketType>
+    void recv_blocks(SocketType & socket,
+                     output_stream & stream,
+                     transfer_callback * transfer_cb,
+                     hasher * hasher,
+                     std::optional<std::string> * restart_marker);
+
+    /* The transfer timeout limits each socket operation, so that only a stalled transfer fails. */
+    void set_transfer_deadline(socket_base & socket) const;
+
+    void translate_timeout(boost::system::error_code & ec, error timeout_error) const;
+
+    /* Waits for the rate_limiter, if any, until the client deadline or an abort. */
+    void throttle(std::size_t size);
+
+    void accept_any(boost::asio::ip::tcp::acceptor & acceptor,
+                    const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                    boost::system::error_code & ec);
+
+    static void make_block_header(char *header, unsigned char descriptor, std::size_t size);
+
+    template<typename SocketType>
+    void read(SocketType & socket, char *data, std::size_t size);
+
+    template<typename SocketType>
+    void write(SocketType & socket, const char *data, std::size_t size);
+
+    /* Writes the block header and the data by a single gather write. */
+    template<typename SocketType>
+    void write(SocketType & socket, const char *header, const char *data, std::size_t size);
+
+    /* MODE B block header: a descriptor and a 16-bit byte count. */
+    static constexpr std::size_t block_header_size = 3;
+
+    static constexpr std::size_t max_block_size = 65535;
+
+    /* MODE B block descriptors. */
+    static constexpr unsigned char block_eof = 64;
+    static constexpr unsigned char block_restart_marker = 16;
+
+    boost::asio::io_context & io_context_;
     socket_base_ptr socket_;
-    boost::asio::ip::tcp::acceptor acceptor_;
+    transmission_mode transmission_mode_;
+    rate_limiter_ptr rate_limiter_;
+    socket_options socket_options_;
+    std::size_t buffer_size_;
+    timeouts timeouts_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
+    std::atomic<bool> interrupted_;
 };
 
 using data_connection_ptr = std::unique_ptr<data_connection>;
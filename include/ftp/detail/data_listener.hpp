@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_DATA_LISTENER_HPP
+#define LIBFTP_DATA_LISTENER_HPP
+
+#include <ftp/socket_options.hpp>
+#include <ftp/detail/data_connection.hpp>
+#include <ftp/detail/export_internal.hpp>
+#include <ftp/detail/net_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace ftp::detail
+{
+
+/* Listens for data connections in the active transfer mode.
+ * The acceptor is kept open across transfers, it is reopened only
+ * when the local address of the control connection changes.
+ */
+class FTP_EXPORT_INTERNAL data_listener
+{
+public:
+    explicit data_listener(net_context & net_context);
+
+    data_listener(const data_listener &) = delete;
+
+    data_listener & operator=(const data_listener &) = delete;
+
+    /* Both bounds are inclusive. 0, 0 means an ephemeral port. */
+    void set_port_range(std::uint16_t first_port, std::uint16_t last_port);
+
+    [[nodiscard]] std::pair<std::uint16_t, std::uint16_t> get_port_range() const;
+
+    void set_backlog(int backlog);
+
+    [[nodiscard]] int get_backlog() const;
+
+    /* The buffer sizes are set on the acceptor, so that the accepted
+     * sockets inherit them before the TCP handshake.
+     */
+    void set_socket_options(const socket_options & options);
+
+    /* Returns the endpoint to be sent in the PORT/EPRT command. */
+    boost::asio::ip::tcp::endpoint listen(const boost::asio::ip::address & address);
+
+    /* Accepts the next connection from the peer_address, the address of the server. */
+    void accept(data_connection & connection, const boost::asio::ip::address & peer_address);
+
+    /* Closes the connections waiting in the backlog, so that a connection
+     * made for a previous command is not taken by the next transfer.
+     */
+    void drop_pending_connections();
+
+    [[nodiscard]] bool is_open() const;
+
+    void close();
+
+private:
+    void open(const boost::asio::ip::address & address);
+
+    bool try_bind(const boost::asio::ip::tcp::endpoint & endpoint, boost::system::error_code & ec);
+
+    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::ip::tcp::endpoint endpoint_;
+    std::uint16_t first_port_;
+    std::uint16_t last_port_;
+    int backlog_;
+    std::optional<int> send_buffer_size_;
+    std::optional<int> receive_buffer_size_;
+};
+
+} // namespace ftp::detail
+#endif //LIBFTP_DATA_LISTENER_HPP
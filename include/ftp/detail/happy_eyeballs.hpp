@@ -0,0 +1,69 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_HAPPY_EYEBALLS_HPP
+#define LIBFTP_HAPPY_EYEBALLS_HPP
+
+#include <ftp/socket_options.hpp>
+#include <ftp/detail/export_internal.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+/* Happy Eyeballs Version 2: Better Connectivity Using Concurrency.
+ *
+ * RFC 8305: https://tools.ietf.org/html/rfc8305
+ */
+namespace ftp::detail::happy_eyeballs
+{
+
+/* The recommended value for the Connection Attempt Delay. */
+inline constexpr std::chrono::milliseconds default_attempt_delay(250);
+
+/* Interleaves the endpoints by address family, starting with the family
+ * of the first endpoint. The relative order within a family is preserved.
+ */
+FTP_EXPORT_INTERNAL
+std::vector<boost::asio::ip::tcp::endpoint> sort_endpoints(const std::vector<boost::asio::ip::tcp::endpoint> & endpoints);
+
+/* Starts a connection attempt to the next endpoint each time the previous
+ * attempt fails or the attempt delay expires, and returns the socket of the
+ * first attempt that succeeds. The remaining attempts are cancelled.
+ * The options are set on each socket, and it is bound to the local address
+ * of the options, before connecting.
+ * If no attempt succeeds by the deadline, all of them are cancelled
+ * and the connection fails with boost::asio::error::timed_out.
+ */
+FTP_EXPORT_INTERNAL
+boost::asio::ip::tcp::socket connect(boost::asio::io_context & io_context,
+                                     const std::vector<boost::asio::ip::tcp::endpoint> & endpoints,
+                                     std::chrono::milliseconds attempt_delay,
+                                     boost::system::error_code & ec,
+                                     const socket_options & options = socket_options(),
+                                     const std::optional<std::chrono::steady_clock::time_point> & deadline = std::nullopt);
+
+} // namespace ftp::detail::happy_eyeballs
+#endif //LIBFTP_HAPPY_EYEBALLS_HPP
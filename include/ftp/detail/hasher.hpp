@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_HASHER_HPP
+#define LIBFTP_HASHER_HPP
+
+#include <ftp/hash_algorithm.hpp>
+#include <ftp/detail/export_internal.hpp>
+#include <boost/crc.hpp>
+#include <openssl/evp.h>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ftp::detail
+{
+
+class FTP_EXPORT_INTERNAL hasher
+{
+public:
+    explicit hasher(hash_algorithm algorithm);
+
+    hasher(const hasher &) = delete;
+
+    hasher & operator=(const hasher &) = delete;
+
+    ~hasher();
+
+    void update(const char *buf, std::size_t size);
+
+    /* Return the hash as a lowercase hexadecimal string. */
+    std::string finish();
+
+    /* The algorithm name used by the HASH command. */
+    static std::string_view get_name(hash_algorithm algorithm);
+
+    /* The command that returns the hash of a file, if the HASH command is not supported. */
+    static std::string_view get_legacy_command(hash_algorithm algorithm);
+
+    /* The length of the hash as a hexadecimal string. */
+    static std::size_t get_hex_length(hash_algorithm algorithm);
+
+private:
+    hash_algorithm algorithm_;
+    boost::crc_32_type crc32_;
+    EVP_MD_CTX *md_ctx_;
+};
+
+using hasher_ptr = std::unique_ptr<hasher>;
+
+} // namespace ftp::detail
+#endif //LIBFTP_HASHER_HPP
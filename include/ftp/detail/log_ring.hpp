@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_LOG_RING_HPP
+#define LIBFTP_LOG_RING_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace ftp::detail
+{
+
+/* A bounded lock-free queue of log records with several producers and a single
+ * consumer (D. Vyukov's bounded queue). The records are stored in place, so that
+ * pushing a record does not allocate memory.
+ */
+class FTP_EXPORT_INTERNAL log_ring
+{
+public:
+    /* The longer data is truncated. */
+    static constexpr std::size_t max_data_size = 256;
+
+    struct record
+    {
+        /* Nanoseconds since the epoch of the system clock. */
+        std::int64_t timestamp;
+        std::uint8_t type;
+        std::uint16_t size;
+        char data[max_data_size];
+    };
+
+    /* The capacity is rounded up to a power of two. */
+    explicit log_ring(std::size_t capacity);
+
+    log_ring(const log_ring &) = delete;
+
+    log_ring & operator=(const log_ring &) = delete;
+
+    [[nodiscard]] std::size_t get_capacity() const;
+
+    /* Lock-free, may be called by several threads. Returns false if the ring is full. */
+    bool try_push(std::int64_t timestamp, std::uint8_t type, std::string_view data);
+
+    /* Called by the consumer thread only. Returns false if the ring is empty. */
+    bool try_pop(record & record);
+
+    /* The number of the records pushed, including those not yet visible to the consumer. */
+    [[nodiscard]] std::uint64_t get_push_count() const;
+
+    /* Called by the consumer thread only. */
+    [[nodiscard]] std::uint64_t get_pop_count() const;
+
+private:
+    struct cell
+    {
+        std::atomic<std::uint64_t> sequence;
+        record entry;
+    };
+
+    static constexpr std::size_t cache_line_size = 64;
+
+    std::unique_ptr<cell[]> cells_;
+    const std::size_t mask_;
+    /* The producers and the consumer update their positions on separate cache lines. */
+    alignas(cache_line_size) std::atomic<std::uint64_t> push_position_;
+    alignas(cache_line_size) std::uint64_t pop_position_;
+};
+
+} // namespace ftp::detail
+#endif //LIBFTP_LOG_RING_HPP
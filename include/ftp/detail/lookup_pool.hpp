@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_LOOKUP_POOL_HPP
+#define LIBFTP_LOOKUP_POOL_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ftp::detail
+{
+
+/* Runs blocking hostname lookups on a bounded number of threads, so that
+ * a caller can stop waiting at its deadline. A lookup of the same hostname
+ * and port already in flight is joined instead of being started again.
+ * The threads are started on demand and exit when there is nothing to look up,
+ * a thread blocked in a lookup keeps the pool alive.
+ */
+class FTP_EXPORT_INTERNAL lookup_pool : public std::enable_shared_from_this<lookup_pool>
+{
+public:
+    using result = std::pair<std::vector<boost::asio::ip::tcp::endpoint>, boost::system::error_code>;
+
+    using lookup_function = std::function<result(const std::string & hostname, std::uint16_t port)>;
+
+    static constexpr std::size_t default_max_thread_count = 4;
+
+    static std::shared_ptr<lookup_pool> create(lookup_function lookup,
+                                               std::size_t max_thread_count = default_max_thread_count);
+
+    lookup_pool(const lookup_pool &) = delete;
+
+    lookup_pool & operator=(const lookup_pool &) = delete;
+
+    /* Fails with boost::asio::error::timed_out if the lookup is not completed
+     * by the deadline. The lookup goes on for the other callers.
+     */
+    result lookup(std::string_view hostname,
+                  std::uint16_t port,
+                  std::chrono::steady_clock::time_point deadline);
+
+    [[nodiscard]] std::size_t get_thread_count() const;
+
+private:
+    struct request
+    {
+        std::string key;
+        std::string hostname;
+        std::uint16_t port = 0;
+        /* The callers still waiting, a request nobody waits for is not looked up. */
+        std::size_t waiters = 0;
+        bool done = false;
+        result value;
+    };
+
+    lookup_pool(lookup_function lookup, std::size_t max_thread_count);
+
+    void run();
+
+    lookup_function lookup_;
+    std::size_t max_thread_count_;
+    mutable std::mutex mutex_;
+    std::condition_variable done_cv_;
+    std::deque<std::shared_ptr<request>> queue_;
+    /* The requests queued or being looked up. */
+    std::unordered_map<std::string, std::shared_ptr<request>> requests_;
+    std::size_t thread_count_;
+};
+
+using lookup_pool_ptr = std::shared_ptr<lookup_pool>;
+
+} // namespace ftp::detail
+#endif //LIBFTP_LOOKUP_POOL_HPP
@@ -26,6 +26,7 @@
 #define LIBFTP_NET_CONTEXT_HPP
 
 #include <boost/asio/io_context.hpp>
+#include <memory>
 
 namespace ftp::detail
 {
@@ -33,11 +34,18 @@ namespace ftp::detail
 class net_context
 {
 public:
+    net_context();
+
+    /* The number of threads expected to run the io_context, 1 disables its locking. */
+    explicit net_context(int concurrency_hint);
+
     [[nodiscard]] boost::asio::io_context & get_io_context();
 
 private:
     boost::asio::io_context io_context_;
 };
 
+using net_context_ptr = std::shared_ptr<net_context>;
+
 } // namespace ftp::detail
 #endif //LIBFTP_NET_CONTEXT_HPP
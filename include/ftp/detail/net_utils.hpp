@@ -25,9 +25,16 @@
 #ifndef LIBFTP_NET_UTILS_HPP
 #define LIBFTP_NET_UTILS_HPP
 
+#include <ftp/error.hpp>
+#include <ftp/socket_options.hpp>
 #include <ftp/detail/export_internal.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <optional>
 #include <string>
+#include <utility>
 
 namespace ftp::detail::net_utils
 {
@@ -35,5 +42,87 @@ namespace ftp::detail::net_utils
 FTP_EXPORT_INTERNAL
 std::string address_to_string(const boost::asio::ip::address & address);
 
+/* Compares the addresses, an IPv4-mapped IPv6 address is equal to its IPv4 address. */
+FTP_EXPORT_INTERNAL
+bool is_same_address(const boost::asio::ip::address & first, const boost::asio::ip::address & second);
+
+/* The socket must be open. The local address and device are not bound, see bind_socket(). */
+FTP_EXPORT_INTERNAL
+void set_socket_options(boost::asio::ip::tcp::socket & socket,
+                        const socket_options & options,
+                        boost::system::error_code & ec);
+
+/* Binds the open socket to the local address and device of the options, if any. */
+FTP_EXPORT_INTERNAL
+void bind_socket(boost::asio::ip::tcp::socket & socket,
+                 const boost::asio::ip::tcp & protocol,
+                 const socket_options & options,
+                 boost::system::error_code & ec);
+
+/* The deadline of an operation limited by the timeout, but not later than the client deadline. */
+FTP_EXPORT_INTERNAL
+std::optional<std::chrono::steady_clock::time_point>
+make_deadline(const std::optional<std::chrono::milliseconds> & timeout,
+              const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
+/* Replaces boost::asio::error::timed_out with the timeout error,
+ * or with error::deadline_exceeded if the client deadline has passed.
+ */
+FTP_EXPORT_INTERNAL
+void translate_timeout(boost::system::error_code & ec,
+                       error timeout_error,
+                       const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
+/* Starts the asynchronous operation with a completion handler taking an error code
+ * and a size, and runs the io_context until the operation completes. If the deadline
+ * expires first, the operation is cancelled and fails with boost::asio::error::timed_out,
+ * unless it has completed meanwhile.
+ */
+template<typename Operation, typename Cancel>
+std::size_t run_until(boost::asio::io_context & io_context,
+                      std::chrono::steady_clock::time_point deadline,
+                      Operation && operation,
+                      Cancel && cancel,
+                      boost::system::error_code & ec)
+{
+    std::optional<std::pair<boost::system::error_code, std::size_t>> result;
+
+    operation([&result](const boost::system::error_code & ec, std::size_t size)
+    {
+        result.emplace(ec, size);
+    });
+
+    io_context.restart();
+
+    while (!result && io_context.run_one_until(deadline) > 0)
+    {
+    }
+
+    if (result)
+    {
+        ec = result->first;
+        return result->second;
+    }
+
+    /* Wait for the completion handler of the cancelled operation. */
+    cancel();
+
+    io_context.restart();
+
+    while (!result && io_context.run_one() > 0)
+    {
+    }
+
+    /* The operation may have completed before it was cancelled. */
+    if (result && result->first != boost::asio::error::operation_aborted)
+    {
+        ec = result->first;
+        return result->second;
+    }
+
+    ec = boost::asio::error::timed_out;
+    return result ? result->second : 0;
+}
+
 } // namespace ftp::detail::net_utils
 #endif //LIBFTP_NET_UTILS_HPP
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_SHARD_HPP
+#define LIBFTP_SHARD_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <ftp/detail/net_context.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace ftp::detail
+{
+
+/* A thread, optionally pinned to a CPU, running the tasks of the sessions assigned to it.
+ * The sessions share its net context, which is run only by this thread.
+ */
+class FTP_EXPORT_INTERNAL shard
+{
+public:
+    /* The thread is pinned to the CPU with the given index, if supported. */
+    shard(std::size_t index, const std::optional<std::size_t> & cpu);
+
+    shard(const shard &) = delete;
+
+    shard & operator=(const shard &) = delete;
+
+    /* Runs the queued tasks and joins the thread. */
+    ~shard();
+
+    [[nodiscard]] std::size_t get_index() const;
+
+    [[nodiscard]] net_context_ptr get_net_context() const;
+
+    /* Queues the task. Returns false if the shard is stopped. */
+    bool post(std::function<void()> task);
+
+    /* Runs the queued tasks and joins the thread, the next tasks are rejected. */
+    void stop();
+
+    [[nodiscard]] bool is_stopped();
+
+    [[nodiscard]] bool is_current_thread() const;
+
+    /* Returns true on the thread of any shard. */
+    [[nodiscard]] static bool is_shard_thread();
+
+    void add_session();
+
+    void remove_session();
+
+    [[nodiscard]] std::size_t get_session_count() const;
+
+private:
+    void run();
+
+    static void pin_thread(std::size_t cpu);
+
+    const std::size_t index_;
+    const std::optional<std::size_t> cpu_;
+    const net_context_ptr net_context_;
+    std::atomic<std::size_t> session_count_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopped_;
+    std::thread thread_;
+};
+
+using shard_ptr = std::shared_ptr<shard>;
+
+} // namespace ftp::detail
+#endif //LIBFTP_SHARD_HPP
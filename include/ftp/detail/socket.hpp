@@ -32,15 +32,13 @@
 namespace ftp::detail
 {
 
-class socket : public socket_base
+class socket final : public socket_base
 {
 public:
     explicit socket(boost::asio::io_context & io_context);
 
     explicit socket(boost::asio::ip::tcp::socket && socket);
 
-    void connect(const boost::asio::ip::tcp::resolver::results_type & eps, boost::system::error_code & ec) override;
-
     void connect(const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec) override;
 
     [[nodiscard]] bool is_connected() const override;
@@ -57,6 +55,8 @@ public:
 
     std::size_t write(std::string_view buf, boost::system::error_code & ec) override;
 
+    std::size_t write(std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec) override;
+
     std::size_t read_some(char *buf, std::size_t max_size, boost::system::error_code & ec) override;
 
     std::size_t read_line(std::string & buf, std::size_t max_size, boost::system::error_code & ec) override;
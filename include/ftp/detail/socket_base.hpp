@@ -25,12 +25,16 @@
 #ifndef LIBFTP_SOCKET_BASE_HPP
 #define LIBFTP_SOCKET_BASE_HPP
 
+#include <ftp/detail/net_utils.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/asio/read_until.hpp>
 #include <boost/asio/ssl/stream_base.hpp>
 #include <openssl/ssl.h>
+#include <chrono>
+#include <initializer_list>
 #include <memory>
+#include <optional>
 
 namespace ftp::detail
 {
@@ -38,8 +42,6 @@ namespace ftp::detail
 class socket_base
 {
 public:
-    virtual void connect(const boost::asio::ip::tcp::resolver::results_type & eps, boost::system::error_code & ec) = 0;
-
     virtual void connect(const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec) = 0;
 
     [[nodiscard]] virtual bool is_connected() const = 0;
@@ -56,6 +58,9 @@ public:
 
     virtual std::size_t write(std::string_view buf, boost::system::error_code & ec) = 0;
 
+    /* Gather write, e.g. a block header followed by the data. */
+    virtual std::size_t write(std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec) = 0;
+
     virtual std::size_t read_some(char *buf, std::size_t max_size, boost::system::error_code & ec) = 0;
 
     virtual std::size_t read_line(std::string & buf, std::size_t max_size, boost::system::error_code & ec) = 0;
@@ -76,33 +81,115 @@ public:
 
     virtual ~socket_base() = default;
 
+    /* The blocking operations fail with boost::asio::error::timed_out
+     * if they are not completed by the deadline. std::nullopt disables it.
+     */
+    void set_deadline(const std::optional<std::chrono::steady_clock::time_point> & deadline)
+    {
+        deadline_ = deadline;
+    }
+
 protected:
+    template<typename SocketType>
+    void connect(SocketType & socket, const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec)
+    {
+        if (deadline_)
+        {
+            run_until_deadline(socket, [&socket, &ep](auto handler)
+            {
+                socket.lowest_layer().async_connect(ep, [handler](const boost::system::error_code & ec) mutable
+                {
+                    handler(ec, 0);
+                });
+            }, ec);
+            return;
+        }
+
+        socket.lowest_layer().connect(ep, ec);
+    }
+
     template<typename SocketType>
     std::size_t write(SocketType & socket, const char *buf, std::size_t size, boost::system::error_code & ec)
     {
+        if (deadline_)
+        {
+            return run_until_deadline(socket, [&socket, buf, size](auto handler)
+            {
+                boost::asio::async_write(socket, boost::asio::buffer(buf, size), handler);
+            }, ec);
+        }
+
         return boost::asio::write(socket, boost::asio::buffer(buf, size), ec);
     }
 
     template<typename SocketType>
     std::size_t write(SocketType & socket, std::string_view buf, boost::system::error_code & ec)
     {
-        return boost::asio::write(socket, boost::asio::buffer(buf), ec);
+        return write(socket, buf.data(), buf.size(), ec);
+    }
+
+    template<typename SocketType>
+    std::size_t write(SocketType & socket, std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec)
+    {
+        if (deadline_)
+        {
+            return run_until_deadline(socket, [&socket, buffers](auto handler)
+            {
+                boost::asio::async_write(socket, buffers, handler);
+            }, ec);
+        }
+
+        return boost::asio::write(socket, buffers, ec);
     }
 
     template<typename SocketType>
     std::size_t read_some(SocketType & socket, char *buf, std::size_t max_size, boost::system::error_code & ec)
     {
+        if (deadline_)
+        {
+            return run_until_deadline(socket, [&socket, buf, max_size](auto handler)
+            {
+                socket.async_read_some(boost::asio::buffer(buf, max_size), handler);
+            }, ec);
+        }
+
         return socket.read_some(boost::asio::buffer(buf, max_size), ec);
     }
 
     template<typename SocketType>
     std::size_t read_line(SocketType & socket, std::string & buf, std::size_t max_size, boost::system::error_code & ec)
     {
+        if (deadline_)
+        {
+            return run_until_deadline(socket, [&socket, &buf, max_size](auto handler)
+            {
+                boost::asio::async_read_until(socket,
+                                              boost::asio::dynamic_buffer(buf, max_size),
+                                              match_eol, handler);
+            }, ec);
+        }
+
         return boost::asio::read_until(socket,
                                        boost::asio::dynamic_buffer(buf, max_size),
                                        match_eol, ec);
     }
 
+    /* Runs the asynchronous operation on the io_context of the socket, the socket is
+     * cancelled at the deadline.
+     */
+    template<typename SocketType, typename Operation>
+    std::size_t run_until_deadline(SocketType & socket, Operation && operation, boost::system::error_code & ec)
+    {
+        auto & io_context = static_cast<boost::asio::io_context &>(
+            boost::asio::query(socket.get_executor(), boost::asio::execution::context));
+
+        return net_utils::run_until(io_context, deadline_.value(), operation, [&socket]()
+        {
+            boost::system::error_code ignored;
+            socket.lowest_layer().cancel(ignored);
+        }, ec);
+    }
+
 private:
     static std::pair<boost::asio::buffers_iterator<boost::asio::const_buffer>, bool>
     match_eol(boost::asio::buffers_iterator<boost::asio::const_buffer> begin,
@@ -133,6 +220,9 @@ private:
 
         return std::make_pair(it, false);
     }
+
+protected:
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
 };
 
 using socket_base_ptr = std::unique_ptr<socket_base>;
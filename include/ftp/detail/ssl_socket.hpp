@@ -34,15 +34,13 @@
 namespace ftp::detail
 {
 
-class ssl_socket : public socket_base
+class ssl_socket final : public socket_base
 {
 public:
     ssl_socket(boost::asio::ip::tcp::socket && socket,
                boost::asio::ssl::context & ssl_context,
                SSL_SESSION *ssl_session = nullptr);
 
-    void connect(const boost::asio::ip::tcp::resolver::results_type & eps, boost::system::error_code & ec) override;
-
     void connect(const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec) override;
 
     [[nodiscard]] bool is_connected() const override;
@@ -59,6 +57,8 @@ public:
 
     std::size_t write(std::string_view buf, boost::system::error_code & ec) override;
 
+    std::size_t write(std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec) override;
+
     std::size_t read_some(char *buf, std::size_t max_size, boost::system::error_code & ec) override;
 
     std::size_t read_line(std::string & buf, std::size_t max_size, boost::system::error_code & ec) override;
@@ -46,6 +46,9 @@ std::string format(const std::string & fmt, Args && ...args)
 FTP_EXPORT_INTERNAL
 std::vector<std::string> split_string(std::string_view str, char del);
 
+FTP_EXPORT_INTERNAL
+bool equals_ignore_case(std::string_view lhs, std::string_view rhs);
+
 FTP_EXPORT_INTERNAL
 bool try_parse_uint8(std::string_view str, std::uint8_t & result);
 
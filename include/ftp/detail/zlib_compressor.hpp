@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_ZLIB_COMPRESSOR_HPP
+#define LIBFTP_ZLIB_COMPRESSOR_HPP
+
+#include <ftp/detail/export_internal.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/* Defined in zlib.h. */
+struct z_stream_s;
+
+namespace ftp::detail
+{
+
+/* Compresses the data transmitted in MODE Z.
+ *
+ * https://tools.ietf.org/html/draft-preston-ftpext-deflate-04
+ */
+class FTP_EXPORT_INTERNAL zlib_compressor
+{
+public:
+    zlib_compressor();
+
+    ~zlib_compressor();
+
+    zlib_compressor(const zlib_compressor &) = delete;
+
+    zlib_compressor & operator=(const zlib_compressor &) = delete;
+
+    /* Compresses the data and appends the output to the buffer. */
+    void compress(const char *data, std::size_t size, std::vector<char> & output);
+
+    /* Flushes the pending data and terminates the compressed stream. */
+    void finish(std::vector<char> & output);
+
+    /* Returns false if the library is built without zlib. */
+    static bool is_available();
+
+private:
+    void process(int flush, std::vector<char> & output);
+
+    std::unique_ptr<z_stream_s> stream_;
+};
+
+class FTP_EXPORT_INTERNAL zlib_decompressor
+{
+public:
+    zlib_decompressor();
+
+    ~zlib_decompressor();
+
+    zlib_decompressor(const zlib_decompressor &) = delete;
+
+    zlib_decompressor & operator=(const zlib_decompressor &) = delete;
+
+    /* Sets the compressed data inflated by the next decompress() calls.
+     * The data must stay valid until decompress() returns 0.
+     */
+    void set_input(const char *data, std::size_t size);
+
+    /* Inflates the input into the buffer, so that the output of a small input
+     * is bounded by the buffer. Returns the size of the output, 0 once the input
+     * is used up.
+     */
+    std::size_t decompress(char *buf, std::size_t size);
+
+    /* Returns true if the end of the compressed stream has been reached. */
+    [[nodiscard]] bool is_finished() const;
+
+private:
+    std::unique_ptr<z_stream_s> stream_;
+    bool finished_;
+};
+
+using zlib_compressor_ptr = std::unique_ptr<zlib_compressor>;
+using zlib_decompressor_ptr = std::unique_ptr<zlib_decompressor>;
+
+} // namespace ftp::detail
+#endif //LIBFTP_ZLIB_COMPRESSOR_HPP
@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_ERROR_HPP
+#define LIBFTP_ERROR_HPP
+
+#include <ftp/export.hpp>
+#include <boost/system/error_code.hpp>
+#include <type_traits>
+
+namespace ftp
+{
+
+/* The errors of the library, see ftp_exception::get_error_code(). */
+enum class error
+{
+    /* A control or data connection is not established in time. */
+    connect_timeout = 1,
+    /* The server does not reply to a command in time. */
+    reply_timeout = 2,
+    /* No data is sent or received over the data connection in time. */
+    transfer_timeout = 3,
+    /* The deadline set by client::set_deadline() has passed. */
+    deadline_exceeded = 4
+};
+
+FTP_EXPORT const boost::system::error_category & get_error_category();
+
+FTP_EXPORT boost::system::error_code make_error_code(error e);
+
+} // namespace ftp
+
+namespace boost::system
+{
+
+template<>
+struct is_error_code_enum<ftp::error> : std::true_type
+{
+};
+
+} // namespace boost::system
+#endif //LIBFTP_ERROR_HPP
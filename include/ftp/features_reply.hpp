@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_FEATURES_REPLY_HPP
+#define LIBFTP_FEATURES_REPLY_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/reply.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ftp
+{
+
+class FTP_EXPORT features_reply : public reply
+{
+public:
+    features_reply();
+
+    explicit features_reply(const reply & reply);
+
+    /* Return the features listed in the reply to the FEAT command,
+     * e.g. "MDTM", "REST STREAM", "MODE Z".
+     */
+    [[nodiscard]] const std::vector<std::string> & get_features() const;
+
+    /* Check whether the feature is listed. The name is matched case-insensitively
+     * against the whole feature line or against the feature line up to its parameters,
+     * e.g. "HASH" matches "HASH SHA-1*;SHA-256".
+     */
+    [[nodiscard]] bool has_feature(std::string_view name) const;
+
+private:
+    static std::vector<std::string> parse_features(const reply & reply);
+
+    std::vector<std::string> features_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_FEATURES_REPLY_HPP
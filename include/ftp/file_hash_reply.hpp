@@ -0,0 +1,57 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_FILE_HASH_REPLY_HPP
+#define LIBFTP_FILE_HASH_REPLY_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/hash_algorithm.hpp>
+#include <ftp/reply.hpp>
+#include <optional>
+#include <string>
+
+namespace ftp
+{
+
+class FTP_EXPORT file_hash_reply : public reply
+{
+public:
+    file_hash_reply();
+
+    file_hash_reply(const reply & reply, hash_algorithm algorithm);
+
+    [[nodiscard]] hash_algorithm get_algorithm() const;
+
+    /* Return the hash as a lowercase hexadecimal string. */
+    [[nodiscard]] const std::optional<std::string> & get_hash() const;
+
+private:
+    static std::optional<std::string> parse_hash(const reply & reply, hash_algorithm algorithm);
+
+    hash_algorithm algorithm_;
+    std::optional<std::string> hash_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_FILE_HASH_REPLY_HPP
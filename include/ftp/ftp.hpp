@@ -25,22 +25,45 @@
 #ifndef LIBFTP_FTP_HPP
 #define LIBFTP_FTP_HPP
 
+#include <ftp/async_logger.hpp>
 #include <ftp/client.hpp>
 #include <ftp/datetime.hpp>
+#include <ftp/error.hpp>
+#include <ftp/features_reply.hpp>
+#include <ftp/file_hash_reply.hpp>
 #include <ftp/file_list_reply.hpp>
 #include <ftp/file_modified_time_reply.hpp>
 #include <ftp/file_size_reply.hpp>
 #include <ftp/ftp_exception.hpp>
+#include <ftp/hash_algorithm.hpp>
+#include <ftp/local_address_pool.hpp>
 #include <ftp/observer.hpp>
+#include <ftp/progress_reporter.hpp>
+#include <ftp/rate_limiter.hpp>
 #include <ftp/replies.hpp>
 #include <ftp/reply.hpp>
+#include <ftp/resolver.hpp>
+#include <ftp/retry_policy.hpp>
+#include <ftp/segmented_upload.hpp>
+#include <ftp/session_manager.hpp>
+#include <ftp/socket_options.hpp>
 #include <ftp/ssl.hpp>
+#include <ftp/timeouts.hpp>
 #include <ftp/transfer_callback.hpp>
 #include <ftp/transfer_mode.hpp>
 #include <ftp/transfer_type.hpp>
+#include <ftp/transmission_mode.hpp>
+#include <ftp/stream/download_stream.hpp>
+#include <ftp/stream/file_output_stream.hpp>
 #include <ftp/stream/input_stream.hpp>
 #include <ftp/stream/istream_adapter.hpp>
+#include <ftp/stream/mapped_file_input_stream.hpp>
+#include <ftp/stream/memory_output_stream.hpp>
 #include <ftp/stream/ostream_adapter.hpp>
 #include <ftp/stream/output_stream.hpp>
+#include <ftp/stream/pipelined_istream.hpp>
+#include <ftp/stream/pipelined_ostream.hpp>
+#include <ftp/stream/span_input_stream.hpp>
+#include <ftp/stream/upload_stream.hpp>
 
 #endif //LIBFTP_FTP_HPP
@@ -43,6 +43,7 @@ public:
 
     template<typename ...Args>
     ftp_exception(const boost::system::error_code & ec, const std::string & fmt, Args && ...args)
+        : ec_(ec)
     {
         message_ = detail::utils::format(fmt, std::forward<Args>(args)...);
         message_.append(": ");
@@ -54,8 +55,15 @@ public:
         return message_.c_str();
     }
 
+    /* The error the exception is thrown for, if any (e.g. ftp::error::reply_timeout). */
+    [[nodiscard]] const boost::system::error_code & get_error_code() const noexcept
+    {
+        return ec_;
+    }
+
 protected:
     std::string message_;
+    boost::system::error_code ec_;
 };
 
 } // namespace ftp
@@ -1,7 +1,7 @@
 /*
  * MIT License
  *
- * Copyright (c) 2023 Denis Kovalchuk
+ * Copyright (c) 2024 Denis Kovalchuk
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -22,19 +22,20 @@
  * SOFTWARE.
  */
 
-#include <ftp/detail/binary_istream.hpp>
+#ifndef LIBFTP_HASH_ALGORITHM_HPP
+#define LIBFTP_HASH_ALGORITHM_HPP
 
-namespace ftp::detail
+namespace ftp
 {
 
-binary_istream::binary_istream(input_stream & src)
-    : src_(src)
+enum class hash_algorithm
 {
-}
+    crc32 = 0,
+    md5 = 1,
+    sha1 = 2,
+    sha256 = 3,
+    sha512 = 4
+};
 
-std::size_t binary_istream::read(char *buf, std::size_t size)
-{
-    return src_.read(buf, size);
-}
-
-} // namespace ftp::detail
+} // namespace ftp
+#endif //LIBFTP_HASH_ALGORITHM_HPP
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_LOCAL_ADDRESS_POOL_HPP
+#define LIBFTP_LOCAL_ADDRESS_POOL_HPP
+
+#include <ftp/export.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace ftp
+{
+
+/* Hands out local addresses in round-robin order. Thread-safe.
+ * Share a pool between clients to spread their connections over several
+ * network interfaces.
+ */
+class FTP_EXPORT local_address_pool
+{
+public:
+    explicit local_address_pool(std::vector<boost::asio::ip::address> addresses);
+
+    local_address_pool(const local_address_pool &) = delete;
+
+    local_address_pool & operator=(const local_address_pool &) = delete;
+
+    /* Returns the next address of the protocol family or nothing if the pool has none. */
+    [[nodiscard]] std::optional<boost::asio::ip::address> next(const boost::asio::ip::tcp & protocol);
+
+    [[nodiscard]] const std::vector<boost::asio::ip::address> & get_addresses() const;
+
+private:
+    const std::vector<boost::asio::ip::address> addresses_;
+    std::atomic<std::size_t> next_;
+};
+
+using local_address_pool_ptr = std::shared_ptr<local_address_pool>;
+
+} // namespace ftp
+#endif //LIBFTP_LOCAL_ADDRESS_POOL_HPP
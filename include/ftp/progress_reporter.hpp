@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_PROGRESS_REPORTER_HPP
+#define LIBFTP_PROGRESS_REPORTER_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/transfer_callback.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ftp
+{
+
+/* The state of a transfer passed to progress_reporter::on_progress(). */
+struct progress
+{
+    std::uint64_t bytes_transferred;
+
+    /* The size of the whole transfer, if it is known. */
+    std::optional<std::uint64_t> total_size;
+
+    std::chrono::steady_clock::duration elapsed;
+
+    /* Bytes per second, a moving average of the recent intervals. */
+    double throughput;
+
+    /* The estimated time left, if the size of the transfer is known. */
+    std::optional<std::chrono::steady_clock::duration> eta;
+
+    /* True for the last report, made at the end of the transfer. */
+    bool done;
+};
+
+/* Reports the progress of a transfer at most once per interval and once at its end.
+ *
+ * The clock is not read on every notification: the reporter estimates how many bytes
+ * are transferred in a fraction of the interval and checks the time only after them.
+ */
+class FTP_EXPORT progress_reporter : public transfer_callback
+{
+public:
+    static constexpr std::chrono::milliseconds default_interval = std::chrono::milliseconds(500);
+
+    explicit progress_reporter(std::chrono::milliseconds interval = default_interval);
+
+    /* Sets the size of the transfer to estimate the time left, for example the
+     * size of the remote file returned by client::get_file_size().
+     */
+    void set_total_size(const std::optional<std::uint64_t> & total_size);
+
+    [[nodiscard]] const std::optional<std::uint64_t> & get_total_size() const;
+
+    [[nodiscard]] std::chrono::milliseconds get_interval() const;
+
+    void begin() override;
+
+    void notify(std::size_t bytes_transferred) override;
+
+    void end() override;
+
+protected:
+    virtual void on_progress(const progress & progress) = 0;
+
+private:
+    void check_time();
+
+    void report(std::chrono::steady_clock::time_point now, bool done);
+
+    /* The weight of the last interval in the moving average of the throughput. */
+    static constexpr double smoothing = 0.3;
+
+    /* The number of clock checks per interval. */
+    static constexpr int checks_per_interval = 8;
+
+    const std::chrono::milliseconds interval_;
+    std::optional<std::uint64_t> total_size_;
+    std::uint64_t bytes_transferred_;
+    /* The clock is checked when bytes_transferred_ reaches it. */
+    std::uint64_t next_check_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_report_;
+    std::uint64_t last_report_bytes_;
+    double throughput_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_PROGRESS_REPORTER_HPP
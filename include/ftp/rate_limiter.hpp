@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_RATE_LIMITER_HPP
+#define LIBFTP_RATE_LIMITER_HPP
+
+#include <ftp/export.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace ftp
+{
+
+class rate_limiter;
+
+using rate_limiter_ptr = std::shared_ptr<rate_limiter>;
+
+/* Limits the bandwidth of data transfers with a token bucket. Thread-safe.
+ * rate - Bytes per second, 0 means unlimited.
+ * burst - The bucket size in bytes, i.e. how much data can be transferred
+ *         at full speed after a pause. 0 means 100 ms worth of data at the rate.
+ *
+ * The bytes consumed by a limiter are also consumed by its parent. Sharing
+ * limiters between transfers and clients gives a hierarchy of limits,
+ * e.g. per transfer -> per client -> per pool -> process-wide.
+ */
+class FTP_EXPORT rate_limiter
+{
+public:
+    explicit rate_limiter(std::uint64_t rate, std::uint64_t burst = 0, rate_limiter_ptr parent = nullptr);
+
+    rate_limiter(const rate_limiter &) = delete;
+
+    rate_limiter & operator=(const rate_limiter &) = delete;
+
+    /* Can be changed during a transfer. The threads waiting in consume()
+     * are woken up and pay off the rest of their wait at the new rate.
+     */
+    void set_rate(std::uint64_t rate, std::uint64_t burst = 0);
+
+    [[nodiscard]] std::uint64_t get_rate() const;
+
+    [[nodiscard]] std::uint64_t get_burst() const;
+
+    [[nodiscard]] const rate_limiter_ptr & get_parent() const;
+
+    /* Takes size bytes from this limiter and its ancestors and returns how long
+     * the caller has to wait before transferring them.
+     *
+     * The bucket may go into debt, so a transfer larger than the burst is not
+     * rejected but delayed, and the time overslept is not lost.
+     */
+    [[nodiscard]] std::chrono::nanoseconds reserve(std::size_t size);
+
+    /* Same as reserve(), but blocks the calling thread for the returned time. */
+    void consume(std::size_t size);
+
+    /* Same as consume(), but returns false without waiting out the time once
+     * the stop flag is set from another thread, or the deadline is reached.
+     * The flag is checked at least every wait_slice.
+     */
+    bool consume(std::size_t size,
+                 const std::atomic<bool> & stop,
+                 const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
+    static constexpr std::chrono::milliseconds wait_slice{50};
+
+private:
+    std::chrono::nanoseconds reserve(std::size_t size, rate_limiter *& bottleneck);
+
+    std::chrono::nanoseconds reserve_tokens(std::size_t size, std::chrono::steady_clock::time_point now);
+
+    /* Waits on the limiter that imposed the delay, so that its set_rate() wakes the caller up. */
+    bool wait(std::chrono::nanoseconds delay,
+              const std::atomic<bool> * stop,
+              const std::optional<std::chrono::steady_clock::time_point> & deadline);
+
+    void refill(std::chrono::steady_clock::time_point now);
+
+    static std::uint64_t make_burst(std::uint64_t rate, std::uint64_t burst);
+
+    mutable std::mutex mutex_;
+    std::condition_variable rate_changed_;
+    std::uint64_t rate_;
+    std::uint64_t burst_;
+    /* Negative when the bucket is in debt. */
+    double tokens_;
+    std::chrono::steady_clock::time_point last_refill_;
+    const rate_limiter_ptr parent_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_RATE_LIMITER_HPP
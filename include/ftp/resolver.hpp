@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LIBFTP_RESOLVER_HPP
+#define LIBFTP_RESOLVER_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/detail/lookup_pool.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ftp
+{
+
+class FTP_EXPORT resolver
+{
+public:
+    virtual std::vector<boost::asio::ip::tcp::endpoint> resolve(std::string_view hostname,
+                                                                std::uint16_t port,
+                                                                boost::system::error_code & ec) = 0;
+
+    /* Same as above, but fails with boost::asio::error::timed_out if the hostname
+     * is not resolved by the deadline. The default implementation ignores the deadline.
+     */
+    virtual std::vector<boost::asio::ip::tcp::endpoint>
+    resolve(std::string_view hostname,
+            std::uint16_t port,
+            const std::optional<std::chrono::steady_clock::time_point> & deadline,
+            boost::system::error_code & ec);
+
+    virtual ~resolver() = default;
+};
+
+using resolver_ptr = std::shared_ptr<resolver>;
+
+/* Resolves hostnames using the resolver of the operating system.
+ * With a deadline the hostname is resolved on a few threads shared by the requests
+ * of the resolver: the system resolver cannot be cancelled, the caller stops waiting
+ * for it at the deadline. A request for a hostname that is being resolved waits
+ * for the same lookup, so a slow DNS server does not start a thread per request.
+ */
+class FTP_EXPORT system_resolver : public resolver
+{
+public:
+    system_resolver();
+
+    std::vector<boost::asio::ip::tcp::endpoint> resolve(std::string_view hostname,
+                                                        std::uint16_t port,
+                                                        boost::system::error_code & ec) override;
+
+    std::vector<boost::asio::ip::tcp::endpoint>
+    resolve(std::string_view hostname,
+            std::uint16_t port,
+            const std::optional<std::chrono::steady_clock::time_point> & deadline,
+            boost::system::error_code & ec) override;
+
+private:
+    boost::asio::io_context io_context_;
+    detail::lookup_pool_ptr lookup_pool_;
+};
+
+/* Caches the results of the upstream resolver. Thread-safe.
+ * ttl - How long a successful result is reused.
+ * negative_ttl - How long a failed result is reused.
+ *
+ * Concurrent requests for the same hostname are coalesced into a single
+ * upstream request. A timed out request is not cached.
+ */
+class FTP_EXPORT caching_resolver : public resolver
+{
+public:
+    static constexpr std::chrono::milliseconds default_ttl = std::chrono::seconds(60);
+
+    static constexpr std::chrono::milliseconds default_negative_ttl = std::chrono::seconds(5);
+
+    caching_resolver();
+
+    explicit caching_resolver(resolver_ptr upstream,
+                              std::chrono::milliseconds ttl = default_ttl,
+                              std::chrono::milliseconds negative_ttl = default_negative_ttl);
+
+    std::vector<boost::asio::ip::tcp::endpoint> resolve(std::string_view hostname,
+                                                        std::uint16_t port,
+                                                        boost::system::error_code & ec) override;
+
+    std::vector<boost::asio::ip::tcp::endpoint>
+    resolve(std::string_view hostname,
+            std::uint16_t port,
+            const std::optional<std::chrono::steady_clock::time_point> & deadline,
+            boost::system::error_code & ec) override;
+
+    void clear();
+
+private:
+    struct entry
+    {
+        std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+        boost::system::error_code ec;
+        std::chrono::steady_clock::time_point expiry;
+        bool pending = false;
+    };
+
+    void remove_expired_entries(std::chrono::steady_clock::time_point now);
+
+    static std::vector<boost::asio::ip::tcp::endpoint> get_endpoints(const entry & entry, std::uint16_t port);
+
+    resolver_ptr upstream_;
+    std::chrono::milliseconds ttl_;
+    std::chrono::milliseconds negative_ttl_;
+    std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::unordered_map<std::string, entry> entries_;
+};
+
+/* Returns the resolver used by clients that have no resolver of their own.
+ * By default, it is a caching_resolver shared by all clients of the process.
+ */
+FTP_EXPORT
+resolver_ptr get_default_resolver();
+
+/* Replaces the default resolver. Passing nullptr restores a new caching_resolver. */
+FTP_EXPORT
+void set_default_resolver(resolver_ptr resolver);
+
+} // namespace ftp
+#endif //LIBFTP_RESOLVER_HPP
@@ -0,0 +1,114 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_RETRY_POLICY_HPP
+#define LIBFTP_RETRY_POLICY_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/reply.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace ftp
+{
+
+/* Decides whether and when a failed download is retried, see client::set_retry_policy(). */
+class FTP_EXPORT retry_policy
+{
+public:
+    /* Returns the delay before the next attempt, or std::nullopt to give up.
+     * attempt - The number of the failed attempts, starting from 1.
+     * reply - The negative reply the attempt has failed with, or std::nullopt
+     *         if it has failed with an exception, ec is the error code of the exception.
+     */
+    virtual std::optional<std::chrono::milliseconds> get_retry_delay(std::size_t attempt,
+                                                                      const std::optional<reply> & reply,
+                                                                      const boost::system::error_code & ec) = 0;
+
+    virtual ~retry_policy() = default;
+};
+
+using retry_policy_ptr = std::shared_ptr<retry_policy>;
+
+/* Retries the transient failures with exponentially growing delays. Thread-safe.
+ * max_attempts - The number of attempts, including the first one.
+ * initial_delay - The delay after the first failed attempt, doubled after each next one.
+ * max_delay - The limit of the delay.
+ * retryable_codes - The reply codes of the transient failures. The exceptions with
+ *                   an error code (network errors and timeouts) are retried as well.
+ *
+ * A delay is picked at random between a half and the whole of its value, so that
+ * the clients that have failed together do not retry together.
+ */
+class FTP_EXPORT exponential_backoff : public retry_policy
+{
+public:
+    static constexpr std::size_t default_max_attempts = 5;
+
+    static constexpr std::chrono::milliseconds default_initial_delay = std::chrono::milliseconds(500);
+
+    static constexpr std::chrono::milliseconds default_max_delay = std::chrono::seconds(30);
+
+    explicit exponential_backoff(std::size_t max_attempts = default_max_attempts,
+                                 std::chrono::milliseconds initial_delay = default_initial_delay,
+                                 std::chrono::milliseconds max_delay = default_max_delay,
+                                 std::vector<std::uint16_t> retryable_codes = { 421, 425, 426, 450 });
+
+    exponential_backoff(const exponential_backoff &) = delete;
+
+    exponential_backoff & operator=(const exponential_backoff &) = delete;
+
+    std::optional<std::chrono::milliseconds> get_retry_delay(std::size_t attempt,
+                                                              const std::optional<reply> & reply,
+                                                              const boost::system::error_code & ec) override;
+
+    [[nodiscard]] std::size_t get_max_attempts() const;
+
+    [[nodiscard]] std::chrono::milliseconds get_initial_delay() const;
+
+    [[nodiscard]] std::chrono::milliseconds get_max_delay() const;
+
+    [[nodiscard]] const std::vector<std::uint16_t> & get_retryable_codes() const;
+
+private:
+    [[nodiscard]] bool is_retryable(const std::optional<reply> & reply, const boost::system::error_code & ec) const;
+
+    const std::size_t max_attempts_;
+    const std::chrono::milliseconds initial_delay_;
+    const std::chrono::milliseconds max_delay_;
+    const std::vector<std::uint16_t> retryable_codes_;
+    std::mutex mutex_;
+    std::minstd_rand random_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_RETRY_POLICY_HPP
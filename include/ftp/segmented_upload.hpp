@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_SEGMENTED_UPLOAD_HPP
+#define LIBFTP_SEGMENTED_UPLOAD_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/client.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace ftp
+{
+
+/* Uploads a file over several connections at once, each writing a segment
+ * of the remote file (REST and STOR commands). The first segment creates
+ * the file, the others start when it is open. The size of the remote file
+ * is verified at the end.
+ *
+ * Some servers (e.g. pyftpdlib) accept a restart marker only within the size
+ * of the file: a segment they reject is retried when all the preceding segments
+ * are completed, and the following segments wait for them too.
+ *
+ * The clients are kept open for the next uploads. An upload is run by one thread
+ * at a time.
+ */
+class FTP_EXPORT segmented_upload
+{
+public:
+    /* Returns a connected and logged in client, called from the upload threads. */
+    using client_factory = std::function<std::unique_ptr<client>()>;
+
+    /* Returns a stream of size bytes of the source from the offset. */
+    using source_factory = std::function<input_stream_ptr(std::uint64_t offset, std::uint64_t size)>;
+
+    static constexpr std::size_t default_connection_count = 4;
+
+    static constexpr std::uint64_t default_min_segment_size = 8 * 1024 * 1024;
+
+    explicit segmented_upload(client_factory factory,
+                              std::size_t connection_count = default_connection_count,
+                              std::uint64_t min_segment_size = default_min_segment_size);
+
+    segmented_upload(const segmented_upload &) = delete;
+
+    segmented_upload & operator=(const segmented_upload &) = delete;
+
+    /* Throws ftp_exception if a segment fails or the size of the remote file differs. */
+    void upload(const std::filesystem::path & local_path, std::string_view remote_path);
+
+    /* The segments may be read from mapped_file_input_stream ranges, if the file
+     * is not truncated during the upload.
+     */
+    void upload(const source_factory & source, std::uint64_t size, std::string_view remote_path);
+
+    /* Disconnects the pooled clients. */
+    void close();
+
+    [[nodiscard]] std::size_t get_connection_count() const;
+
+    [[nodiscard]] std::uint64_t get_min_segment_size() const;
+
+private:
+    struct segment
+    {
+        std::uint64_t offset;
+        std::uint64_t size;
+        bool completed;
+        /* Rejected once, waits for the preceding segments. */
+        bool deferred;
+    };
+
+    void run_worker(std::unique_ptr<client> & client, const source_factory & source, std::string_view remote_path);
+
+    /* Blocks until a segment may start. Returns false if no segments are left. */
+    bool take_segment(std::size_t & index);
+
+    /* Returns true if the segment may start now, called with the mutex locked. */
+    [[nodiscard]] bool can_start(std::size_t index) const;
+
+    /* Returns false if the segment is rejected and should be retried. */
+    bool upload_segment(client & client, std::size_t index, const source_factory & source, std::string_view remote_path);
+
+    void complete_segment(std::size_t index);
+
+    void defer_segment(std::size_t index);
+
+    void fail(std::exception_ptr error);
+
+    void set_file_created();
+
+    const client_factory client_factory_;
+    const std::size_t connection_count_;
+    const std::uint64_t min_segment_size_;
+    std::vector<std::unique_ptr<client>> clients_;
+    /* The state of the running upload. */
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<segment> segments_;
+    std::deque<std::size_t> pending_;
+    bool file_created_;
+    /* The server rejects segments past the end of the file. */
+    bool sequential_;
+    std::exception_ptr error_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_SEGMENTED_UPLOAD_HPP
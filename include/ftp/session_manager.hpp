@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_SESSION_MANAGER_HPP
+#define LIBFTP_SESSION_MANAGER_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/client.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <ftp/ssl.hpp>
+#include <ftp/detail/shard.hpp>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ftp
+{
+
+/* A client running on a shard of a session_manager. The operations are submitted
+ * to the thread of the shard and run there one at a time, in the order of submission.
+ */
+class FTP_EXPORT session
+{
+public:
+    session(const session &) = delete;
+
+    session & operator=(const session &) = delete;
+
+    /* Destroys the client on its shard after the submitted operations.
+     * Waits for it, unless called on the thread of another shard.
+     */
+    ~session();
+
+    /* Runs function(client &) on the shard, the future gets its result or exception.
+     * Throws ftp_exception if the session manager is destroyed.
+     */
+    template<typename Function>
+    std::future<std::invoke_result_t<Function, client &>> submit(Function function)
+    {
+        using result_type = std::invoke_result_t<Function, client &>;
+
+        auto task = std::make_shared<std::packaged_task<result_type()>>(
+            [this, function = std::move(function)]() mutable
+            {
+                return function(*client_);
+            });
+
+        std::future<result_type> future = task->get_future();
+
+        if (!shard_->post([task]() { (*task)(); }))
+        {
+            throw ftp_exception("Cannot submit operation. The session manager is destroyed.");
+        }
+
+        return future;
+    }
+
+    [[nodiscard]] const std::string & get_hostname() const;
+
+    [[nodiscard]] std::size_t get_shard_index() const;
+
+private:
+    friend class session_manager;
+
+    session(detail::shard_ptr shard, std::string_view hostname, ssl::context_ptr && ssl_context);
+
+    detail::shard_ptr shard_;
+    std::string hostname_;
+    std::unique_ptr<client> client_;
+};
+
+using session_ptr = std::shared_ptr<session>;
+
+/* Runs the sessions on shards: threads pinned to CPUs, each with a net context
+ * of its own, so that the shards share nothing. A new session goes to the shard
+ * with the fewest sessions, so the sessions to the same host are spread too.
+ *
+ * The client is synchronous: the operations of the sessions on a shard run one
+ * at a time, so a long transfer delays the other sessions of its shard. Use at
+ * least as many shards as sessions transferring at the same time.
+ */
+class FTP_EXPORT session_manager
+{
+public:
+    /* shard_count 0 means a shard per hardware thread. */
+    explicit session_manager(std::size_t shard_count = 0, bool pin_threads = true);
+
+    session_manager(const session_manager &) = delete;
+
+    session_manager & operator=(const session_manager &) = delete;
+
+    /* Runs the submitted operations and stops the shards. */
+    ~session_manager();
+
+    /* Creates a client on the shard with the fewest sessions, it is connected by
+     * a submitted operation. The hostname is only returned by session::get_hostname(),
+     * the sessions to the same host are not placed on the same shard.
+     */
+    session_ptr create_session(std::string_view hostname, ssl::context_ptr && ssl_context = nullptr);
+
+    [[nodiscard]] std::size_t get_shard_count() const;
+
+    [[nodiscard]] std::size_t get_session_count(std::size_t shard_index) const;
+
+private:
+    detail::shard_ptr select_shard();
+
+    std::vector<detail::shard_ptr> shards_;
+    /* Makes the choice of a shard and the session count update atomic. */
+    std::mutex mutex_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_SESSION_MANAGER_HPP
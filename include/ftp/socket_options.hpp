@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_SOCKET_OPTIONS_HPP
+#define LIBFTP_SOCKET_OPTIONS_HPP
+
+#include <ftp/local_address_pool.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace ftp
+{
+
+/* Options set on a socket after it is opened or accepted.
+ * The options that are not set keep the system defaults. Setting an option
+ * that is not supported by the platform fails with operation_not_supported.
+ */
+struct socket_options
+{
+    /* TCP_NODELAY. */
+    std::optional<bool> no_delay;
+
+    /* SO_SNDBUF, in bytes. */
+    std::optional<int> send_buffer_size;
+
+    /* SO_RCVBUF, in bytes. It is set before connecting, so it affects the TCP window scale. */
+    std::optional<int> receive_buffer_size;
+
+    /* TCP_NOTSENT_LOWAT, in bytes. Linux and macOS. */
+    std::optional<int> not_sent_low_watermark;
+
+    /* TCP_CONGESTION, e.g. "bbr" or "cubic". Linux. */
+    std::optional<std::string> congestion_control;
+
+    /* SO_KEEPALIVE. */
+    std::optional<bool> keep_alive;
+
+    /* TCP_KEEPIDLE (TCP_KEEPALIVE on macOS). */
+    std::optional<std::chrono::seconds> keep_alive_idle;
+
+    /* TCP_KEEPINTVL. */
+    std::optional<std::chrono::seconds> keep_alive_interval;
+
+    /* TCP_KEEPCNT. */
+    std::optional<int> keep_alive_count;
+
+    /* SO_BUSY_POLL. Linux. */
+    std::optional<std::chrono::microseconds> busy_poll;
+
+    /* The local address to bind to before connecting. */
+    std::optional<boost::asio::ip::address> local_address;
+
+    /* The pool to take the local address from, if local_address is not set. */
+    local_address_pool_ptr local_address_pool;
+
+    /* SO_BINDTODEVICE, the network interface to bind to before connecting, e.g. "eth1". Linux. */
+    std::optional<std::string> bind_device;
+};
+
+} // namespace ftp
+#endif //LIBFTP_SOCKET_OPTIONS_HPP
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_DOWNLOAD_STREAM_HPP
+#define LIBFTP_DOWNLOAD_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/replies.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <ftp/detail/command_queue.hpp>
+#include <ftp/detail/data_connection.hpp>
+#include <ftp/detail/hasher.hpp>
+#include <ftp/detail/zlib_compressor.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ftp
+{
+
+class client;
+
+/* A download read at the pace of the caller, see client::open_download().
+ * The data is received from the data connection only when it is read,
+ * so a slow reader slows down the server instead of buffering the data.
+ * Until the stream is closed, the other calls on the client throw ftp_exception
+ * (except abort_transfer(), add_observer() and remove_observer()).
+ */
+class FTP_EXPORT download_stream : public input_stream
+{
+public:
+    download_stream(const download_stream &) = delete;
+
+    download_stream & operator=(const download_stream &) = delete;
+
+    /* Closes the stream, but errors are ignored: call close() to learn the result of the transfer. */
+    ~download_stream() override;
+
+    /* Blocks until some data is received. Returns 0 at the end of the file
+     * or if the transfer is aborted by client::abort_transfer().
+     */
+    std::size_t read(char *buf, std::size_t size) override;
+
+    /* Returns false if the server has refused the transfer, see close(). */
+    [[nodiscard]] bool is_open() const;
+
+    /* Completes the transfer and returns its replies. If the file is not read
+     * to the end or client::abort_transfer() is called, the transfer is aborted
+     * (ABOR command).
+     */
+    replies close();
+
+private:
+    friend class client;
+
+    /* Appends the converted data to the buffer of the stream. */
+    class buffer_ostream : public output_stream
+    {
+    public:
+        explicit buffer_ostream(std::string & buffer);
+
+        void write(char *buf, std::size_t size) override;
+
+        void flush() override;
+
+    private:
+        std::string & buffer_;
+    };
+
+    download_stream(client & client,
+                    std::unique_lock<detail::command_queue> && lock,
+                    detail::data_connection_ptr && connection,
+                    replies && replies);
+
+    /* Receives the next chunk into the buffer. Returns false at the end of the file. */
+    bool fill_buffer();
+
+    /* Hashes the data and appends it to the buffer, converting the line endings. */
+    void append_data(char *data, std::size_t size);
+
+    /* Reads from the data connection. Returns 0 and sets aborted_ if the transfer is aborted. */
+    std::size_t receive(char *buf, std::size_t size);
+
+    client & client_;
+    std::unique_lock<detail::command_queue> lock_;
+    detail::data_connection_ptr connection_;
+    replies replies_;
+    detail::hasher_ptr hasher_;
+    detail::zlib_decompressor_ptr decompressor_;
+    std::string buffer_;
+    std::size_t buffer_pos_;
+    buffer_ostream sink_;
+    /* Converts the line endings in the ASCII transfer type. */
+    output_stream_ptr converter_;
+    std::vector<char> received_;
+    std::vector<char> decompressed_;
+    bool eof_;
+    bool aborted_;
+    bool closed_;
+};
+
+using download_stream_ptr = std::unique_ptr<download_stream>;
+
+} // namespace ftp
+#endif //LIBFTP_DOWNLOAD_STREAM_HPP
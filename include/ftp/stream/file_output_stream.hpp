@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_FILE_OUTPUT_STREAM_HPP
+#define LIBFTP_FILE_OUTPUT_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ftp
+{
+
+/* Writes a file through an aligned buffer, which is lent to the data connection
+ * (see output_stream::prepare()). The file is created or truncated.
+ */
+class FTP_EXPORT file_output_stream : public output_stream
+{
+public:
+    enum class cache_mode
+    {
+        /* Write through the page cache. */
+        buffered,
+        /* Write through the page cache, start the writeback of each written buffer
+         * and drop the previous one from the cache (Linux only, otherwise buffered).
+         */
+        drop_behind,
+        /* Bypass the page cache (O_DIRECT, F_NOCACHE, FILE_FLAG_NO_BUFFERING).
+         * Falls back to drop_behind if the file system does not support it.
+         */
+        direct
+    };
+
+    static constexpr std::size_t buffer_size = 1024 * 1024;
+
+    /* The alignment of the buffer, the file offsets and the sizes in the direct mode. */
+    static constexpr std::size_t alignment = 4096;
+
+    explicit file_output_stream(const std::filesystem::path & path, cache_mode mode = cache_mode::buffered);
+
+    file_output_stream(const file_output_stream &) = delete;
+
+    file_output_stream & operator=(const file_output_stream &) = delete;
+
+    /* The buffered data is written, but errors are ignored: call flush() to check them. */
+    ~file_output_stream() override;
+
+    /* Reserves the disk space for the expected file size (e.g. the SIZE reply),
+     * so that the file is not fragmented. The file size is not changed.
+     */
+    void preallocate(std::uint64_t size);
+
+    void write(char *buf, std::size_t size) override;
+
+    /* Writes the buffered data to the file. */
+    void flush() override;
+
+    char * prepare(std::size_t & size) override;
+
+    void commit(std::size_t size) override;
+
+    [[nodiscard]] cache_mode get_cache_mode() const;
+
+private:
+    /* Writes the buffered data, in the direct mode only the aligned part of it. */
+    void write_buffer();
+
+    void write_file(const char *data, std::size_t size, std::uint64_t offset);
+
+    void truncate_file(std::uint64_t size);
+
+    void drop_behind();
+
+    void close();
+
+#ifdef _WIN32
+    void *file_;
+#else
+    int fd_;
+#endif
+    cache_mode mode_;
+    char *buffer_;
+    std::size_t buffer_used_;
+    /* The file offset of the buffer start. */
+    std::uint64_t offset_;
+    /* The ranges [dropped_offset_, started_offset_) and [started_offset_, offset_)
+     * are under the writeback and not yet under the writeback respectively.
+     */
+    std::uint64_t dropped_offset_;
+    std::uint64_t started_offset_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_FILE_OUTPUT_STREAM_HPP
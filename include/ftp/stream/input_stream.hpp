@@ -28,6 +28,8 @@
 #include <ftp/export.hpp>
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <string_view>
 
 namespace ftp
 {
@@ -37,6 +39,22 @@ class FTP_EXPORT input_stream
 public:
     virtual std::size_t read(char *buf, std::size_t size) = 0;
 
+    /* A stream that keeps its data in memory may expose it to send the data
+     * without copying: peek() returns the next contiguous region of at most
+     * max_size bytes (empty at the end of the stream), consume() skips
+     * the first size bytes of it.
+     *
+     * The default implementation returns std::nullopt, the data is taken by read().
+     */
+    virtual std::optional<std::string_view> peek(std::size_t max_size)
+    {
+        return std::nullopt;
+    }
+
+    virtual void consume(std::size_t size)
+    {
+    }
+
     virtual ~input_stream() = default;
 };
 
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_MAPPED_FILE_INPUT_STREAM_HPP
+#define LIBFTP_MAPPED_FILE_INPUT_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace ftp
+{
+
+/* Reads a file through a sliding memory-mapped window, so that uploads
+ * send the file pages straight from the page cache (see input_stream::peek()).
+ * A window is unmapped as soon as it is consumed.
+ *
+ * The file must not be truncated while it is read. A truncation is detected
+ * before a window is mapped (POSIX), but reading a mapped window of a file truncated
+ * by another process raises SIGBUS. Upload the files other processes may modify
+ * from an std::ifstream (see istream_adapter) instead.
+ */
+class FTP_EXPORT mapped_file_input_stream : public input_stream
+{
+public:
+    static constexpr std::size_t default_window_size = 16 * 1024 * 1024;
+
+    /* The window size is rounded up to the mapping granularity. */
+    explicit mapped_file_input_stream(const std::filesystem::path & path,
+                                      std::size_t window_size = default_window_size);
+
+    mapped_file_input_stream(const mapped_file_input_stream &) = delete;
+
+    mapped_file_input_stream & operator=(const mapped_file_input_stream &) = delete;
+
+    ~mapped_file_input_stream() override;
+
+    std::size_t read(char *buf, std::size_t size) override;
+
+    std::optional<std::string_view> peek(std::size_t max_size) override;
+
+    void consume(std::size_t size) override;
+
+    [[nodiscard]] std::uint64_t get_size() const;
+
+    /* Limits the stream to size bytes from the offset, e.g. a segment of the file.
+     * Throws ftp_exception if the range exceeds the file.
+     */
+    void set_range(std::uint64_t offset, std::uint64_t size);
+
+private:
+    void map_window();
+
+    void unmap_window();
+
+    void close();
+
+#ifdef _WIN32
+    void *file_;
+    void *mapping_;
+#else
+    int fd_;
+#endif
+    std::uint64_t size_;
+    std::uint64_t position_;
+    /* The end of the range read. */
+    std::uint64_t end_;
+    std::size_t window_size_;
+    /* The mapped window [window_offset_, window_offset_ + window_length_). */
+    char *window_;
+    std::uint64_t window_offset_;
+    std::size_t window_length_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_MAPPED_FILE_INPUT_STREAM_HPP
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_MEMORY_OUTPUT_STREAM_HPP
+#define LIBFTP_MEMORY_OUTPUT_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ftp
+{
+
+/* Writes the data to memory, either to a buffer of the caller or to a growable
+ * buffer owned by the stream. The room left in the memory is lent to the data
+ * connection (see output_stream::prepare()), so with a preallocated buffer
+ * the data is received in place. The growable buffer is not zero-filled.
+ */
+class FTP_EXPORT memory_output_stream : public output_stream
+{
+public:
+    /* Writes to a growable buffer, see preallocate() and release(). */
+    memory_output_stream();
+
+    /* Writes to the buffer of the caller, which must outlive the stream.
+     * A write past the end of the buffer throws ftp_exception.
+     */
+    memory_output_stream(char *data, std::size_t size);
+
+    memory_output_stream(const memory_output_stream &) = delete;
+
+    memory_output_stream & operator=(const memory_output_stream &) = delete;
+
+    /* Reserves the memory for the expected size (e.g. the SIZE reply), so that
+     * the buffer is allocated once. Throws ftp_exception if the buffer of the caller
+     * is smaller.
+     */
+    void preallocate(std::uint64_t size);
+
+    void write(char *buf, std::size_t size) override;
+
+    /* The data is not buffered, does nothing. */
+    void flush() override;
+
+    char * prepare(std::size_t & size) override;
+
+    void commit(std::size_t size) override;
+
+    [[nodiscard]] std::string_view get_data() const;
+
+    [[nodiscard]] std::size_t get_size() const;
+
+    /* Copies the data out and frees the growable buffer, get_data() reads
+     * the data in place. The stream is empty afterwards.
+     */
+    std::string release();
+
+private:
+    [[nodiscard]] char * get_buffer() const;
+
+    /* Moves the data to a growable buffer of the given capacity. */
+    void reallocate(std::size_t capacity);
+
+    /* The buffer of the caller, nullptr for the growable buffer. */
+    char *data_;
+    /* The size of the buffer of the caller or of the growable buffer. */
+    std::size_t capacity_;
+    std::size_t size_;
+    std::unique_ptr<char[]> buffer_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_MEMORY_OUTPUT_STREAM_HPP
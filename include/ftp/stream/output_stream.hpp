@@ -39,6 +39,22 @@ public:
 
     virtual void flush() = 0;
 
+    /* A stream may lend its own memory to receive the data without copying:
+     * prepare() returns a buffer of up to size bytes and stores its length
+     * in size, commit() appends the first size bytes of it to the stream.
+     * A buffer that is not committed is discarded by the next prepare().
+     *
+     * The default implementation returns nullptr, the data is passed to write().
+     */
+    virtual char * prepare(std::size_t & size)
+    {
+        return nullptr;
+    }
+
+    virtual void commit(std::size_t size)
+    {
+    }
+
     virtual ~output_stream() = default;
 };
 
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_PIPELINED_ISTREAM_HPP
+#define LIBFTP_PIPELINED_ISTREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <ftp/detail/buffer_ring.hpp>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+
+namespace ftp
+{
+
+/* Reads the data from the source stream ahead on a separate thread,
+ * so that a slow source (e.g. a disk stall) does not stop writing
+ * to the data connection until the buffers are empty.
+ *
+ * An error of the source stream is thrown by read() once the data
+ * read before the error is consumed.
+ */
+class FTP_EXPORT pipelined_istream : public input_stream
+{
+public:
+    static constexpr std::size_t default_buffer_size = 1024 * 1024;
+
+    static constexpr std::size_t default_buffer_count = 4;
+
+    explicit pipelined_istream(input_stream & src,
+                               std::size_t buffer_size = default_buffer_size,
+                               std::size_t buffer_count = default_buffer_count);
+
+    pipelined_istream(const pipelined_istream &) = delete;
+
+    pipelined_istream & operator=(const pipelined_istream &) = delete;
+
+    ~pipelined_istream() override;
+
+    std::size_t read(char *buf, std::size_t size) override;
+
+    /* Exposes the rest of the current buffer. */
+    std::optional<std::string_view> peek(std::size_t max_size) override;
+
+    void consume(std::size_t size) override;
+
+private:
+    void run();
+
+    input_stream & src_;
+    detail::buffer_ring ring_;
+    detail::buffer_ring::buffer *current_;
+    std::size_t position_;
+    /* Set by the reader thread before the ring is finished. */
+    std::exception_ptr error_;
+    std::atomic<bool> stopped_;
+    std::thread thread_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_PIPELINED_ISTREAM_HPP
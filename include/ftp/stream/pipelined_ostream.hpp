@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_PIPELINED_OSTREAM_HPP
+#define LIBFTP_PIPELINED_OSTREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <ftp/detail/buffer_ring.hpp>
+#include <cstddef>
+#include <exception>
+#include <thread>
+
+namespace ftp
+{
+
+/* Writes the data to the destination stream on a separate thread,
+ * so that a slow destination (e.g. a disk stall) does not stop reading
+ * from the data connection until the buffers are full.
+ *
+ * An error of the destination stream is thrown by the next write() or flush().
+ * The data written before the destruction is written to the destination,
+ * but the destination is not flushed.
+ */
+class FTP_EXPORT pipelined_ostream : public output_stream
+{
+public:
+    static constexpr std::size_t default_buffer_size = 1024 * 1024;
+
+    static constexpr std::size_t default_buffer_count = 4;
+
+    explicit pipelined_ostream(output_stream & dst,
+                               std::size_t buffer_size = default_buffer_size,
+                               std::size_t buffer_count = default_buffer_count);
+
+    pipelined_ostream(const pipelined_ostream &) = delete;
+
+    pipelined_ostream & operator=(const pipelined_ostream &) = delete;
+
+    ~pipelined_ostream() override;
+
+    void write(char *buf, std::size_t size) override;
+
+    /* Waits until the data is written and flushes the destination. */
+    void flush() override;
+
+    /* Lends the free space of the current buffer, returns nullptr
+     * if the size exceeds the buffer size.
+     */
+    char * prepare(std::size_t & size) override;
+
+    void commit(std::size_t size) override;
+
+private:
+    void run();
+
+    void rethrow_error();
+
+    output_stream & dst_;
+    detail::buffer_ring ring_;
+    detail::buffer_ring::buffer *current_;
+    /* Set by the writer thread before the ring is closed. */
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_PIPELINED_OSTREAM_HPP
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_SPAN_INPUT_STREAM_HPP
+#define LIBFTP_SPAN_INPUT_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <cstddef>
+#include <string_view>
+
+namespace ftp
+{
+
+/* Reads the data from memory of the caller, which must outlive the stream.
+ * The data is sent without copying it (see input_stream::peek()).
+ */
+class FTP_EXPORT span_input_stream : public input_stream
+{
+public:
+    span_input_stream(const char *data, std::size_t size);
+
+    explicit span_input_stream(std::string_view data);
+
+    std::size_t read(char *buf, std::size_t size) override;
+
+    std::optional<std::string_view> peek(std::size_t max_size) override;
+
+    void consume(std::size_t size) override;
+
+    [[nodiscard]] std::size_t get_size() const;
+
+private:
+    std::string_view data_;
+    std::size_t position_;
+};
+
+} // namespace ftp
+#endif //LIBFTP_SPAN_INPUT_STREAM_HPP
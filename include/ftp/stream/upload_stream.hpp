@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_UPLOAD_STREAM_HPP
+#define LIBFTP_UPLOAD_STREAM_HPP
+
+#include <ftp/export.hpp>
+#include <ftp/replies.hpp>
+#include <ftp/stream/input_stream.hpp>
+#include <ftp/stream/output_stream.hpp>
+#include <ftp/detail/command_queue.hpp>
+#include <ftp/detail/data_connection.hpp>
+#include <ftp/detail/hasher.hpp>
+#include <ftp/detail/zlib_compressor.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ftp
+{
+
+class client;
+
+/* An upload written at the pace of the caller, see client::open_upload().
+ * The data is sent over the data connection as it is written, a write
+ * blocks while the server does not keep up.
+ * Until the stream is closed, the other calls on the client throw ftp_exception
+ * (except abort_transfer(), add_observer() and remove_observer()).
+ */
+class FTP_EXPORT upload_stream : public output_stream
+{
+public:
+    upload_stream(const upload_stream &) = delete;
+
+    upload_stream & operator=(const upload_stream &) = delete;
+
+    /* Closes the stream, but errors are ignored: call close() to learn the result of the upload,
+     * a destroyed stream may leave an incomplete file on the server.
+     */
+    ~upload_stream() override;
+
+    /* Blocks until the data is sent. Throws ftp_exception if the transfer
+     * is aborted by client::abort_transfer(), close() returns the replies of ABOR.
+     */
+    void write(char *buf, std::size_t size) override;
+
+    /* The data is not buffered, does nothing. */
+    void flush() override;
+
+    /* Returns false if the server has refused the transfer, see close(). */
+    [[nodiscard]] bool is_open() const;
+
+    /* Completes the file and returns the replies of the transfer. */
+    replies close();
+
+private:
+    friend class client;
+
+    /* Exposes the data of a write to the ASCII conversion. */
+    class chunk_istream : public input_stream
+    {
+    public:
+        chunk_istream();
+
+        void reset(const char *data, std::size_t size);
+
+        std::size_t read(char *buf, std::size_t size) override;
+
+    private:
+        const char *data_;
+        std::size_t size_;
+    };
+
+    upload_stream(client & client,
+                  std::unique_lock<detail::command_queue> && lock,
+                  detail::data_connection_ptr && connection,
+                  replies && replies);
+
+    void send(const char *data, std::size_t size);
+
+    client & client_;
+    std::unique_lock<detail::command_queue> lock_;
+    detail::data_connection_ptr connection_;
+    replies replies_;
+    detail::hasher_ptr hasher_;
+    detail::zlib_compressor_ptr compressor_;
+    chunk_istream chunk_;
+    /* Converts the line endings in the ASCII transfer type. */
+    input_stream_ptr converter_;
+    std::vector<char> converted_;
+    std::vector<char> compressed_;
+    bool closed_;
+};
+
+using upload_stream_ptr = std::unique_ptr<upload_stream>;
+
+} // namespace ftp
+#endif //LIBFTP_UPLOAD_STREAM_HPP
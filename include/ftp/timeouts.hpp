@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef LIBFTP_TIMEOUTS_HPP
+#define LIBFTP_TIMEOUTS_HPP
+
+#include <chrono>
+#include <optional>
+
+namespace ftp
+{
+
+/* The timeouts of the network operations. The timeouts that are not set
+ * are disabled. An operation that times out throws ftp_exception with
+ * the error code of the timeout (see ftp::error).
+ */
+struct timeouts
+{
+    /* Establishing a control or data connection, including the name resolution
+     * and the TLS handshake.
+     */
+    std::optional<std::chrono::milliseconds> connect;
+
+    /* Sending a command and receiving the reply. */
+    std::optional<std::chrono::milliseconds> reply;
+
+    /* The data connection idle time: no data is sent or received. */
+    std::optional<std::chrono::milliseconds> transfer;
+};
+
+} // namespace ftp
+#endif //LIBFTP_TIMEOUTS_HPP
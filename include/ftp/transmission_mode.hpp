@@ -1,7 +1,7 @@
 /*
  * MIT License
  *
- * Copyright (c) 2023 Denis Kovalchuk
+ * Copyright (c) 2024 Denis Kovalchuk
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -22,25 +22,23 @@
  * SOFTWARE.
  */
 
-#ifndef LIBFTP_BINARY_ISTREAM_HPP
-#define LIBFTP_BINARY_ISTREAM_HPP
+#ifndef LIBFTP_TRANSMISSION_MODE_HPP
+#define LIBFTP_TRANSMISSION_MODE_HPP
 
-#include <ftp/detail/export_internal.hpp>
-#include <ftp/stream/input_stream.hpp>
-
-namespace ftp::detail
+namespace ftp
 {
 
-class FTP_EXPORT_INTERNAL binary_istream : public input_stream
+enum class transmission_mode
 {
-public:
-    explicit binary_istream(input_stream & src);
-
-    std::size_t read(char *buf, std::size_t size) override;
-
-private:
-    input_stream & src_;
+    /* MODE S: the data is transmitted as a stream of bytes. */
+    stream = 0,
+    /* MODE Z: the data is compressed with deflate. */
+    zlib = 1,
+    /* MODE B: the data is sent in blocks, the data connection is kept
+     * open across transfers.
+     */
+    block = 2
 };
 
-} // namespace ftp::detail
-#endif //LIBFTP_BINARY_ISTREAM_HPP
+} // namespace ftp
+#endif //LIBFTP_TRANSMISSION_MODE_HPP
@@ -0,0 +1,258 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/async_logger.hpp>
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace ftp
+{
+
+async_logger::async_logger(output_stream & dst,
+                           format log_format,
+                           std::size_t capacity,
+                           std::chrono::milliseconds flush_interval)
+    : format_(log_format),
+      flush_interval_(flush_interval),
+      dst_(dst),
+      ring_(capacity),
+      dropped_count_(0),
+      truncated_count_(0),
+      buffer_(),
+      mutex_(),
+      writer_cv_(),
+      flushed_cv_(),
+      flush_target_(0),
+      flushed_count_(0),
+      stopping_(false),
+      error_(),
+      thread_(&async_logger::run, this)
+{
+}
+
+async_logger::~async_logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+
+    writer_cv_.notify_one();
+    thread_.join();
+}
+
+void async_logger::on_connected(std::string_view hostname, std::uint16_t port)
+{
+    std::string data = "Connected to ";
+    data += hostname;
+    data += " on port ";
+    data += std::to_string(port);
+    data += ".";
+
+    log(event_type::connected, data);
+}
+
+void async_logger::on_request(std::string_view command)
+{
+    /* Do not log user's password. */
+    if (command.compare(0, 4, "PASS") == 0)
+    {
+        log(event_type::request, "PASS *****");
+    }
+    else
+    {
+        log(event_type::request, command);
+    }
+}
+
+void async_logger::on_reply(const reply & reply)
+{
+    log(event_type::reply, reply.get_status_string());
+}
+
+void async_logger::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::uint64_t target = ring_.get_push_count();
+
+    flush_target_ = std::max(flush_target_, target);
+    writer_cv_.notify_one();
+
+    flushed_cv_.wait(lock, [this, target] { return flushed_count_ >= target; });
+
+    if (error_)
+    {
+        std::rethrow_exception(error_);
+    }
+}
+
+async_logger::format async_logger::get_format() const
+{
+    return format_;
+}
+
+std::uint64_t async_logger::get_dropped_count() const
+{
+    return dropped_count_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t async_logger::get_truncated_count() const
+{
+    return truncated_count_.load(std::memory_order_relaxed);
+}
+
+void async_logger::log(event_type type, std::string_view data)
+{
+    std::int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (!ring_.try_push(timestamp, static_cast<std::uint8_t>(type), data))
+    {
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (data.size() > max_event_size)
+    {
+        truncated_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void async_logger::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+        writer_cv_.wait_for(lock, flush_interval_, [this]
+        {
+            return stopping_ || flush_target_ > flushed_count_;
+        });
+
+        /* The producers do not stop before the destruction, take the last events after it. */
+        bool stopping = stopping_;
+
+        lock.unlock();
+        write_events();
+        lock.lock();
+
+        flushed_count_ = ring_.get_pop_count();
+        flushed_cv_.notify_all();
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+}
+
+void async_logger::write_events()
+{
+    detail::log_ring::record record;
+    std::uint64_t count = 0;
+
+    buffer_.clear();
+
+    while (ring_.try_pop(record))
+    {
+        format_event(record);
+        ++count;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    /* Only the writer thread sets the error. */
+    if (error_)
+    {
+        dropped_count_.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    try
+    {
+        dst_.write(buffer_.data(), buffer_.size());
+        dst_.flush();
+    }
+    catch (...)
+    {
+        dropped_count_.fetch_add(count, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+    }
+}
+
+void async_logger::format_event(const detail::log_ring::record & record)
+{
+    if (format_ == format::text)
+    {
+        auto type = static_cast<event_type>(record.type);
+
+        if (type == event_type::connected)
+        {
+            buffer_ += "-- ";
+        }
+        else if (type == event_type::request)
+        {
+            buffer_ += "-> ";
+        }
+        else if (type == event_type::reply)
+        {
+            buffer_ += "<- ";
+        }
+        else
+        {
+            assert(false);
+        }
+
+        buffer_.append(record.data, record.size);
+        buffer_ += '\n';
+    }
+    else if (format_ == format::binary)
+    {
+        auto timestamp = static_cast<std::uint64_t>(record.timestamp);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            buffer_ += static_cast<char>((timestamp >> (i * 8)) & 0xff);
+        }
+
+        buffer_ += static_cast<char>(record.type);
+        buffer_ += static_cast<char>(record.size & 0xff);
+        buffer_ += static_cast<char>(record.size >> 8);
+        buffer_.append(record.data, record.size);
+    }
+    else
+    {
+        assert(false);
+    }
+}
+
+} // namespace ftp
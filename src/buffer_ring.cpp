@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/buffer_ring.hpp>
+
+namespace ftp::detail
+{
+
+buffer_ring::buffer_ring(std::size_t buffer_size, std::size_t buffer_count)
+    : buffers_(buffer_count),
+      finished_(false),
+      closed_(false)
+{
+    for (buffer & buffer : buffers_)
+    {
+        buffer.data.resize(buffer_size);
+        free_.push_back(&buffer);
+    }
+}
+
+std::size_t buffer_ring::get_buffer_size() const
+{
+    return buffers_.front().data.size();
+}
+
+buffer_ring::buffer * buffer_ring::get_free()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    free_cv_.wait(lock, [this] { return closed_ || !free_.empty(); });
+
+    if (closed_)
+    {
+        return nullptr;
+    }
+
+    buffer *buffer = free_.front();
+    free_.pop_front();
+    buffer->size = 0;
+    return buffer;
+}
+
+void buffer_ring::put_free(buffer *buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        free_.push_back(buffer);
+    }
+
+    free_cv_.notify_all();
+}
+
+buffer_ring::buffer * buffer_ring::get_filled()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    filled_cv_.wait(lock, [this] { return closed_ || finished_ || !filled_.empty(); });
+
+    if (closed_ || filled_.empty())
+    {
+        return nullptr;
+    }
+
+    buffer *buffer = filled_.front();
+    filled_.pop_front();
+    return buffer;
+}
+
+void buffer_ring::put_filled(buffer *buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        filled_.push_back(buffer);
+    }
+
+    filled_cv_.notify_one();
+}
+
+void buffer_ring::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        finished_ = true;
+    }
+
+    filled_cv_.notify_all();
+}
+
+void buffer_ring::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        closed_ = true;
+    }
+
+    free_cv_.notify_all();
+    filled_cv_.notify_all();
+}
+
+void buffer_ring::wait_consumed()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    free_cv_.wait(lock, [this] { return closed_ || free_.size() == buffers_.size(); });
+}
+
+} // namespace ftp::detail
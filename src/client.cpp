@@ -23,14 +23,15 @@
  */
 
 #include <ftp/client.hpp>
+#include <ftp/error.hpp>
 #include <ftp/ftp_exception.hpp>
 #include <ftp/detail/ascii_istream.hpp>
 #include <ftp/detail/ascii_ostream.hpp>
-#include <ftp/detail/binary_istream.hpp>
-#include <ftp/detail/binary_ostream.hpp>
-#include <ftp/stream/ostream_adapter.hpp>
+#include <ftp/detail/counting_ostream.hpp>
+#include <ftp/stream/memory_output_stream.hpp>
 #include <ftp/detail/net_utils.hpp>
-#include <sstream>
+#include <ftp/detail/zlib_compressor.hpp>
+#include <thread>
 
 namespace ftp
 {
@@ -45,18 +46,85 @@ client::client(transfer_mode mode,
       transfer_type_(type),
       ssl_context_(std::move(ssl_context)),
       rfc2428_support_(rfc2428_support),
-      net_context_(),
-      control_connection_(net_context_)
+      resolver_(),
+      rate_limiter_(),
+      retry_policy_(),
+      transfer_buffer_size_(data_connection::default_buffer_size),
+      timeouts_(),
+      deadline_(),
+      control_socket_options_(),
+      data_socket_options_(),
+      transfer_hash_algorithm_(),
+      last_transfer_hash_algorithm_(),
+      last_transfer_hash_(),
+      selected_hash_algorithm_(),
+      hash_command_supported_(true),
+      transmission_mode_(transmission_mode::stream),
+      last_restart_marker_(),
+      hostname_(),
+      port_(0),
+      username_(),
+      password_(),
+      directory_commands_(),
+      urgent_abort_(false),
+      transfer_mutex_(),
+      active_connection_(nullptr),
+      abort_requested_(false),
+      thread_safe_(false),
+      stream_open_(false),
+      command_queue_(),
+      net_context_(std::make_shared<net_context>()),
+      control_connection_(*net_context_),
+      data_listener_(*net_context_),
+      data_connection_(),
+      observers_mutex_(),
+      observers_(std::make_shared<observer_list>())
 {
 }
 
 client::client(ssl::context_ptr && ssl_context)
+    : client(std::make_shared<net_context>(), std::move(ssl_context))
+{
+}
+
+client::client(net_context_ptr net_context, ssl::context_ptr && ssl_context)
     : transfer_mode_(transfer_mode::passive),
       transfer_type_(transfer_type::binary),
       ssl_context_(std::move(ssl_context)),
       rfc2428_support_(true),
-      net_context_(),
-      control_connection_(net_context_)
+      resolver_(),
+      rate_limiter_(),
+      retry_policy_(),
+      transfer_buffer_size_(data_connection::default_buffer_size),
+      timeouts_(),
+      deadline_(),
+      control_socket_options_(),
+      data_socket_options_(),
+      transfer_hash_algorithm_(),
+      last_transfer_hash_algorithm_(),
+      last_transfer_hash_(),
+      selected_hash_algorithm_(),
+      hash_command_supported_(true),
+      transmission_mode_(transmission_mode::stream),
+      last_restart_marker_(),
+      hostname_(),
+      port_(0),
+      username_(),
+      password_(),
+      directory_commands_(),
+      urgent_abort_(false),
+      transfer_mutex_(),
+      active_connection_(nullptr),
+      abort_requested_(false),
+      thread_safe_(false),
+      stream_open_(false),
+      command_queue_(),
+      net_context_(std::move(net_context)),
+      control_connection_(*net_context_),
+      data_listener_(*net_context_),
+      data_connection_(),
+      observers_mutex_(),
+      observers_(std::make_shared<observer_list>())
 {
 }
 
@@ -65,7 +133,23 @@ replies client::connect(std::string_view hostname,
                         const std::optional<std::string_view> & username,
                         std::string_view password)
 {
-    control_connection_.connect(hostname, port);
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    resolver_ptr resolver = resolver_ ? resolver_ : get_default_resolver();
+
+    control_connection_.connect(hostname, port, *resolver, control_socket_options_);
+
+    hostname_ = hostname;
+    port_ = port;
+
+    /* Reset the state of the previous session. */
+    username_ = std::nullopt;
+    password_.clear();
+    directory_commands_.clear();
+    selected_hash_algorithm_ = std::nullopt;
+    hash_command_supported_ = true;
+    transmission_mode_ = transmission_mode::stream;
+    reset_data_connection();
 
     notify_connected(hostname, port);
 
@@ -102,11 +186,15 @@ replies client::connect(std::string_view hostname,
 
 bool client::is_connected()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     return control_connection_.is_connected();
 }
 
 replies client::login(std::string_view username, std::string_view password)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     replies replies;
 
     process_login(username, password, replies);
@@ -116,10 +204,20 @@ replies client::login(std::string_view username, std::string_view password)
 
 reply client::logout()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("REIN");
 
     reply reply = process_command(command);
 
+    /* REIN resets the options of the HASH command and the transmission mode. */
+    username_ = std::nullopt;
+    password_.clear();
+    directory_commands_.clear();
+    selected_hash_algorithm_ = std::nullopt;
+    transmission_mode_ = transmission_mode::stream;
+    reset_data_connection();
+
     /* Switch the control connection to non-SSL mode. */
     if (reply.is_positive() && control_connection_.is_ssl())
     {
@@ -132,20 +230,45 @@ reply client::logout()
 
 reply client::change_current_directory(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("CWD", path);
 
-    return process_command(command);
+    reply reply = process_command(command);
+
+    if (reply.is_positive())
+    {
+        if (!path.empty() && path.front() == '/')
+        {
+            directory_commands_.clear();
+        }
+
+        directory_commands_.push_back(command);
+    }
+
+    return reply;
 }
 
 reply client::change_current_directory_up()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("CDUP");
 
-    return process_command(command);
+    reply reply = process_command(command);
+
+    if (reply.is_positive())
+    {
+        directory_commands_.push_back(command);
+    }
+
+    return reply;
 }
 
 reply client::get_current_directory()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("PWD");
 
     return process_command(command);
@@ -153,16 +276,42 @@ reply client::get_current_directory()
 
 replies client::download_file(output_stream & dst, std::string_view path, transfer_callback * transfer_cb)
 {
-    return process_download(dst, path, transfer_cb);
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_download(dst, path, std::nullopt, transfer_cb);
 }
 
 replies client::download_file(output_stream && dst, std::string_view path, transfer_callback * transfer_cb)
 {
-    return process_download(dst, path, transfer_cb);
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_download(dst, path, std::nullopt, transfer_cb);
+}
+
+replies client::resume_download(output_stream & dst,
+                                std::string_view path,
+                                std::string_view restart_marker,
+                                transfer_callback * transfer_cb)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_download(dst, path, restart_marker, transfer_cb);
+}
+
+replies client::resume_download(output_stream && dst,
+                                std::string_view path,
+                                std::string_view restart_marker,
+                                transfer_callback * transfer_cb)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_download(dst, path, restart_marker, transfer_cb);
 }
 
 replies client::upload_file(input_stream & src, std::string_view path, bool upload_unique, transfer_callback * transfer_cb)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string_view command;
 
     if (upload_unique)
@@ -174,11 +323,13 @@ replies client::upload_file(input_stream & src, std::string_view path, bool uplo
         command = "STOR";
     }
 
-    return process_upload(command, src, path, transfer_cb);
+    return process_upload(command, src, path, std::nullopt, transfer_cb);
 }
 
 replies client::upload_file(input_stream && src, std::string_view path, bool upload_unique, transfer_callback * transfer_cb)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string_view command;
 
     if (upload_unique)
@@ -190,21 +341,103 @@ replies client::upload_file(input_stream && src, std::string_view path, bool upl
         command = "STOR";
     }
 
-    return process_upload(command, src, path, transfer_cb);
+    return process_upload(command, src, path, std::nullopt, transfer_cb);
+}
+
+replies client::resume_upload(input_stream & src,
+                              std::string_view path,
+                              std::string_view restart_marker,
+                              transfer_callback * transfer_cb)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_upload("STOR", src, path, restart_marker, transfer_cb);
+}
+
+replies client::resume_upload(input_stream && src,
+                              std::string_view path,
+                              std::string_view restart_marker,
+                              transfer_callback * transfer_cb)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_upload("STOR", src, path, restart_marker, transfer_cb);
+}
+
+download_stream_ptr client::open_download(std::string_view path)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    /* The blocks would have to be parsed by the stream. */
+    if (transmission_mode_ == transmission_mode::block)
+    {
+        throw ftp_exception("Cannot open download stream: block transmission mode is not supported.");
+    }
+
+    reset_abort();
+
+    replies replies;
+
+    last_transfer_hash_ = std::nullopt;
+    last_restart_marker_ = std::nullopt;
+
+    std::string command = make_command("RETR", path);
+
+    data_connection_ptr connection = create_data_connection(command, replies);
+
+    return download_stream_ptr(new download_stream(*this, std::move(lock), std::move(connection), std::move(replies)));
+}
+
+upload_stream_ptr client::open_upload(std::string_view path, bool upload_unique)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    /* The blocks would have to be framed by the stream. */
+    if (transmission_mode_ == transmission_mode::block)
+    {
+        throw ftp_exception("Cannot open upload stream: block transmission mode is not supported.");
+    }
+
+    reset_abort();
+
+    replies replies;
+
+    last_transfer_hash_ = std::nullopt;
+
+    std::string command;
+
+    if (upload_unique)
+    {
+        command = make_command("STOU", path);
+    }
+    else
+    {
+        command = make_command("STOR", path);
+    }
+
+    data_connection_ptr connection = create_data_connection(command, replies);
+
+    return upload_stream_ptr(new upload_stream(*this, std::move(lock), std::move(connection), std::move(replies)));
 }
 
 replies client::append_file(input_stream & src, std::string_view path, transfer_callback * transfer_cb)
 {
-    return process_upload("APPE", src, path, transfer_cb);
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_upload("APPE", src, path, std::nullopt, transfer_cb);
 }
 
 replies client::append_file(input_stream && src, std::string_view path, transfer_callback * transfer_cb)
 {
-    return process_upload("APPE", src, path, transfer_cb);
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return process_upload("APPE", src, path, std::nullopt, transfer_cb);
 }
 
 file_list_reply client::get_file_list(const std::optional<std::string_view> & path, bool only_names)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command;
 
     if (only_names)
@@ -222,17 +455,15 @@ file_list_reply client::get_file_list(const std::optional<std::string_view> & pa
     data_connection_ptr connection = create_data_connection(command, replies);
     if (connection)
     {
-        std::ostringstream oss;
-        ostream_adapter adapter(oss);
-        output_stream_ptr stream = create_output_stream(adapter);
+        memory_output_stream buffer;
+        output_stream_ptr stream = create_output_stream(buffer);
 
-        connection->recv(*stream, nullptr);
+        connection->recv(stream ? *stream : buffer, nullptr);
 
-        file_list = oss.str();
+        file_list = buffer.release();
         notify_file_list(file_list);
 
-        connection->disconnect();
-        recv(replies);
+        finish_data_connection(std::move(connection), replies);
     }
 
     return { replies, file_list };
@@ -240,6 +471,8 @@ file_list_reply client::get_file_list(const std::optional<std::string_view> & pa
 
 replies client::rename(std::string_view from_path, std::string_view to_path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     replies replies;
 
     std::string command = make_command("RNFR", from_path);
@@ -259,6 +492,8 @@ replies client::rename(std::string_view from_path, std::string_view to_path)
 
 reply client::remove_file(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("DELE", path);
 
     return process_command(command);
@@ -266,6 +501,8 @@ reply client::remove_file(std::string_view path)
 
 reply client::create_directory(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("MKD", path);
 
     return process_command(command);
@@ -273,6 +510,8 @@ reply client::create_directory(std::string_view path)
 
 reply client::remove_directory(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("RMD", path);
 
     return process_command(command);
@@ -280,6 +519,8 @@ reply client::remove_directory(std::string_view path)
 
 file_size_reply client::get_file_size(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("SIZE", path);
 
     reply reply = process_command(command);
@@ -289,6 +530,8 @@ file_size_reply client::get_file_size(std::string_view path)
 
 file_modified_time_reply client::get_file_modified_time(std::string_view path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("MDTM", path);
 
     reply reply = process_command(command);
@@ -296,8 +539,87 @@ file_modified_time_reply client::get_file_modified_time(std::string_view path)
     return file_modified_time_reply(reply);
 }
 
+file_hash_reply client::get_file_hash(std::string_view path, hash_algorithm algorithm)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    std::string command;
+    reply reply;
+
+    if (hash_command_supported_ && selected_hash_algorithm_ != algorithm)
+    {
+        /* Select the algorithm of the HASH command. */
+        command = make_command("OPTS", "HASH " + std::string(hasher::get_name(algorithm)));
+
+        reply = process_command(command);
+
+        if (reply.is_positive())
+        {
+            selected_hash_algorithm_ = algorithm;
+        }
+        else if (reply.get_code() == 500 || reply.get_code() == 502)
+        {
+            /* 500 Syntax error, command unrecognized.
+             * 502 Command not implemented.
+             */
+            hash_command_supported_ = false;
+        }
+    }
+
+    if (hash_command_supported_ && selected_hash_algorithm_ == algorithm)
+    {
+        command = make_command("HASH", path);
+
+        reply = process_command(command);
+
+        if (reply.get_code() != 500 && reply.get_code() != 502)
+        {
+            return { reply, algorithm };
+        }
+
+        hash_command_supported_ = false;
+    }
+
+    /* Fall back to the legacy command of the algorithm. */
+    command = make_command(hasher::get_legacy_command(algorithm), path);
+
+    reply = process_command(command);
+
+    return { reply, algorithm };
+}
+
+bool client::verify_file(std::string_view path)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    if (!last_transfer_hash_ || !last_transfer_hash_algorithm_)
+    {
+        throw ftp_exception("Cannot verify file. The transfer hash is not available.");
+    }
+
+    return verify_file(path, last_transfer_hash_algorithm_.value(), last_transfer_hash_.value());
+}
+
+bool client::verify_file(std::string_view path, hash_algorithm algorithm, std::string_view expected_hash)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    file_hash_reply reply = get_file_hash(path, algorithm);
+
+    const std::optional<std::string> & hash = reply.get_hash();
+
+    if (!hash)
+    {
+        return false;
+    }
+
+    return utils::equals_ignore_case(hash.value(), expected_hash);
+}
+
 reply client::get_status(const std::optional<std::string_view> & path)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("STAT", path);
 
     return process_command(command);
@@ -305,6 +627,8 @@ reply client::get_status(const std::optional<std::string_view> & path)
 
 reply client::get_system_type()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("SYST");
 
     return process_command(command);
@@ -312,13 +636,28 @@ reply client::get_system_type()
 
 reply client::get_help(const std::optional<std::string_view> & remote_command)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("HELP", remote_command);
 
     return process_command(command);
 }
 
+features_reply client::get_features()
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    std::string command = make_command("FEAT");
+
+    reply reply = process_command(command);
+
+    return features_reply(reply);
+}
+
 reply client::get_site_commands()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("SITE", "HELP");
 
     return process_command(command);
@@ -326,6 +665,8 @@ reply client::get_site_commands()
 
 reply client::send_site_command(std::string_view remote_command)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("SITE", remote_command);
 
     return process_command(command);
@@ -333,6 +674,8 @@ reply client::send_site_command(std::string_view remote_command)
 
 reply client::send_noop()
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_command("NOOP");
 
     return process_command(command);
@@ -340,8 +683,12 @@ reply client::send_noop()
 
 std::optional<reply> client::disconnect(bool graceful)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::optional<reply> reply;
 
+    reset_data_connection();
+
     if (graceful)
     {
         std::string command = make_command("QUIT");
@@ -361,6 +708,8 @@ std::optional<reply> client::disconnect(bool graceful)
         control_connection_.disconnect();
     }
 
+    data_listener_.close();
+
     /* Switch the control connection to non-SSL mode. */
     if (control_connection_.is_ssl())
     {
@@ -370,18 +719,50 @@ std::optional<reply> client::disconnect(bool graceful)
     return reply;
 }
 
+void client::abort_transfer()
+{
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+    abort_requested_ = true;
+
+    if (active_connection_)
+    {
+        active_connection_->interrupt();
+    }
+}
+
+void client::set_urgent_abort(bool urgent_abort)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    urgent_abort_ = urgent_abort;
+}
+
+bool client::get_urgent_abort() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return urgent_abort_;
+}
+
 void client::set_transfer_mode(transfer_mode mode)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     transfer_mode_ = mode;
 }
 
 transfer_mode client::get_transfer_mode() const
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     return transfer_mode_;
 }
 
 reply client::set_transfer_type(transfer_type type)
 {
+    std::unique_lock<command_queue> lock = lock_commands();
+
     std::string command = make_type_command(type);
 
     reply reply = process_command(command);
@@ -394,46 +775,340 @@ reply client::set_transfer_type(transfer_type type)
     return reply;
 }
 
-std::string client::make_type_command(transfer_type type)
+std::string client::make_type_command(transfer_type type)
+{
+    if (type == transfer_type::binary)
+    {
+        return make_command("TYPE", "I");
+    }
+    else if (type == transfer_type::ascii)
+    {
+        return make_command("TYPE", "A");
+    }
+    else
+    {
+        assert(false);
+        return "";
+    }
+}
+
+transfer_type client::get_transfer_type() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return transfer_type_;
+}
+
+reply client::set_transmission_mode(transmission_mode mode)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    if (mode == transmission_mode::zlib && !zlib_compressor::is_available())
+    {
+        throw ftp_exception("MODE Z is not supported. The library is built without zlib.");
+    }
+
+    std::string command = make_mode_command(mode);
+
+    reply reply = process_command(command);
+
+    if (reply.is_positive())
+    {
+        transmission_mode_ = mode;
+
+        /* The server closes the data connection kept open in block mode. */
+        reset_data_connection();
+    }
+
+    return reply;
+}
+
+std::string client::make_mode_command(transmission_mode mode)
+{
+    if (mode == transmission_mode::stream)
+    {
+        return make_command("MODE", "S");
+    }
+    else if (mode == transmission_mode::zlib)
+    {
+        return make_command("MODE", "Z");
+    }
+    else if (mode == transmission_mode::block)
+    {
+        return make_command("MODE", "B");
+    }
+    else
+    {
+        assert(false);
+        return "";
+    }
+}
+
+transmission_mode client::get_transmission_mode() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return transmission_mode_;
+}
+
+std::optional<std::string> client::get_last_restart_marker() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return last_restart_marker_;
+}
+
+void client::add_observer(std::shared_ptr<observer> observer)
+{
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+
+    auto observers = std::make_shared<observer_list>(*observers_);
+    observers->emplace_back(observer);
+    observers_ = std::move(observers);
+}
+
+void client::remove_observer(std::shared_ptr<observer> observer)
+{
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+
+    auto observers = std::make_shared<observer_list>(*observers_);
+    observers->remove(observer);
+    observers_ = std::move(observers);
+}
+
+void client::set_rfc2428_support(bool support)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    rfc2428_support_ = support;
+}
+
+bool client::get_rfc2428_support() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return rfc2428_support_;
+}
+
+void client::set_active_port_range(std::uint16_t first_port, std::uint16_t last_port)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    data_listener_.set_port_range(first_port, last_port);
+}
+
+std::pair<std::uint16_t, std::uint16_t> client::get_active_port_range() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return data_listener_.get_port_range();
+}
+
+void client::set_active_listen_backlog(int backlog)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    data_listener_.set_backlog(backlog);
+}
+
+int client::get_active_listen_backlog() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return data_listener_.get_backlog();
+}
+
+void client::set_transfer_hash_algorithm(const std::optional<hash_algorithm> & algorithm)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    transfer_hash_algorithm_ = algorithm;
+}
+
+std::optional<hash_algorithm> client::get_transfer_hash_algorithm() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return transfer_hash_algorithm_;
+}
+
+std::optional<std::string> client::get_last_transfer_hash() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return last_transfer_hash_;
+}
+
+void client::set_resolver(resolver_ptr resolver)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    resolver_ = std::move(resolver);
+}
+
+resolver_ptr client::get_resolver() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return resolver_;
+}
+
+void client::set_rate_limiter(rate_limiter_ptr rate_limiter)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    rate_limiter_ = std::move(rate_limiter);
+}
+
+rate_limiter_ptr client::get_rate_limiter() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return rate_limiter_;
+}
+
+void client::set_transfer_buffer_size(std::size_t size)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    if (size == 0)
+    {
+        throw ftp_exception("Invalid transfer buffer size.");
+    }
+
+    transfer_buffer_size_ = size;
+}
+
+std::size_t client::get_transfer_buffer_size() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return transfer_buffer_size_;
+}
+
+void client::set_retry_policy(retry_policy_ptr retry_policy)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    retry_policy_ = std::move(retry_policy);
+}
+
+retry_policy_ptr client::get_retry_policy() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return retry_policy_;
+}
+
+void client::set_timeouts(const timeouts & timeouts)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    timeouts_ = timeouts;
+    control_connection_.set_timeouts(timeouts_, deadline_);
+}
+
+timeouts client::get_timeouts() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return timeouts_;
+}
+
+void client::set_deadline(const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    deadline_ = deadline;
+    control_connection_.set_timeouts(timeouts_, deadline_);
+}
+
+std::optional<std::chrono::steady_clock::time_point> client::get_deadline() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return deadline_;
+}
+
+void client::set_control_socket_options(const socket_options & options)
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    control_socket_options_ = options;
+}
+
+socket_options client::get_control_socket_options() const
+{
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return control_socket_options_;
+}
+
+void client::set_data_socket_options(const socket_options & options)
 {
-    if (type == transfer_type::binary)
-    {
-        return make_command("TYPE", "I");
-    }
-    else if (type == transfer_type::ascii)
-    {
-        return make_command("TYPE", "A");
-    }
-    else
-    {
-        assert(false);
-        return "";
-    }
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    data_listener_.set_socket_options(options);
+    data_socket_options_ = options;
 }
 
-transfer_type client::get_transfer_type() const
+socket_options client::get_data_socket_options() const
 {
-    return transfer_type_;
+    std::unique_lock<command_queue> lock = lock_commands();
+
+    return data_socket_options_;
 }
 
-void client::add_observer(std::shared_ptr<observer> observer)
+void client::set_thread_safe(bool thread_safe)
 {
-    observers_.emplace_back(observer);
+    thread_safe_ = thread_safe;
 }
 
-void client::remove_observer(std::shared_ptr<observer> observer)
+bool client::is_thread_safe() const
 {
-    observers_.remove(observer);
+    return thread_safe_;
 }
 
-void client::set_rfc2428_support(bool support)
+std::unique_lock<command_queue> client::lock_commands() const
 {
-    rfc2428_support_ = support;
+    std::unique_lock<command_queue> lock;
+
+    if (thread_safe_)
+    {
+        lock = std::unique_lock<command_queue>(command_queue_);
+    }
+
+    /* The control connection is in the middle of the transfer of the stream.
+     * The lock is recursive, so this is a call from the thread of the stream.
+     */
+    if (stream_open_)
+    {
+        throw ftp_exception("Cannot run command. A download or upload stream is open, close it first.");
+    }
+
+    return lock;
 }
 
-bool client::get_rfc2428_support() const
+/* Unless the data connection has a local address of its own, it is opened from
+ * the local address of the control connection: servers reject data connections
+ * from an address other than the one of the control connection.
+ */
+socket_options client::make_data_socket_options() const
 {
-    return rfc2428_support_;
+    socket_options options = data_socket_options_;
+
+    if (!options.local_address && !options.local_address_pool &&
+        (control_socket_options_.local_address || control_socket_options_.local_address_pool))
+    {
+        options.local_address = control_connection_.get_local_endpoint().address();
+    }
+
+    if (!options.bind_device)
+    {
+        options.bind_device = control_socket_options_.bind_device;
+    }
+
+    return options;
 }
 
 void client::send(std::string_view command)
@@ -496,6 +1171,11 @@ reply client::process_login(std::string_view username, std::string_view password
         return reply;
     }
 
+    /* The login starts in the home directory. */
+    username_ = username;
+    password_ = password;
+    directory_commands_.clear();
+
     /* Set the SSL settings. */
     if (ssl_context_)
     {
@@ -522,20 +1202,152 @@ reply client::process_login(std::string_view username, std::string_view password
     return reply;
 }
 
-replies client::process_download(output_stream & dst, std::string_view path, transfer_callback * transfer_cb)
+replies client::process_download(output_stream & dst,
+                                 std::string_view path,
+                                 const std::optional<std::string_view> & restart_marker,
+                                 transfer_callback * transfer_cb)
+{
+    reset_abort();
+
+    if (!retry_policy_)
+    {
+        return process_download_attempt(dst, path, restart_marker, transfer_cb);
+    }
+
+    /* The offset the download is resumed from, if the restart marker is a byte offset. */
+    std::optional<std::uint64_t> offset = 0;
+
+    if (restart_marker)
+    {
+        std::uint64_t value;
+
+        offset = utils::try_parse_uint64(restart_marker.value(), value) ? std::optional<std::uint64_t>(value)
+                                                                        : std::nullopt;
+    }
+
+    counting_ostream counter(dst);
+    bool reconnect_required = false;
+
+    for (std::size_t attempt = 1;; attempt++)
+    {
+        std::optional<std::chrono::milliseconds> delay;
+        std::uint64_t written = counter.get_size();
+
+        /* The data written by the failed attempts is not downloaded again. */
+        std::optional<std::string> marker;
+
+        if (written == 0)
+        {
+            marker = restart_marker;
+        }
+        else if (offset && transfer_type_ == transfer_type::binary)
+        {
+            marker = std::to_string(offset.value() + written);
+        }
+
+        bool resumable = written == 0 || marker;
+
+        try
+        {
+            if (reconnect_required)
+            {
+                reconnect();
+            }
+
+            replies replies = process_download_attempt(counter, path, marker, transfer_cb);
+
+            if (replies.is_positive() || is_abort_requested() || (transfer_cb && transfer_cb->is_cancelled()))
+            {
+                /* The hash covers only the data of the last attempt. */
+                if (written > 0)
+                {
+                    last_transfer_hash_ = std::nullopt;
+                }
+
+                return replies;
+            }
+
+            delay = retry_policy_->get_retry_delay(attempt, replies.get_replies().back(), boost::system::error_code());
+
+            if (!delay || !resumable)
+            {
+                return replies;
+            }
+
+            /* For example, 421 Service not available, closing control connection. */
+            reconnect_required = !control_connection_.is_connected();
+        }
+        catch (const ftp_exception & ex)
+        {
+            if (is_abort_requested())
+            {
+                throw;
+            }
+
+            delay = retry_policy_->get_retry_delay(attempt, std::nullopt, ex.get_error_code());
+
+            if (!delay || !resumable)
+            {
+                throw;
+            }
+
+            /* The state of the session is unknown after an error. */
+            reconnect_required = true;
+        }
+
+        if (deadline_ && std::chrono::steady_clock::now() + delay.value() >= deadline_.value())
+        {
+            throw ftp_exception(make_error_code(error::deadline_exceeded), "Cannot retry download");
+        }
+
+        std::this_thread::sleep_for(delay.value());
+    }
+}
+
+replies client::process_download_attempt(output_stream & dst,
+                                         std::string_view path,
+                                         const std::optional<std::string_view> & restart_marker,
+                                         transfer_callback * transfer_cb)
 {
     replies replies;
 
+    last_transfer_hash_ = std::nullopt;
+    last_restart_marker_ = std::nullopt;
+
+    if (restart_marker)
+    {
+        std::string command = make_command("REST", restart_marker);
+
+        reply reply = process_command(command, replies);
+
+        /* 350 Requested file action pending further information. */
+        if (reply.get_code() != 350)
+        {
+            return replies;
+        }
+    }
+
     std::string command = make_command("RETR", path);
 
     data_connection_ptr connection = create_data_connection(command, replies);
     if (connection)
     {
         output_stream_ptr stream = create_output_stream(dst);
+        hasher_ptr hasher = create_transfer_hasher(restart_marker);
+
+        bool aborted = run_transfer(*connection, [&]()
+        {
+            connection->recv(stream ? *stream : dst, transfer_cb, hasher.get(), &last_restart_marker_);
+        });
 
-        connection->recv(*stream, transfer_cb);
+        if (aborted)
+        {
+            /* The data connection is shut down already. */
+            connection->close();
 
-        if (transfer_cb && transfer_cb->is_cancelled())
+            process_abort(replies, true);
+        }
+        else if (transfer_cb && transfer_cb->is_cancelled())
         {
             process_abort(replies);
 
@@ -544,28 +1356,110 @@ replies client::process_download(output_stream & dst, std::string_view path, tra
         }
         else
         {
-            connection->disconnect();
-            recv(replies);
+            finish_data_connection(std::move(connection), replies);
+
+            finish_transfer_hash(hasher.get(), replies);
         }
     }
 
     return replies;
 }
 
-replies client::process_upload(std::string_view remote_command, input_stream & src, std::string_view path, transfer_callback * transfer_cb)
+void client::reconnect()
+{
+    std::optional<std::string> username = username_;
+    std::string password = password_;
+    std::vector<std::string> directory_commands = directory_commands_;
+    transmission_mode mode = transmission_mode_;
+
+    if (control_connection_.is_connected())
+    {
+        try
+        {
+            disconnect(false);
+        }
+        catch (const ftp_exception &)
+        {
+            /* The connection is broken anyway. */
+        }
+    }
+
+    replies replies = connect(hostname_, port_, username, password);
+
+    if (!replies.is_positive())
+    {
+        throw ftp_exception("Cannot reconnect: '%1%'.", replies.get_status_string());
+    }
+
+    for (const std::string & command : directory_commands)
+    {
+        reply reply = process_command(command);
+
+        if (reply.is_negative())
+        {
+            throw ftp_exception("Cannot restore working directory: '%1%'.", reply.get_status_string());
+        }
+
+        directory_commands_.push_back(command);
+    }
+
+    if (mode != transmission_mode::stream)
+    {
+        reply reply = set_transmission_mode(mode);
+
+        if (reply.is_negative())
+        {
+            throw ftp_exception("Cannot restore transmission mode: '%1%'.", reply.get_status_string());
+        }
+    }
+}
+
+replies client::process_upload(std::string_view remote_command,
+                               input_stream & src,
+                               std::string_view path,
+                               const std::optional<std::string_view> & restart_marker,
+                               transfer_callback * transfer_cb)
 {
     replies replies;
 
+    reset_abort();
+
+    last_transfer_hash_ = std::nullopt;
+
+    if (restart_marker)
+    {
+        std::string command = make_command("REST", restart_marker);
+
+        reply reply = process_command(command, replies);
+
+        /* 350 Requested file action pending further information. */
+        if (reply.get_code() != 350)
+        {
+            return replies;
+        }
+    }
+
     std::string command = make_command(remote_command, path);
 
     data_connection_ptr connection = create_data_connection(command, replies);
     if (connection)
     {
         input_stream_ptr stream = create_input_stream(src);
+        hasher_ptr hasher = create_transfer_hasher(restart_marker);
 
-        connection->send(*stream, transfer_cb);
+        bool aborted = run_transfer(*connection, [&]()
+        {
+            connection->send(stream ? *stream : src, transfer_cb, hasher.get());
+        });
+
+        if (aborted)
+        {
+            /* The data connection is shut down already. */
+            connection->close();
 
-        if (transfer_cb && transfer_cb->is_cancelled())
+            process_abort(replies, true);
+        }
+        else if (transfer_cb && transfer_cb->is_cancelled())
         {
             process_abort(replies);
 
@@ -574,27 +1468,45 @@ replies client::process_upload(std::string_view remote_command, input_stream & s
         }
         else
         {
-            connection->disconnect();
-            recv(replies);
+            finish_data_connection(std::move(connection), replies);
+
+            finish_transfer_hash(hasher.get(), replies);
         }
     }
 
     return replies;
 }
 
-reply client::process_abort(replies & replies)
+reply client::process_abort(replies & replies, bool data_connection_closed)
 {
+    std::string command = make_command("ABOR");
+
     /* RFC 959 requires sending Telnet IP/Synch sequence as OOB data before
-     * aborting, but since many ftp servers do not handle it correctly, we
-     * ignore this requirement.
+     * aborting, but since many ftp servers do not handle it correctly, it is
+     * sent only if enabled. The urgent data would break the TLS stream.
      */
+    if (urgent_abort_ && !control_connection_.is_ssl())
+    {
+        notify_request(command);
 
-    std::string command = make_command("ABOR");
+        /* IAC IP IAC, the last byte is the urgent one. */
+        control_connection_.send_urgent("\xFF\xF4\xFF");
 
-    reply reply = process_command(command, replies);
+        /* DM completes the Synch. */
+        control_connection_.send("\xF2" + command);
+    }
+    else
+    {
+        send(command);
+    }
+
+    reply reply = recv(replies);
 
-    /* 426 Connection closed; transfer aborted. */
-    if (reply.get_code() == 426)
+    /* 426 Connection closed; transfer aborted.
+     * If the data connection is closed before ABOR, the server completes
+     * the transfer on its own, ABOR is replied to after it.
+     */
+    if (reply.get_code() == 426 || data_connection_closed)
     {
         reply = recv(replies);
     }
@@ -602,18 +1514,84 @@ reply client::process_abort(replies & replies)
     return reply;
 }
 
+bool client::run_transfer(data_connection & connection, const std::function<void()> & transfer)
+{
+    set_active_connection(&connection);
+
+    try
+    {
+        transfer();
+    }
+    catch (const ftp_exception &)
+    {
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+        active_connection_ = nullptr;
+
+        /* The interrupted socket fails the transfer. */
+        if (abort_requested_)
+        {
+            return true;
+        }
+
+        throw;
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+        active_connection_ = nullptr;
+
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+    active_connection_ = nullptr;
+
+    return abort_requested_;
+}
+
+void client::set_active_connection(data_connection * connection)
+{
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+    active_connection_ = connection;
+
+    /* Aborted while the data connection was being opened. */
+    if (connection && abort_requested_)
+    {
+        connection->interrupt();
+    }
+}
+
+void client::reset_abort()
+{
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+    abort_requested_ = false;
+}
+
+bool client::is_abort_requested()
+{
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+
+    return abort_requested_;
+}
+
 input_stream_ptr client::create_input_stream(input_stream & src)
 {
+    /* Binary data is read straight from the source stream. */
     if (transfer_type_ == transfer_type::binary)
     {
-        return std::make_unique<binary_istream>(src);
+        return nullptr;
     }
     else if (transfer_type_ == transfer_type::ascii)
     {
 #ifdef _WIN32
         /* There is no difference between ascii and binary data transfer types
            on the Windows platform. */
-        return std::make_unique<binary_istream>(src);
+        return nullptr;
 #else
         return std::make_unique<ascii_istream>(src);
 #endif
@@ -627,16 +1605,17 @@ input_stream_ptr client::create_input_stream(input_stream & src)
 
 output_stream_ptr client::create_output_stream(output_stream & dst)
 {
+    /* Binary data is written straight to the destination stream. */
     if (transfer_type_ == transfer_type::binary)
     {
-        return std::make_unique<binary_ostream>(dst);
+        return nullptr;
     }
     else if (transfer_type_ == transfer_type::ascii)
     {
 #ifdef _WIN32
         /* There is no difference between ascii and binary data transfer types
            on the Windows platform. */
-        return std::make_unique<binary_ostream>(dst);
+        return nullptr;
 #else
         return std::make_unique<ascii_ostream>(dst);
 #endif
@@ -650,35 +1629,135 @@ output_stream_ptr client::create_output_stream(output_stream & dst)
 
 data_connection_ptr client::create_data_connection(std::string_view command, replies & replies)
 {
+    if (data_connection_)
+    {
+        /* Reuse the data connection kept open in block mode. */
+        reply reply = process_command(command, replies);
+
+        if (reply.get_code() == 425)
+        {
+            /* 425 Can't open data connection.
+             * The server has closed the data connection, open a new one.
+             */
+            reset_data_connection();
+        }
+        else if (reply.is_negative())
+        {
+            return nullptr;
+        }
+        else
+        {
+            data_connection_->set_rate_limiter(rate_limiter_);
+            data_connection_->set_buffer_size(transfer_buffer_size_);
+            data_connection_->set_timeouts(timeouts_, deadline_);
+            return std::move(data_connection_);
+        }
+    }
+
+    data_connection_ptr connection;
+
     if (transfer_mode_ == transfer_mode::passive)
     {
         if (rfc2428_support_)
         {
-            return process_epsv_command(command, replies);
+            connection = process_epsv_command(command, replies);
         }
         else
         {
-            return process_pasv_command(command, replies);
+            connection = process_pasv_command(command, replies);
         }
     }
     else if (transfer_mode_ == transfer_mode::active)
     {
         if (rfc2428_support_)
         {
-            return process_eprt_command(command, replies);
+            connection = process_eprt_command(command, replies);
         }
         else
         {
-            return process_port_command(command, replies);
+            connection = process_port_command(command, replies);
         }
     }
     else
     {
         assert(false);
+    }
+
+    if (connection)
+    {
+        connection->set_transmission_mode(transmission_mode_);
+        connection->set_rate_limiter(rate_limiter_);
+        connection->set_buffer_size(transfer_buffer_size_);
+    }
+
+    return connection;
+}
+
+void client::finish_data_connection(data_connection_ptr connection, replies & replies)
+{
+    if (transmission_mode_ == transmission_mode::block)
+    {
+        /* In block mode the end of file is marked by the EOF block, so the final
+         * reply is received without closing the data connection.
+         */
+        reply reply = recv(replies);
+
+        /* 250 Requested file action okay, completed.
+         * The server keeps the data connection open for the next transfer.
+         */
+        if (reply.get_code() == 250)
+        {
+            data_connection_ = std::move(connection);
+        }
+        else
+        {
+            connection->disconnect();
+        }
+    }
+    else
+    {
+        connection->disconnect();
+        recv(replies);
+    }
+}
+
+void client::reset_data_connection()
+{
+    /* Close the data connection kept open in block mode. The transfer is complete,
+     * so the connection is closed without the shutdown.
+     */
+    data_connection_.reset();
+}
+
+hasher_ptr client::create_transfer_hasher(const std::optional<std::string_view> & restart_marker)
+{
+    /* The hash of a resumed transfer covers only its tail, in the ASCII transfer
+     * type it covers the converted data. Neither is the hash of the remote file.
+     */
+    if (restart_marker || transfer_type_ == transfer_type::ascii)
+    {
+        return nullptr;
+    }
+
+    if (transfer_hash_algorithm_)
+    {
+        return std::make_unique<hasher>(transfer_hash_algorithm_.value());
+    }
+    else
+    {
         return nullptr;
     }
 }
 
+void client::finish_transfer_hash(hasher * hasher, const replies & replies)
+{
+    if (hasher && replies.is_positive())
+    {
+        last_transfer_hash_ = hasher->finish();
+        last_transfer_hash_algorithm_ = transfer_hash_algorithm_;
+    }
+}
+
 void client::ssl_handshake_data_connection(data_connection & connection, ssl::context & ssl_context)
 {
     SSL_SESSION *ssl_session;
@@ -722,7 +1801,9 @@ data_connection_ptr client::process_epsv_command(std::string_view command, repli
     boost::asio::ip::tcp::endpoint remote_endpoint = control_connection_.get_remote_endpoint();
     boost::asio::ip::tcp::endpoint endpoint(remote_endpoint.address(), remote_port);
 
-    data_connection_ptr connection = std::make_unique<data_connection>(net_context_);
+    data_connection_ptr connection = std::make_unique<data_connection>(*net_context_);
+    connection->set_socket_options(make_data_socket_options());
+    connection->set_timeouts(timeouts_, deadline_);
     connection->connect(endpoint);
 
     /* Process the main command. */
@@ -787,11 +1868,7 @@ data_connection_ptr client::process_eprt_command(std::string_view command, repli
 {
     /* Start to listen. */
     boost::asio::ip::tcp::endpoint local_endpoint = control_connection_.get_local_endpoint();
-    boost::asio::ip::tcp::endpoint listen_endpoint(local_endpoint.address(), 0);
-
-    data_connection_ptr connection = std::make_unique<data_connection>(net_context_);
-    connection->listen(listen_endpoint);
-    listen_endpoint = connection->get_listen_endpoint();
+    boost::asio::ip::tcp::endpoint listen_endpoint = data_listener_.listen(local_endpoint.address());
 
     /* Process the EPRT command. */
     std::string eprt_command = make_eprt_command(listen_endpoint);
@@ -811,8 +1888,11 @@ data_connection_ptr client::process_eprt_command(std::string_view command, repli
         return nullptr;
     }
 
-    /* Accept an incoming data connection. */
-    connection->accept();
+    /* Accept an incoming data connection from the server. */
+    data_connection_ptr connection = std::make_unique<data_connection>(*net_context_);
+    connection->set_socket_options(make_data_socket_options());
+    connection->set_timeouts(timeouts_, deadline_);
+    data_listener_.accept(*connection, control_connection_.get_remote_endpoint().address());
 
     if (ssl_context_)
     {
@@ -872,7 +1952,9 @@ data_connection_ptr client::process_pasv_command(std::string_view command, repli
     }
 
     /* Open the data connection. */
-    data_connection_ptr connection = std::make_unique<data_connection>(net_context_);
+    data_connection_ptr connection = std::make_unique<data_connection>(*net_context_);
+    connection->set_socket_options(make_data_socket_options());
+    connection->set_timeouts(timeouts_, deadline_);
     connection->connect(remote_ip, remote_port);
 
     /* Process the main command. */
@@ -966,11 +2048,7 @@ data_connection_ptr client::process_port_command(std::string_view command, repli
 {
     /* Start to listen. */
     boost::asio::ip::tcp::endpoint local_endpoint = control_connection_.get_local_endpoint();
-    boost::asio::ip::tcp::endpoint listen_endpoint(local_endpoint.address(), 0);
-
-    data_connection_ptr connection = std::make_unique<data_connection>(net_context_);
-    connection->listen(listen_endpoint);
-    listen_endpoint = connection->get_listen_endpoint();
+    boost::asio::ip::tcp::endpoint listen_endpoint = data_listener_.listen(local_endpoint.address());
 
     /* Process the PORT command. */
     std::string port_command = make_port_command(listen_endpoint);
@@ -990,8 +2068,11 @@ data_connection_ptr client::process_port_command(std::string_view command, repli
         return nullptr;
     }
 
-    /* Accept an incoming data connection. */
-    connection->accept();
+    /* Accept an incoming data connection from the server. */
+    data_connection_ptr connection = std::make_unique<data_connection>(*net_context_);
+    connection->set_socket_options(make_data_socket_options());
+    connection->set_timeouts(timeouts_, deadline_);
+    data_listener_.accept(*connection, control_connection_.get_remote_endpoint().address());
 
     if (ssl_context_)
     {
@@ -1039,9 +2120,16 @@ std::string client::make_command(std::string_view command, const std::optional<s
     return result;
 }
 
+std::shared_ptr<const client::observer_list> client::get_observers() const
+{
+    std::lock_guard<std::mutex> lock(observers_mutex_);
+
+    return observers_;
+}
+
 void client::notify_connected(std::string_view hostname, std::uint16_t port)
 {
-    for (const std::shared_ptr<observer> & observer : observers_)
+    for (const std::shared_ptr<observer> & observer : *get_observers())
     {
         observer->on_connected(hostname, port);
     }
@@ -1049,7 +2137,7 @@ void client::notify_connected(std::string_view hostname, std::uint16_t port)
 
 void client::notify_request(std::string_view command)
 {
-    for (const std::shared_ptr<observer> & observer : observers_)
+    for (const std::shared_ptr<observer> & observer : *get_observers())
     {
         observer->on_request(command);
     }
@@ -1057,7 +2145,7 @@ void client::notify_request(std::string_view command)
 
 void client::notify_reply(const reply & reply)
 {
-    for (const std::shared_ptr<observer> & observer : observers_)
+    for (const std::shared_ptr<observer> & observer : *get_observers())
     {
         observer->on_reply(reply);
     }
@@ -1065,7 +2153,7 @@ void client::notify_reply(const reply & reply)
 
 void client::notify_file_list(std::string_view file_list)
 {
-    for (const std::shared_ptr<observer> & observer : observers_)
+    for (const std::shared_ptr<observer> & observer : *get_observers())
     {
         observer->on_file_list(file_list);
     }
@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/command_queue.hpp>
+
+namespace ftp::detail
+{
+
+command_queue::command_queue()
+    : mutex_(),
+      condition_(),
+      next_ticket_(0),
+      running_ticket_(0),
+      owner_(),
+      depth_(0)
+{
+}
+
+void command_queue::lock()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::thread::id id = std::this_thread::get_id();
+
+    if (depth_ > 0 && owner_ == id)
+    {
+        ++depth_;
+        return;
+    }
+
+    std::uint64_t ticket = next_ticket_++;
+
+    condition_.wait(lock, [this, ticket] { return running_ticket_ == ticket; });
+
+    owner_ = id;
+    depth_ = 1;
+}
+
+void command_queue::unlock()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (--depth_ > 0)
+    {
+        return;
+    }
+
+    owner_ = std::thread::id();
+    ++running_ticket_;
+
+    lock.unlock();
+
+    /* Every waiting thread checks whether its ticket is next. */
+    condition_.notify_all();
+}
+
+} // namespace ftp::detail
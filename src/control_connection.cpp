@@ -24,6 +24,8 @@
 
 #include <ftp/ftp_exception.hpp>
 #include <ftp/detail/control_connection.hpp>
+#include <ftp/detail/happy_eyeballs.hpp>
+#include <ftp/detail/net_utils.hpp>
 #include <ftp/detail/socket.hpp>
 #include <ftp/detail/ssl_socket.hpp>
 #include <ftp/detail/utils.hpp>
@@ -42,38 +44,50 @@ static bool try_parse_status_code(std::string_view line, std::uint16_t & status_
 }
 
 control_connection::control_connection(net_context & net_context)
+    : io_context_(net_context.get_io_context()),
+      timeouts_(),
+      deadline_()
 {
-    socket_ = std::make_unique<socket>(net_context.get_io_context());
+    socket_ = std::make_unique<socket>(io_context_);
 }
 
-void control_connection::connect(std::string_view hostname, std::uint16_t port)
+void control_connection::connect(std::string_view hostname,
+                                 std::uint16_t port,
+                                 resolver & resolver,
+                                 const socket_options & options)
 {
-    boost::asio::ip::tcp::resolver resolver(socket_->get_executor());
     boost::system::error_code ec;
 
-    boost::asio::ip::tcp::resolver::results_type endpoints =
-            resolver.resolve(hostname, std::to_string(port), ec);
+    /* The connect timeout covers the name resolution too. */
+    std::optional<std::chrono::steady_clock::time_point> deadline =
+        net_utils::make_deadline(timeouts_.connect, deadline_);
+
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints = resolver.resolve(hostname, port, deadline, ec);
 
     if (ec)
     {
+        net_utils::translate_timeout(ec, error::connect_timeout, deadline_);
         throw ftp_exception(ec, "Cannot open control connection");
     }
 
-    socket_->connect(endpoints, ec);
+    /* Race the connection attempts to the resolved endpoints, so that an
+     * unreachable address (e.g. a broken IPv6 route) does not delay the
+     * connection until the OS timeout.
+     */
+    boost::asio::ip::tcp::socket raw = happy_eyeballs::connect(io_context_,
+                                                               endpoints,
+                                                               happy_eyeballs::default_attempt_delay,
+                                                               ec,
+                                                               options,
+                                                               deadline);
 
     if (ec)
     {
-        boost::system::error_code ignored;
-
-        /* If the connect fails, and the socket was automatically opened,
-         * the socket is not returned to the closed state.
-         *
-         * https://www.boost.org/doc/libs/1_70_0/doc/html/boost_asio/reference/basic_stream_socket/connect/overload2.html
-         */
-        socket_->close(ignored);
-
+        net_utils::translate_timeout(ec, error::connect_timeout, deadline_);
         throw ftp_exception(ec, "Cannot open control connection");
     }
+
+    socket_ = std::make_unique<socket>(std::move(raw));
 }
 
 bool control_connection::is_connected() const
@@ -81,6 +95,13 @@ bool control_connection::is_connected() const
     return socket_->is_connected();
 }
 
+void control_connection::set_timeouts(const timeouts & timeouts,
+                                      const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    timeouts_ = timeouts;
+    deadline_ = deadline;
+}
+
 void control_connection::set_ssl(boost::asio::ssl::context *ssl_context)
 {
     boost::asio::ip::tcp::socket raw = socket_->detach();
@@ -104,10 +125,12 @@ void control_connection::ssl_handshake()
 {
     boost::system::error_code ec;
 
+    socket_->set_deadline(net_utils::make_deadline(timeouts_.connect, deadline_));
     socket_->ssl_handshake(boost::asio::ssl::stream_base::client, ec);
 
     if (ec)
     {
+        net_utils::translate_timeout(ec, error::connect_timeout, deadline_);
         throw ftp_exception(ec, "Cannot perform SSL/TLS handshake");
     }
 }
@@ -116,10 +139,12 @@ void control_connection::ssl_shutdown()
 {
     boost::system::error_code ec;
 
+    set_reply_deadline();
     socket_->ssl_shutdown(ec);
 
     if (ec)
     {
+        translate_reply_timeout(ec);
         throw ftp_exception(ec, "Cannot perform SSL/TLS shutdown");
     }
 }
@@ -135,6 +160,9 @@ reply control_connection::recv()
     std::string line;
     std::uint16_t code;
 
+    /* The reply timeout limits the whole reply, including all its lines. */
+    set_reply_deadline();
+
     line = read_line();
 
     if (!try_parse_status_code(line, code))
@@ -201,6 +229,7 @@ reply control_connection::recv()
             }
             else if (ec)
             {
+                translate_reply_timeout(ec);
                 throw ftp_exception(ec, "Cannot close control connection");
             }
         }
@@ -265,14 +294,28 @@ void control_connection::send(std::string_view command)
     std::string data(command);
     data.append("\r\n");
 
+    set_reply_deadline();
     socket_->write(data, ec);
 
     if (ec)
     {
+        translate_reply_timeout(ec);
         throw ftp_exception(ec, "Cannot send data over control connection");
     }
 }
 
+void control_connection::send_urgent(std::string_view data)
+{
+    boost::system::error_code ec;
+
+    socket_->get_socket().send(boost::asio::buffer(data), boost::asio::socket_base::message_out_of_band, ec);
+
+    if (ec)
+    {
+        throw ftp_exception(ec, "Cannot send urgent data over control connection");
+    }
+}
+
 std::string control_connection::read_line()
 {
     boost::system::error_code ec;
@@ -285,6 +328,7 @@ std::string control_connection::read_line()
     }
     else if (ec)
     {
+        translate_reply_timeout(ec);
         throw ftp_exception(ec, "Cannot receive data over control connection");
     }
 
@@ -301,6 +345,7 @@ void control_connection::disconnect()
     /* Shutdown the SSL layer. */
     if (socket_->has_ssl_support())
     {
+        set_reply_deadline();
         socket_->ssl_shutdown(ec);
 
         if (ec == boost::asio::error::eof)
@@ -311,6 +356,7 @@ void control_connection::disconnect()
         }
         else if (ec)
         {
+            translate_reply_timeout(ec);
             throw ftp_exception(ec, "Cannot close control connection");
         }
     }
@@ -338,6 +384,16 @@ void control_connection::disconnect()
     }
 }
 
+void control_connection::set_reply_deadline()
+{
+    socket_->set_deadline(net_utils::make_deadline(timeouts_.reply, deadline_));
+}
+
+void control_connection::translate_reply_timeout(boost::system::error_code & ec) const
+{
+    net_utils::translate_timeout(ec, error::reply_timeout, deadline_);
+}
+
 boost::asio::ip::tcp::endpoint control_connection::get_local_endpoint() const
 {
     boost::system::error_code ec;
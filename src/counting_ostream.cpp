@@ -1,7 +1,7 @@
 /*
  * MIT License
  *
- * Copyright (c) 2023 Denis Kovalchuk
+ * Copyright (c) 2024 Denis Kovalchuk
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -22,24 +22,43 @@
  * SOFTWARE.
  */
 
-#include <ftp/detail/binary_ostream.hpp>
+
+#include <ftp/detail/counting_ostream.hpp>
 
 namespace ftp::detail
 {
 
-binary_ostream::binary_ostream(output_stream & dst)
-    : dst_(dst)
+counting_ostream::counting_ostream(output_stream & dst)
+    : dst_(dst),
+      size_(0)
 {
 }
 
-void binary_ostream::write(char *buf, std::size_t size)
+void counting_ostream::write(char *buf, std::size_t size)
 {
     dst_.write(buf, size);
+    size_ += size;
 }
 
-void binary_ostream::flush()
+void counting_ostream::flush()
 {
     dst_.flush();
 }
 
+char * counting_ostream::prepare(std::size_t & size)
+{
+    return dst_.prepare(size);
+}
+
+void counting_ostream::commit(std::size_t size)
+{
+    dst_.commit(size);
+    size_ += size;
+}
+
+std::uint64_t counting_ostream::get_size() const
+{
+    return size_;
+}
+
 } // namespace ftp::detail
@@ -23,18 +23,46 @@
  */
 
 #include <ftp/detail/data_connection.hpp>
+#include <ftp/detail/net_utils.hpp>
 #include <ftp/detail/socket.hpp>
 #include <ftp/detail/ssl_socket.hpp>
+#include <ftp/detail/zlib_compressor.hpp>
 #include <ftp/ftp_exception.hpp>
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
 
 namespace ftp::detail
 {
 
 data_connection::data_connection(net_context & net_context)
-    : acceptor_(net_context.get_io_context())
+    : io_context_(net_context.get_io_context()),
+      transmission_mode_(transmission_mode::stream),
+      rate_limiter_(),
+      socket_options_(),
+      buffer_size_(default_buffer_size),
+      timeouts_(),
+      deadline_(),
+      interrupted_(false)
+{
+    socket_ = std::make_unique<socket>(io_context_);
+}
+
+void data_connection::set_socket_options(const socket_options & options)
+{
+    socket_options_ = options;
+}
+
+void data_connection::set_timeouts(const timeouts & timeouts,
+                                   const std::optional<std::chrono::steady_clock::time_point> & deadline)
 {
-    socket_ = std::make_unique<socket>(net_context.get_io_context());
+    timeouts_ = timeouts;
+    deadline_ = deadline;
 }
 
 void data_connection::connect(std::string_view ip, std::uint16_t port)
@@ -48,36 +76,40 @@ void data_connection::connect(std::string_view ip, std::uint16_t port)
         throw ftp_exception(ec, "Cannot get IP address");
     }
 
-    boost::asio::ip::tcp::endpoint remote_endpoint(address, port);
-    socket_->connect(remote_endpoint, ec);
+    connect(boost::asio::ip::tcp::endpoint(address, port));
+}
 
-    if (ec)
-    {
-        boost::system::error_code ignored;
+void data_connection::connect(const boost::asio::ip::tcp::endpoint & endpoint)
+{
+    boost::system::error_code ec;
 
-        /* If the connect fails, and the socket was automatically opened,
-         * the socket is not returned to the closed state.
-         *
-         * https://www.boost.org/doc/libs/1_70_0/doc/html/boost_asio/reference/basic_stream_socket/connect/overload2.html
-         */
-        socket_->close(ignored);
+    /* Open the socket explicitly to set the options before connecting. */
+    socket_->get_socket().open(endpoint.protocol(), ec);
 
+    if (ec)
+    {
         throw ftp_exception(ec, "Cannot open data connection");
     }
-}
 
-void data_connection::connect(const boost::asio::ip::tcp::endpoint & endpoint)
-{
-    boost::system::error_code ec;
+    net_utils::set_socket_options(socket_->get_socket(), socket_options_, ec);
+
+    if (!ec)
+    {
+        net_utils::bind_socket(socket_->get_socket(), endpoint.protocol(), socket_options_, ec);
+    }
 
-    socket_->connect(endpoint, ec);
+    if (!ec)
+    {
+        socket_->set_deadline(net_utils::make_deadline(timeouts_.connect, deadline_));
+        socket_->connect(endpoint, ec);
+        translate_timeout(ec, error::connect_timeout);
+    }
 
     if (ec)
     {
         boost::system::error_code ignored;
 
-        /* If the connect fails, and the socket was automatically opened,
-         * the socket is not returned to the closed state.
+        /* If the connect fails, the socket is not returned to the closed state.
          *
          * https://www.boost.org/doc/libs/1_70_0/doc/html/boost_asio/reference/basic_stream_socket/connect/overload2.html
          */
@@ -87,42 +119,70 @@ void data_connection::connect(const boost::asio::ip::tcp::endpoint & endpoint)
     }
 }
 
-void data_connection::listen(const boost::asio::ip::tcp::endpoint & endpoint)
+void data_connection::accept(boost::asio::ip::tcp::acceptor & acceptor,
+                             const boost::asio::ip::address & peer_address,
+                             boost::system::error_code & ec)
 {
-    boost::system::error_code ec;
-
-    acceptor_.open(endpoint.protocol(), ec);
+    std::optional<std::chrono::steady_clock::time_point> deadline =
+        net_utils::make_deadline(timeouts_.connect, deadline_);
 
-    if (ec)
+    /* The listener is open across transfers, so anyone may connect to it.
+     * Only the server of the control connection is trusted with the data.
+     */
+    for (;;)
     {
-        throw ftp_exception(ec, "Cannot open socket acceptor");
-    }
+        accept_any(acceptor, deadline, ec);
+
+        if (ec)
+        {
+            return;
+        }
 
-    acceptor_.bind(endpoint, ec);
+        boost::asio::ip::tcp::endpoint remote_endpoint = socket_->get_socket().remote_endpoint(ec);
 
-    if (ec)
-    {
-        throw ftp_exception(ec, "Cannot bind socket acceptor");
+        if (!ec && net_utils::is_same_address(remote_endpoint.address(), peer_address))
+        {
+            break;
+        }
+
+        boost::system::error_code ignored;
+
+        socket_->close(ignored);
     }
 
-    acceptor_.listen(1, ec);
+    net_utils::set_socket_options(socket_->get_socket(), socket_options_, ec);
 
     if (ec)
     {
-        throw ftp_exception(ec, "Cannot listen socket acceptor");
+        boost::system::error_code ignored;
+
+        socket_->close(ignored);
     }
 }
 
-void data_connection::accept()
+void data_connection::accept_any(boost::asio::ip::tcp::acceptor & acceptor,
+                                 const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                                 boost::system::error_code & ec)
 {
-    boost::asio::ip::tcp::socket & socket = socket_->get_socket();
-    boost::system::error_code ec;
-
-    acceptor_.accept(socket, ec);
+    if (deadline)
+    {
+        net_utils::run_until(io_context_, deadline.value(), [&](auto handler)
+        {
+            acceptor.async_accept(socket_->get_socket(), [handler](const boost::system::error_code & ec) mutable
+            {
+                handler(ec, 0);
+            });
+        }, [&acceptor]()
+        {
+            boost::system::error_code ignored;
+            acceptor.cancel(ignored);
+        }, ec);
 
-    if (ec)
+        translate_timeout(ec, error::connect_timeout);
+    }
+    else
     {
-        throw ftp_exception(ec, "Cannot accept data connection");
+        acceptor.accept(socket_->get_socket(), ec);
     }
 }
 
@@ -144,15 +204,17 @@ void data_connection::ssl_handshake()
 {
     boost::system::error_code ec;
 
+    socket_->set_deadline(net_utils::make_deadline(timeouts_.connect, deadline_));
     socket_->ssl_handshake(boost::asio::ssl::stream_base::client, ec);
 
     if (ec)
     {
+        translate_timeout(ec, error::connect_timeout);
         throw ftp_exception(ec, "Cannot perform SSL/TLS handshake");
     }
 }
 
-void data_connection::send(input_stream & stream, transfer_callback * transfer_cb)
+void data_connection::send(input_stream & stream, transfer_callback * transfer_cb, hasher * hasher)
 {
     if (transfer_cb)
     {
@@ -164,29 +226,14 @@ void data_connection::send(input_stream & stream, transfer_callback * transfer_c
         transfer_cb->begin();
     }
 
-    std::array<char, 8192> buf;
-    std::size_t size;
-
-    while ((size = stream.read(buf.data(), buf.size())) > 0)
+    /* Dispatch once per transfer, the transfer loop calls the final socket class directly. */
+    if (socket_->has_ssl_support())
     {
-        boost::system::error_code ec;
-
-        socket_->write(buf.data(), size, ec);
-
-        if (ec)
-        {
-            throw ftp_exception(ec, "Cannot send data over data connection");
-        }
-
-        if (transfer_cb)
-        {
-            transfer_cb->notify(size);
-
-            if (transfer_cb->is_cancelled())
-            {
-                break;
-            }
-        }
+        send_data(static_cast<ssl_socket &>(*socket_), stream, transfer_cb, hasher);
+    }
+    else
+    {
+        send_data(static_cast<socket &>(*socket_), stream, transfer_cb, hasher);
     }
 
     if (transfer_cb)
@@ -195,7 +242,10 @@ void data_connection::send(input_stream & stream, transfer_callback * transfer_c
     }
 }
 
-void data_connection::recv(output_stream & stream, transfer_callback * transfer_cb)
+void data_connection::recv(output_stream & stream,
+                           transfer_callback * transfer_cb,
+                           hasher * hasher,
+                           std::optional<std::string> * restart_marker)
 {
     if (transfer_cb)
     {
@@ -207,40 +257,67 @@ void data_connection::recv(output_stream & stream, transfer_callback * transfer_
         transfer_cb->begin();
     }
 
-    boost::system::error_code ec;
-    std::array<char, 8192> buf;
-    std::size_t size;
-
-    while ((size = socket_->read_some(buf.data(), buf.size(), ec)) > 0)
+    /* Dispatch once per transfer, the transfer loop calls the final socket class directly. */
+    if (socket_->has_ssl_support())
     {
-        stream.write(buf.data(), size);
+        recv_data(static_cast<ssl_socket &>(*socket_), stream, transfer_cb, hasher, restart_marker);
+    }
+    else
+    {
+        recv_data(static_cast<socket &>(*socket_), stream, transfer_cb, hasher, restart_marker);
+    }
 
-        if (transfer_cb)
-        {
-            transfer_cb->notify(size);
+    stream.flush();
 
-            if (transfer_cb->is_cancelled())
-            {
-                break;
-            }
-        }
+    if (transfer_cb)
+    {
+        transfer_cb->end();
     }
+}
+
+std::size_t data_connection::read_some(char *data, std::size_t size)
+{
+    boost::system::error_code ec;
+
+    set_transfer_deadline(*socket_);
+    std::size_t read_size = socket_->read_some(data, size, ec);
 
     if (ec == boost::asio::error::eof)
     {
-        /* Ignore eof. */
+        return 0;
     }
     else if (ec)
     {
+        translate_timeout(ec, error::transfer_timeout);
         throw ftp_exception(ec, "Cannot receive data over data connection");
     }
 
-    stream.flush();
+    throttle(read_size);
 
-    if (transfer_cb)
-    {
-        transfer_cb->end();
-    }
+    return read_size;
+}
+
+void data_connection::write_some(const char *data, std::size_t size)
+{
+    /* A single call per chunk, the virtual dispatch does not matter. */
+    write(*socket_, data, size);
+}
+
+void data_connection::set_transmission_mode(transmission_mode mode)
+{
+    transmission_mode_ = mode;
+}
+
+void data_connection::set_rate_limiter(rate_limiter_ptr rate_limiter)
+{
+    rate_limiter_ = std::move(rate_limiter);
+}
+
+void data_connection::set_buffer_size(std::size_t size)
+{
+    assert(size > 0);
+
+    buffer_size_ = size;
 }
 
 void data_connection::disconnect(bool graceful)
@@ -250,6 +327,7 @@ void data_connection::disconnect(bool graceful)
     /* Shutdown the SSL layer. */
     if (socket_->has_ssl_support())
     {
+        set_transfer_deadline(*socket_);
         socket_->ssl_shutdown(ec);
 
         if (ec == boost::asio::error::eof)
@@ -260,6 +338,7 @@ void data_connection::disconnect(bool graceful)
         }
         else if (ec)
         {
+            translate_timeout(ec, error::transfer_timeout);
             throw ftp_exception(ec, "Cannot close data connection");
         }
     }
@@ -288,30 +367,489 @@ void data_connection::disconnect(bool graceful)
     {
         throw ftp_exception(ec, "Cannot close data connection");
     }
+}
 
-    if (acceptor_.is_open())
+void data_connection::interrupt()
+{
+    interrupted_ = true;
+
+    /* The Asio socket and the SSL stream are not safe to use concurrently with
+     * the transfer thread, so only the descriptor is shut down: the system call
+     * may be made while another thread is blocked on the socket. A blocked read
+     * returns the end of file, a blocked write fails.
+     */
+    boost::asio::ip::tcp::socket::native_handle_type handle = socket_->get_socket().native_handle();
+
+#ifdef _WIN32
+    ::shutdown(handle, SD_BOTH);
+#else
+    ::shutdown(handle, SHUT_RDWR);
+#endif
+}
+
+void data_connection::close()
+{
+    boost::system::error_code ignored;
+
+    socket_->close(ignored);
+}
+
+template<typename SocketType>
+void data_connection::send_data(SocketType & socket, input_stream & stream, transfer_callback * transfer_cb, hasher * hasher)
+{
+    zlib_compressor_ptr compressor;
+
+    if (transmission_mode_ == transmission_mode::zlib)
     {
-        acceptor_.close(ec);
+        compressor = std::make_unique<zlib_compressor>();
+    }
+
+    if (transmission_mode_ == transmission_mode::block)
+    {
+        /* Do not delay the EOF block until the last data block is acknowledged,
+         * the data connection is not closed to flush it.
+         */
+        boost::system::error_code ec;
+
+        socket.get_socket().set_option(boost::asio::ip::tcp::no_delay(true), ec);
 
         if (ec)
         {
-            throw ftp_exception(ec, "Cannot close data connection");
+            throw ftp_exception(ec, "Cannot set socket option");
+        }
+    }
+
+    std::array<char, block_header_size> header;
+    /* A block carries at most max_block_size bytes. */
+    std::vector<char> buf(transmission_mode_ == transmission_mode::block
+                              ? std::min(buffer_size_, max_block_size)
+                              : buffer_size_);
+    std::vector<char> compressed;
+    bool cancelled = false;
+
+    for (;;)
+    {
+        /* The data exposed by the stream is sent without copying it into the buffer,
+         * the compressor needs a copy anyway.
+         */
+        std::optional<std::string_view> region;
+
+        if (!compressor)
+        {
+            region = stream.peek(buf.size());
+        }
+
+        const char *data = buf.data();
+        std::size_t size;
+
+        if (region)
+        {
+            data = region->data();
+            size = region->size();
+        }
+        else
+        {
+            size = stream.read(buf.data(), buf.size());
+        }
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        if (hasher)
+        {
+            hasher->update(data, size);
+        }
+
+        if (compressor)
+        {
+            compressed.clear();
+            compressor->compress(data, size, compressed);
+            write(socket, compressed.data(), compressed.size());
+        }
+        else if (transmission_mode_ == transmission_mode::block)
+        {
+            make_block_header(header.data(), 0, size);
+            write(socket, header.data(), data, size);
+        }
+        else
+        {
+            write(socket, data, size);
+        }
+
+        if (region)
+        {
+            stream.consume(size);
+        }
+
+        if (transfer_cb)
+        {
+            transfer_cb->notify(size);
+
+            if (transfer_cb->is_cancelled())
+            {
+                cancelled = true;
+                break;
+            }
+        }
+
+        /* The data buffered by the socket is not sent after an abort. */
+        if (interrupted_)
+        {
+            cancelled = true;
+            break;
+        }
+    }
+
+    if (!cancelled)
+    {
+        if (compressor)
+        {
+            compressed.clear();
+            compressor->finish(compressed);
+            write(socket, compressed.data(), compressed.size());
+        }
+        else if (transmission_mode_ == transmission_mode::block)
+        {
+            make_block_header(header.data(), block_eof, 0);
+            write(socket, header.data(), header.size());
         }
     }
 }
 
-boost::asio::ip::tcp::endpoint data_connection::get_listen_endpoint() const
+template<typename SocketType>
+void data_connection::recv_data(SocketType & socket,
+                                output_stream & stream,
+                                transfer_callback * transfer_cb,
+                                hasher * hasher,
+                                std::optional<std::string> * restart_marker)
 {
+    if (transmission_mode_ == transmission_mode::block)
+    {
+        recv_blocks(socket, stream, transfer_cb, hasher, restart_marker);
+    }
+    else
+    {
+        recv_stream(socket, stream, transfer_cb, hasher);
+    }
+}
+
+template<typename SocketType>
+void data_connection::recv_stream(SocketType & socket, output_stream & stream, transfer_callback * transfer_cb, hasher * hasher)
+{
+    zlib_decompressor_ptr decompressor;
+
+    if (transmission_mode_ == transmission_mode::zlib)
+    {
+        decompressor = std::make_unique<zlib_decompressor>();
+    }
+
     boost::system::error_code ec;
+    /* Allocated by the first receive the stream does not lend memory for. */
+    std::vector<char> buf;
+    std::vector<char> decompressed;
+
+    if (decompressor)
+    {
+        decompressed.resize(buffer_size_);
+    }
+
+    for (;;)
+    {
+        /* Receive straight into the memory lent by the stream,
+         * the decompressor needs a copy anyway.
+         */
+        std::size_t receive_size = buffer_size_;
+        char *lent = decompressor ? nullptr : stream.prepare(receive_size);
+        char *data = lent;
+
+        if (!lent)
+        {
+            buf.resize(buffer_size_);
+            data = buf.data();
+            receive_size = buf.size();
+        }
+
+        set_transfer_deadline(socket);
+        std::size_t size = socket.read_some(data, receive_size, ec);
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        throttle(size);
+
+        if (decompressor)
+        {
+            decompressor->set_input(data, size);
+            size = 0;
+
+            /* A small chunk may inflate to much more data, it is written
+             * one buffer at a time.
+             */
+            for (;;)
+            {
+                std::size_t decompressed_size = decompressor->decompress(decompressed.data(), decompressed.size());
+
+                if (decompressed_size == 0)
+                {
+                    break;
+                }
+
+                if (hasher)
+                {
+                    hasher->update(decompressed.data(), decompressed_size);
+                }
+
+                stream.write(decompressed.data(), decompressed_size);
+                size += decompressed_size;
+            }
+        }
+        else
+        {
+            if (hasher)
+            {
+                hasher->update(data, size);
+            }
+
+            if (lent)
+            {
+                stream.commit(size);
+            }
+            else
+            {
+                stream.write(data, size);
+            }
+        }
+
+        if (transfer_cb)
+        {
+            transfer_cb->notify(size);
+
+            if (transfer_cb->is_cancelled())
+            {
+                return;
+            }
+        }
+
+        /* The data buffered by the socket is not received after an abort. */
+        if (interrupted_)
+        {
+            return;
+        }
+    }
+
+    if (ec == boost::asio::error::eof)
+    {
+        /* Ignore eof. */
+    }
+    else if (ec)
+    {
+        translate_timeout(ec, error::transfer_timeout);
+        throw ftp_exception(ec, "Cannot receive data over data connection");
+    }
+
+    if (decompressor && !decompressor->is_finished())
+    {
+        throw ftp_exception("Cannot receive data over data connection: the compressed data is truncated.");
+    }
+}
+
+/* Each block is preceded by a header:
+ *   +----------------+----------------+----------------+
+ *   | Descriptor     |    Byte Count                   |
+ *   |         8 bits |                      16 bits    |
+ *   +----------------+----------------+----------------+
+ *
+ * The end of file is marked by the EOF descriptor, the data connection stays open.
+ */
+template<typename SocketType>
+void data_connection::recv_blocks(SocketType & socket,
+                                  output_stream & stream,
+                                  transfer_callback * transfer_cb,
+                                  hasher * hasher,
+                                  std::optional<std::string> * restart_marker)
+{
+    std::array<char, block_header_size> header;
+    std::vector<char> block;
+
+    for (;;)
+    {
+        read(socket, header.data(), header.size());
 
-    boost::asio::ip::tcp::endpoint endpoint = acceptor_.local_endpoint(ec);
+        auto descriptor = static_cast<unsigned char>(header[0]);
+        std::size_t size = static_cast<unsigned char>(header[1]) << 8 | static_cast<unsigned char>(header[2]);
+
+        if (descriptor & block_restart_marker)
+        {
+            block.resize(size);
+            read(socket, block.data(), size);
+
+            /* The sender's position in the file. The data received so far
+             * has been written to the stream.
+             */
+            if (restart_marker)
+            {
+                *restart_marker = std::string(block.data(), size);
+            }
+        }
+        else if (size > 0)
+        {
+            /* Receive straight into the memory lent by the stream,
+             * if it has room for the whole block.
+             */
+            std::size_t lent_size = size;
+            char *lent = stream.prepare(lent_size);
+            char *data = lent;
+
+            if (lent_size < size)
+            {
+                lent = nullptr;
+            }
+
+            if (!lent)
+            {
+                block.resize(size);
+                data = block.data();
+            }
+
+            read(socket, data, size);
+
+            if (hasher)
+            {
+                hasher->update(data, size);
+            }
+
+            if (lent)
+            {
+                stream.commit(size);
+            }
+            else
+            {
+                stream.write(data, size);
+            }
+
+            if (transfer_cb)
+            {
+                transfer_cb->notify(size);
+
+                if (transfer_cb->is_cancelled())
+                {
+                    return;
+                }
+            }
+
+            if (interrupted_)
+            {
+                return;
+            }
+        }
+
+        if (descriptor & block_eof)
+        {
+            return;
+        }
+    }
+}
+
+void data_connection::set_transfer_deadline(socket_base & socket) const
+{
+    socket.set_deadline(net_utils::make_deadline(timeouts_.transfer, deadline_));
+}
+
+void data_connection::throttle(std::size_t size)
+{
+    if (!rate_limiter_)
+    {
+        return;
+    }
+
+    /* An abort stops the wait, the transfer loop notices it afterwards. */
+    if (!rate_limiter_->consume(size, interrupted_, deadline_) && !interrupted_)
+    {
+        throw ftp_exception(make_error_code(error::deadline_exceeded), "Cannot transfer data over data connection");
+    }
+}
+
+void data_connection::translate_timeout(boost::system::error_code & ec, error timeout_error) const
+{
+    net_utils::translate_timeout(ec, timeout_error, deadline_);
+}
+
+void data_connection::make_block_header(char *header, unsigned char descriptor, std::size_t size)
+{
+    header[0] = static_cast<char>(descriptor);
+    header[1] = static_cast<char>((size >> 8) & 0xff);
+    header[2] = static_cast<char>(size & 0xff);
+}
+
+template<typename SocketType>
+void data_connection::read(SocketType & socket, char *data, std::size_t size)
+{
+    boost::system::error_code ec;
+
+    while (size > 0)
+    {
+        set_transfer_deadline(socket);
+        std::size_t read_size = socket.read_some(data, size, ec);
+
+        if (ec == boost::asio::error::eof)
+        {
+            throw ftp_exception("Cannot receive data over data connection: "
+                                "the connection is closed before the end of file.");
+        }
+        else if (ec)
+        {
+            translate_timeout(ec, error::transfer_timeout);
+            throw ftp_exception(ec, "Cannot receive data over data connection");
+        }
+
+        throttle(read_size);
+
+        data += read_size;
+        size -= read_size;
+    }
+}
+
+template<typename SocketType>
+void data_connection::write(SocketType & socket, const char *header, const char *data, std::size_t size)
+{
+    throttle(block_header_size + size);
+
+    boost::system::error_code ec;
+
+    set_transfer_deadline(socket);
+    socket.write({ boost::asio::buffer(header, block_header_size), boost::asio::buffer(data, size) }, ec);
 
     if (ec)
     {
-        throw ftp_exception(ec, "Cannot get listen endpoint");
+        translate_timeout(ec, error::transfer_timeout);
+        throw ftp_exception(ec, "Cannot send data over data connection");
+    }
+}
+
+template<typename SocketType>
+void data_connection::write(SocketType & socket, const char *data, std::size_t size)
+{
+    if (size == 0)
+    {
+        return;
     }
 
-    return endpoint;
+    throttle(size);
+
+    boost::system::error_code ec;
+
+    set_transfer_deadline(socket);
+    socket.write(data, size, ec);
+
+    if (ec)
+    {
+        translate_timeout(ec, error::transfer_timeout);
+        throw ftp_exception(ec, "Cannot send data over data connection");
+    }
 }
 
 } // namespace ftp::detail
@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/data_listener.hpp>
+#include <ftp/ftp_exception.hpp>
+
+namespace ftp::detail
+{
+
+data_listener::data_listener(net_context & net_context)
+    : acceptor_(net_context.get_io_context()),
+      endpoint_(),
+      first_port_(0),
+      last_port_(0),
+      backlog_(boost::asio::socket_base::max_listen_connections),
+      send_buffer_size_(),
+      receive_buffer_size_()
+{
+}
+
+void data_listener::set_port_range(std::uint16_t first_port, std::uint16_t last_port)
+{
+    if (first_port > last_port)
+    {
+        throw ftp_exception("Invalid port range: %1%-%2%.", first_port, last_port);
+    }
+
+    if (first_port == first_port_ && last_port == last_port_)
+    {
+        return;
+    }
+
+    first_port_ = first_port;
+    last_port_ = last_port;
+
+    /* Rebind on the next transfer. */
+    close();
+}
+
+std::pair<std::uint16_t, std::uint16_t> data_listener::get_port_range() const
+{
+    return { first_port_, last_port_ };
+}
+
+void data_listener::set_backlog(int backlog)
+{
+    if (backlog == backlog_)
+    {
+        return;
+    }
+
+    backlog_ = backlog;
+
+    close();
+}
+
+int data_listener::get_backlog() const
+{
+    return backlog_;
+}
+
+void data_listener::set_socket_options(const socket_options & options)
+{
+    if (options.send_buffer_size == send_buffer_size_ &&
+        options.receive_buffer_size == receive_buffer_size_)
+    {
+        return;
+    }
+
+    send_buffer_size_ = options.send_buffer_size;
+    receive_buffer_size_ = options.receive_buffer_size;
+
+    close();
+}
+
+boost::asio::ip::tcp::endpoint data_listener::listen(const boost::asio::ip::address & address)
+{
+    if (acceptor_.is_open() && endpoint_.address() == address)
+    {
+        drop_pending_connections();
+    }
+
+    if (!acceptor_.is_open() || endpoint_.address() != address)
+    {
+        close();
+        open(address);
+    }
+
+    return endpoint_;
+}
+
+void data_listener::accept(data_connection & connection, const boost::asio::ip::address & peer_address)
+{
+    boost::system::error_code ec;
+
+    connection.accept(acceptor_, peer_address, ec);
+
+    if (ec)
+    {
+        /* The acceptor may be broken, reopen it on the next transfer. */
+        close();
+
+        throw ftp_exception(ec, "Cannot accept data connection");
+    }
+}
+
+bool data_listener::is_open() const
+{
+    return acceptor_.is_open();
+}
+
+void data_listener::close()
+{
+    boost::system::error_code ignored;
+
+    acceptor_.close(ignored);
+}
+
+void data_listener::open(const boost::asio::ip::address & address)
+{
+    boost::system::error_code ec;
+
+    acceptor_.open(address.is_v4() ? boost::asio::ip::tcp::v4() : boost::asio::ip::tcp::v6(), ec);
+
+    if (ec)
+    {
+        throw ftp_exception(ec, "Cannot open socket acceptor");
+    }
+
+#ifndef _WIN32
+    /* Allow to bind a port that has connections in the TIME_WAIT state,
+     * e.g. after reconnecting. An active listener still cannot be bound twice.
+     * On Windows SO_REUSEADDR allows binding a port in use by another socket.
+     */
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true), ec);
+
+    if (ec)
+    {
+        close();
+
+        throw ftp_exception(ec, "Cannot set socket option");
+    }
+#endif
+
+    if (send_buffer_size_)
+    {
+        acceptor_.set_option(boost::asio::socket_base::send_buffer_size(*send_buffer_size_), ec);
+    }
+
+    if (receive_buffer_size_ && !ec)
+    {
+        acceptor_.set_option(boost::asio::socket_base::receive_buffer_size(*receive_buffer_size_), ec);
+    }
+
+    if (ec)
+    {
+        close();
+
+        throw ftp_exception(ec, "Cannot set socket option");
+    }
+
+    if (first_port_ == 0)
+    {
+        try_bind(boost::asio::ip::tcp::endpoint(address, 0), ec);
+    }
+    else
+    {
+        /* Take the first free port in the range. */
+        for (std::uint32_t port = first_port_; port <= last_port_; port++)
+        {
+            if (try_bind(boost::asio::ip::tcp::endpoint(address, static_cast<std::uint16_t>(port)), ec))
+            {
+                break;
+            }
+        }
+    }
+
+    if (ec)
+    {
+        close();
+
+        throw ftp_exception(ec, "Cannot bind socket acceptor");
+    }
+
+    acceptor_.listen(backlog_, ec);
+
+    if (ec)
+    {
+        close();
+
+        throw ftp_exception(ec, "Cannot listen socket acceptor");
+    }
+
+    endpoint_ = acceptor_.local_endpoint(ec);
+
+    if (ec)
+    {
+        close();
+
+        throw ftp_exception(ec, "Cannot get listen endpoint");
+    }
+}
+
+/* A server may connect on the PORT/EPRT command and then reject the main command,
+ * such a connection must not be accepted by the next transfer.
+ */
+void data_listener::drop_pending_connections()
+{
+    if (!acceptor_.is_open())
+    {
+        return;
+    }
+
+    boost::system::error_code ec;
+
+    acceptor_.non_blocking(true, ec);
+
+    while (!ec)
+    {
+        boost::asio::ip::tcp::socket socket(acceptor_.get_executor());
+
+        acceptor_.accept(socket, ec);
+    }
+
+    if (ec != boost::asio::error::would_block && ec != boost::asio::error::try_again)
+    {
+        close();
+        return;
+    }
+
+    acceptor_.non_blocking(false, ec);
+
+    if (ec)
+    {
+        close();
+    }
+}
+
+bool data_listener::try_bind(const boost::asio::ip::tcp::endpoint & endpoint, boost::system::error_code & ec)
+{
+    acceptor_.bind(endpoint, ec);
+
+    if (ec == boost::asio::error::address_in_use || ec == boost::asio::error::access_denied)
+    {
+        return false;
+    }
+
+    /* Success or an error that does not depend on the port. */
+    return true;
+}
+
+} // namespace ftp::detail
@@ -0,0 +1,313 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/download_stream.hpp>
+#include <ftp/client.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ftp
+{
+
+using namespace ftp::detail;
+
+download_stream::buffer_ostream::buffer_ostream(std::string & buffer)
+    : buffer_(buffer)
+{
+}
+
+void download_stream::buffer_ostream::write(char *buf, std::size_t size)
+{
+    buffer_.append(buf, size);
+}
+
+void download_stream::buffer_ostream::flush()
+{
+}
+
+download_stream::download_stream(client & client,
+                                 std::unique_lock<command_queue> && lock,
+                                 data_connection_ptr && connection,
+                                 replies && replies)
+    : client_(client),
+      lock_(std::move(lock)),
+      connection_(std::move(connection)),
+      replies_(std::move(replies)),
+      hasher_(client_.create_transfer_hasher(std::nullopt)),
+      decompressor_(),
+      buffer_(),
+      buffer_pos_(0),
+      sink_(buffer_),
+      converter_(client_.create_output_stream(sink_)),
+      received_(),
+      decompressed_(),
+      eof_(false),
+      aborted_(false),
+      closed_(false)
+{
+    client_.stream_open_ = true;
+
+    if (connection_)
+    {
+        client_.set_active_connection(connection_.get());
+    }
+
+    if (client_.transmission_mode_ == transmission_mode::zlib)
+    {
+        decompressor_ = std::make_unique<zlib_decompressor>();
+    }
+
+    /* Binary data is received straight into the buffer of the caller. */
+    if (decompressor_ || converter_)
+    {
+        received_.resize(client_.transfer_buffer_size_);
+    }
+
+    if (decompressor_)
+    {
+        decompressed_.resize(client_.transfer_buffer_size_);
+    }
+}
+
+download_stream::~download_stream()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        /* The errors are reported by close(). */
+    }
+}
+
+std::size_t download_stream::read(char *buf, std::size_t size)
+{
+    if (!connection_ || aborted_ || size == 0)
+    {
+        return 0;
+    }
+
+    if (!decompressor_ && !converter_)
+    {
+        if (eof_)
+        {
+            return 0;
+        }
+
+        std::size_t read_size = receive(buf, size);
+
+        if (aborted_)
+        {
+            return 0;
+        }
+        else if (read_size == 0)
+        {
+            eof_ = true;
+        }
+        else if (hasher_)
+        {
+            hasher_->update(buf, read_size);
+        }
+
+        return read_size;
+    }
+
+    while (buffer_pos_ == buffer_.size())
+    {
+        if (!fill_buffer())
+        {
+            return 0;
+        }
+    }
+
+    std::size_t copy_size = std::min(size, buffer_.size() - buffer_pos_);
+
+    std::memcpy(buf, buffer_.data() + buffer_pos_, copy_size);
+    buffer_pos_ += copy_size;
+
+    return copy_size;
+}
+
+bool download_stream::is_open() const
+{
+    return connection_ != nullptr;
+}
+
+replies download_stream::close()
+{
+    if (closed_)
+    {
+        return replies_;
+    }
+
+    closed_ = true;
+    client_.stream_open_ = false;
+
+    client_.set_active_connection(nullptr);
+
+    if (connection_)
+    {
+        if (aborted_ || client_.is_abort_requested())
+        {
+            /* The data connection is shut down already. */
+            connection_->close();
+            connection_.reset();
+
+            client_.process_abort(replies_, true);
+        }
+        else if (eof_)
+        {
+            client_.finish_data_connection(std::move(connection_), replies_);
+            client_.finish_transfer_hash(hasher_.get(), replies_);
+        }
+        else
+        {
+            /* Close the connection not gracefully before ABOR: the server may have
+             * sent the whole file already, then it replies to the transfer and
+             * to ABOR separately.
+             */
+            connection_->disconnect(false);
+            connection_.reset();
+
+            client_.process_abort(replies_, true);
+        }
+    }
+
+    if (lock_.owns_lock())
+    {
+        lock_.unlock();
+    }
+
+    return replies_;
+}
+
+bool download_stream::fill_buffer()
+{
+    buffer_.clear();
+    buffer_pos_ = 0;
+
+    /* The received data is inflated one buffer at a time, a small chunk
+     * may inflate to much more data.
+     */
+    if (decompressor_)
+    {
+        std::size_t size = decompressor_->decompress(decompressed_.data(), decompressed_.size());
+
+        if (size > 0)
+        {
+            append_data(decompressed_.data(), size);
+            return true;
+        }
+    }
+
+    if (eof_)
+    {
+        return false;
+    }
+
+    std::size_t size = receive(received_.data(), received_.size());
+
+    if (aborted_)
+    {
+        return false;
+    }
+
+    if (size == 0)
+    {
+        eof_ = true;
+
+        if (decompressor_ && !decompressor_->is_finished())
+        {
+            throw ftp_exception("Cannot receive data over data connection: the compressed data is truncated.");
+        }
+
+        /* A trailing CR is written by the flush. */
+        if (converter_)
+        {
+            converter_->flush();
+        }
+
+        return !buffer_.empty();
+    }
+
+    if (decompressor_)
+    {
+        decompressor_->set_input(received_.data(), size);
+    }
+    else
+    {
+        append_data(received_.data(), size);
+    }
+
+    return true;
+}
+
+void download_stream::append_data(char *data, std::size_t size)
+{
+    if (hasher_)
+    {
+        hasher_->update(data, size);
+    }
+
+    if (converter_)
+    {
+        converter_->write(data, size);
+    }
+    else
+    {
+        sink_.write(data, size);
+    }
+}
+
+std::size_t download_stream::receive(char *buf, std::size_t size)
+{
+    std::size_t read_size = 0;
+
+    try
+    {
+        read_size = connection_->read_some(buf, size);
+    }
+    catch (const ftp_exception &)
+    {
+        /* The interrupted socket fails the read. */
+        if (!client_.is_abort_requested())
+        {
+            throw;
+        }
+    }
+
+    /* The interrupted socket may also read the end of the file. */
+    if (client_.is_abort_requested())
+    {
+        aborted_ = true;
+        return 0;
+    }
+
+    return read_size;
+}
+
+} // namespace ftp
@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/error.hpp>
+#include <string>
+
+namespace ftp
+{
+
+namespace
+{
+
+class error_category : public boost::system::error_category
+{
+public:
+    [[nodiscard]] const char * name() const noexcept override
+    {
+        return "ftp";
+    }
+
+    [[nodiscard]] std::string message(int value) const override
+    {
+        auto e = static_cast<error>(value);
+
+        if (e == error::connect_timeout)
+        {
+            return "Connection timed out";
+        }
+        else if (e == error::reply_timeout)
+        {
+            return "Timed out waiting for a reply";
+        }
+        else if (e == error::transfer_timeout)
+        {
+            return "Data transfer timed out";
+        }
+        else if (e == error::deadline_exceeded)
+        {
+            return "Deadline exceeded";
+        }
+        else
+        {
+            return "Unknown error";
+        }
+    }
+};
+
+} // namespace
+
+const boost::system::error_category & get_error_category()
+{
+    static const error_category category;
+    return category;
+}
+
+boost::system::error_code make_error_code(error e)
+{
+    return boost::system::error_code(static_cast<int>(e), get_error_category());
+}
+
+} // namespace ftp
@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/features_reply.hpp>
+#include <ftp/detail/utils.hpp>
+#include <sstream>
+
+namespace ftp
+{
+
+using namespace ftp::detail;
+
+features_reply::features_reply()
+    : ftp::reply()
+{}
+
+features_reply::features_reply(const reply & reply)
+    : ftp::reply(reply)
+{
+    features_ = parse_features(reply);
+}
+
+const std::vector<std::string> & features_reply::get_features() const
+{
+    return features_;
+}
+
+bool features_reply::has_feature(std::string_view name) const
+{
+    for (const std::string & feature : features_)
+    {
+        std::string_view feature_name = feature;
+
+        if (utils::equals_ignore_case(feature_name, name))
+        {
+            return true;
+        }
+
+        std::string_view::size_type pos = feature_name.find(' ');
+
+        if (pos != std::string_view::npos && utils::equals_ignore_case(feature_name.substr(0, pos), name))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* The reply to the FEAT command:
+ *   211-Extensions supported:
+ *    MDTM
+ *    MODE Z
+ *   211 END
+ *
+ * https://tools.ietf.org/html/rfc2389
+ */
+std::vector<std::string> features_reply::parse_features(const reply & reply)
+{
+    std::vector<std::string> features;
+
+    if (reply.get_code() != 211)
+    {
+        return features;
+    }
+
+    std::istringstream iss(reply.get_status_string());
+    std::string line;
+    while (std::getline(iss, line))
+    {
+        /* Handle CRLF. */
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        /* Feature lines begin with a space. */
+        if (line.empty() || line.front() != ' ')
+            continue;
+
+        std::string::size_type begin = line.find_first_not_of(' ');
+        std::string::size_type end = line.find_last_not_of(' ');
+
+        if (begin == std::string::npos)
+            continue;
+
+        features.push_back(line.substr(begin, end - begin + 1));
+    }
+
+    return features;
+}
+
+} // namespace ftp
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/file_hash_reply.hpp>
+#include <ftp/detail/hasher.hpp>
+#include <ftp/detail/utils.hpp>
+#include <cctype>
+
+namespace ftp
+{
+
+using namespace ftp::detail;
+
+file_hash_reply::file_hash_reply()
+    : ftp::reply(),
+      algorithm_(hash_algorithm::sha1)
+{}
+
+file_hash_reply::file_hash_reply(const reply & reply, hash_algorithm algorithm)
+    : ftp::reply(reply),
+      algorithm_(algorithm)
+{
+    hash_ = parse_hash(reply, algorithm);
+}
+
+hash_algorithm file_hash_reply::get_algorithm() const
+{
+    return algorithm_;
+}
+
+const std::optional<std::string> & file_hash_reply::get_hash() const
+{
+    return hash_;
+}
+
+/* The reply to the HASH command:
+ *   213 <algorithm> <start>-<end> <hash> <pathname>
+ *
+ * https://tools.ietf.org/html/draft-bryan-ftpext-hash-02
+ *
+ * The reply to the XCRC, XMD5, XSHA1, XSHA256, XSHA512 commands:
+ *   250 <hash>
+ */
+std::optional<std::string> file_hash_reply::parse_hash(const reply & reply, hash_algorithm algorithm)
+{
+    if (!reply.is_positive())
+    {
+        return std::nullopt;
+    }
+
+    std::string_view status_string = reply.get_status_string();
+
+    /* Code, space, and at least one character. */
+    if (status_string.size() < 5)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> tokens = utils::split_string(status_string.substr(4), ' ');
+
+    std::string hash;
+
+    if (tokens.size() >= 3 && utils::equals_ignore_case(tokens[0], hasher::get_name(algorithm)))
+    {
+        hash = tokens[2];
+    }
+    else if (!tokens.empty())
+    {
+        hash = tokens[0];
+    }
+
+    if (hash.empty())
+    {
+        return std::nullopt;
+    }
+
+    for (char & ch : hash)
+    {
+        if (!std::isxdigit(static_cast<unsigned char>(ch)))
+        {
+            return std::nullopt;
+        }
+
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+
+    std::size_t length = hasher::get_hex_length(algorithm);
+
+    /* Some servers omit the leading zeros of CRC-32. */
+    if (algorithm == hash_algorithm::crc32 && hash.size() < length)
+    {
+        hash.insert(0, length - hash.size(), '0');
+    }
+
+    if (hash.size() != length)
+    {
+        return std::nullopt;
+    }
+
+    return hash;
+}
+
+} // namespace ftp
@@ -0,0 +1,367 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/file_output_stream.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ftp
+{
+
+namespace
+{
+
+boost::system::error_code last_error()
+{
+#ifdef _WIN32
+    return boost::system::error_code(static_cast<int>(GetLastError()), boost::system::system_category());
+#else
+    return boost::system::error_code(errno, boost::system::system_category());
+#endif
+}
+
+} // namespace
+
+file_output_stream::file_output_stream(const std::filesystem::path & path, cache_mode mode)
+    :
+#ifdef _WIN32
+      file_(INVALID_HANDLE_VALUE),
+#else
+      fd_(-1),
+#endif
+      mode_(mode),
+      buffer_(nullptr),
+      buffer_used_(0),
+      offset_(0),
+      dropped_offset_(0),
+      started_offset_(0)
+{
+    buffer_ = static_cast<char *>(::operator new(buffer_size, std::align_val_t(alignment)));
+
+#ifdef _WIN32
+    DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+
+    if (mode_ == cache_mode::direct)
+    {
+        flags |= FILE_FLAG_NO_BUFFERING;
+    }
+
+    file_ = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, flags, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        boost::system::error_code ec = last_error();
+        close();
+        throw ftp_exception(ec, "Cannot open file '%1%'", path.string());
+    }
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+
+#ifdef O_DIRECT
+    if (mode_ == cache_mode::direct)
+    {
+        flags |= O_DIRECT;
+    }
+#endif
+
+    fd_ = ::open(path.c_str(), flags, 0666);
+
+#ifdef O_DIRECT
+    if (fd_ == -1 && errno == EINVAL && mode_ == cache_mode::direct)
+    {
+        /* The file system does not support the direct I/O. */
+        mode_ = cache_mode::drop_behind;
+        fd_ = ::open(path.c_str(), flags & ~O_DIRECT, 0666);
+    }
+#endif
+
+    if (fd_ == -1)
+    {
+        boost::system::error_code ec = last_error();
+        close();
+        throw ftp_exception(ec, "Cannot open file '%1%'", path.string());
+    }
+
+#ifdef __APPLE__
+    if (mode_ == cache_mode::direct && ::fcntl(fd_, F_NOCACHE, 1) == -1)
+    {
+        mode_ = cache_mode::drop_behind;
+    }
+#endif
+#endif
+}
+
+file_output_stream::~file_output_stream()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        /* Ignore errors. */
+    }
+
+    close();
+}
+
+void file_output_stream::preallocate(std::uint64_t size)
+{
+#ifdef _WIN32
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+
+    if (!SetFileInformationByHandle(file_, FileAllocationInfo, &info, sizeof(info)))
+    {
+        throw ftp_exception(last_error(), "Cannot preallocate file");
+    }
+#elif defined(__linux__)
+    if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) == -1)
+    {
+        /* The file system does not support the preallocation. */
+        if (errno != EOPNOTSUPP)
+        {
+            throw ftp_exception(last_error(), "Cannot preallocate file");
+        }
+    }
+#elif defined(__APPLE__)
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0 };
+
+    if (::fcntl(fd_, F_PREALLOCATE, &store) == -1)
+    {
+        /* There is no contiguous space, allocate any. */
+        store.fst_flags = F_ALLOCATEALL;
+
+        if (::fcntl(fd_, F_PREALLOCATE, &store) == -1)
+        {
+            throw ftp_exception(last_error(), "Cannot preallocate file");
+        }
+    }
+#endif
+}
+
+void file_output_stream::write(char *buf, std::size_t size)
+{
+    while (size > 0)
+    {
+        if (buffer_used_ == buffer_size)
+        {
+            write_buffer();
+        }
+
+        std::size_t copy_size = std::min(size, buffer_size - buffer_used_);
+
+        std::memcpy(buffer_ + buffer_used_, buf, copy_size);
+        buffer_used_ += copy_size;
+        buf += copy_size;
+        size -= copy_size;
+    }
+}
+
+void file_output_stream::flush()
+{
+    write_buffer();
+
+    if (mode_ == cache_mode::direct && buffer_used_ > 0)
+    {
+        /* The tail is written padded to the alignment, then the file is truncated
+         * to its size. The tail stays in the buffer and is written again
+         * with the following data.
+         */
+        std::size_t padded_size = (buffer_used_ + alignment - 1) / alignment * alignment;
+
+        std::memset(buffer_ + buffer_used_, 0, padded_size - buffer_used_);
+        write_file(buffer_, padded_size, offset_);
+        truncate_file(offset_ + buffer_used_);
+    }
+}
+
+char * file_output_stream::prepare(std::size_t & size)
+{
+    if (buffer_size - buffer_used_ < size)
+    {
+        write_buffer();
+
+        /* In the direct mode an unaligned tail stays in the buffer. */
+        if (buffer_size - buffer_used_ < size)
+        {
+            return nullptr;
+        }
+    }
+
+    return buffer_ + buffer_used_;
+}
+
+void file_output_stream::commit(std::size_t size)
+{
+    assert(buffer_used_ + size <= buffer_size);
+
+    buffer_used_ += size;
+}
+
+file_output_stream::cache_mode file_output_stream::get_cache_mode() const
+{
+    return mode_;
+}
+
+void file_output_stream::write_buffer()
+{
+    std::size_t size = buffer_used_;
+
+    if (mode_ == cache_mode::direct)
+    {
+        size = size / alignment * alignment;
+    }
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    write_file(buffer_, size, offset_);
+
+    offset_ += size;
+    buffer_used_ -= size;
+    std::memmove(buffer_, buffer_ + size, buffer_used_);
+
+    if (mode_ == cache_mode::drop_behind)
+    {
+        drop_behind();
+    }
+}
+
+void file_output_stream::write_file(const char *data, std::size_t size, std::uint64_t offset)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD written_size = 0;
+
+        if (!WriteFile(file_, data, static_cast<DWORD>(size), &written_size, &overlapped))
+        {
+            throw ftp_exception(last_error(), "Cannot write file");
+        }
+#else
+        ssize_t written_size = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+
+        if (written_size == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            throw ftp_exception(last_error(), "Cannot write file");
+        }
+#endif
+
+        data += written_size;
+        size -= static_cast<std::size_t>(written_size);
+        offset += static_cast<std::uint64_t>(written_size);
+    }
+}
+
+void file_output_stream::truncate_file(std::uint64_t size)
+{
+#ifdef _WIN32
+    FILE_END_OF_FILE_INFO info;
+    info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+
+    if (!SetFileInformationByHandle(file_, FileEndOfFileInfo, &info, sizeof(info)))
+    {
+        throw ftp_exception(last_error(), "Cannot truncate file");
+    }
+#else
+    if (::ftruncate(fd_, static_cast<off_t>(size)) == -1)
+    {
+        throw ftp_exception(last_error(), "Cannot truncate file");
+    }
+#endif
+}
+
+void file_output_stream::drop_behind()
+{
+#ifdef __linux__
+    /* Start the writeback of the written data. The writeback started
+     * by the previous call is likely to be finished, wait for it and drop
+     * the written pages from the page cache. The errors are ignored,
+     * these are hints and the data is written anyway.
+     */
+    ::sync_file_range(fd_, static_cast<off_t>(started_offset_),
+                      static_cast<off_t>(offset_ - started_offset_), SYNC_FILE_RANGE_WRITE);
+
+    if (started_offset_ > dropped_offset_)
+    {
+        ::sync_file_range(fd_, static_cast<off_t>(dropped_offset_),
+                          static_cast<off_t>(started_offset_ - dropped_offset_),
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd_, static_cast<off_t>(dropped_offset_),
+                        static_cast<off_t>(started_offset_ - dropped_offset_), POSIX_FADV_DONTNEED);
+    }
+
+    dropped_offset_ = started_offset_;
+    started_offset_ = offset_;
+#endif
+}
+
+void file_output_stream::close()
+{
+#ifdef _WIN32
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ != -1)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+
+    if (buffer_)
+    {
+        ::operator delete(buffer_, std::align_val_t(alignment));
+        buffer_ = nullptr;
+    }
+}
+
+} // namespace ftp
@@ -0,0 +1,262 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/detail/happy_eyeballs.hpp>
+#include <ftp/detail/net_utils.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <memory>
+#include <optional>
+
+namespace ftp::detail::happy_eyeballs
+{
+
+namespace
+{
+
+class connection_race
+{
+public:
+    connection_race(boost::asio::io_context & io_context,
+                    const std::vector<boost::asio::ip::tcp::endpoint> & endpoints,
+                    std::chrono::milliseconds attempt_delay,
+                    const socket_options & options)
+        : io_context_(io_context),
+          endpoints_(endpoints),
+          attempt_delay_(attempt_delay),
+          options_(options),
+          timer_(io_context),
+          next_(0)
+    {
+    }
+
+    boost::asio::ip::tcp::socket run(const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                                     boost::system::error_code & ec)
+    {
+        start_next_attempt();
+
+        /* The io_context runs out of work as soon as the race is decided:
+         * the losing attempts are closed and the timer is cancelled.
+         */
+        io_context_.restart();
+
+        if (deadline)
+        {
+            io_context_.run_until(deadline.value());
+
+            if (!io_context_.stopped() && !winner_)
+            {
+                /* The race is not decided by the deadline, cancel all the attempts. */
+                boost::system::error_code ignored;
+
+                timer_.cancel();
+                next_ = endpoints_.size();
+
+                for (std::unique_ptr<boost::asio::ip::tcp::socket> & socket : sockets_)
+                {
+                    socket->close(ignored);
+                }
+
+                io_context_.run();
+
+                ec = boost::asio::error::timed_out;
+                return boost::asio::ip::tcp::socket(io_context_);
+            }
+
+            io_context_.run();
+        }
+        else
+        {
+            io_context_.run();
+        }
+
+        if (winner_)
+        {
+            ec.clear();
+            return std::move(*sockets_[winner_.value()]);
+        }
+
+        ec = last_error_;
+        return boost::asio::ip::tcp::socket(io_context_);
+    }
+
+private:
+    void start_next_attempt()
+    {
+        while (next_ < endpoints_.size())
+        {
+            std::size_t index = next_++;
+            const boost::asio::ip::tcp::endpoint & endpoint = endpoints_[index];
+
+            sockets_.push_back(std::make_unique<boost::asio::ip::tcp::socket>(io_context_));
+            boost::asio::ip::tcp::socket & socket = *sockets_.back();
+
+            boost::system::error_code ec;
+            socket.open(endpoint.protocol(), ec);
+
+            if (!ec)
+            {
+                net_utils::set_socket_options(socket, options_, ec);
+            }
+
+            if (!ec)
+            {
+                net_utils::bind_socket(socket, endpoint.protocol(), options_, ec);
+            }
+
+            if (ec)
+            {
+                /* For example, the address family is not supported by the host.
+                 * Move on to the next endpoint immediately.
+                 */
+                last_error_ = ec;
+                continue;
+            }
+
+            socket.async_connect(endpoint, [this, index](const boost::system::error_code & ec)
+            {
+                on_connect(index, ec);
+            });
+
+            timer_.expires_after(attempt_delay_);
+            timer_.async_wait([this](const boost::system::error_code & ec)
+            {
+                if (ec != boost::asio::error::operation_aborted && !winner_)
+                {
+                    start_next_attempt();
+                }
+            });
+
+            return;
+        }
+    }
+
+    void on_connect(std::size_t index, const boost::system::error_code & ec)
+    {
+        if (winner_)
+        {
+            return;
+        }
+
+        boost::system::error_code ignored;
+
+        if (ec)
+        {
+            last_error_ = ec;
+            sockets_[index]->close(ignored);
+
+            /* Do not wait for the attempt delay if the attempt has failed. */
+            timer_.cancel();
+            start_next_attempt();
+            return;
+        }
+
+        winner_ = index;
+        timer_.cancel();
+
+        for (std::size_t i = 0; i < sockets_.size(); i++)
+        {
+            if (i != index)
+            {
+                sockets_[i]->close(ignored);
+            }
+        }
+    }
+
+    boost::asio::io_context & io_context_;
+    const std::vector<boost::asio::ip::tcp::endpoint> & endpoints_;
+    std::chrono::milliseconds attempt_delay_;
+    const socket_options & options_;
+    boost::asio::steady_timer timer_;
+    std::vector<std::unique_ptr<boost::asio::ip::tcp::socket>> sockets_;
+    std::size_t next_;
+    std::optional<std::size_t> winner_;
+    boost::system::error_code last_error_;
+};
+
+} // namespace
+
+std::vector<boost::asio::ip::tcp::endpoint> sort_endpoints(const std::vector<boost::asio::ip::tcp::endpoint> & endpoints)
+{
+    if (endpoints.empty())
+    {
+        return {};
+    }
+
+    std::vector<boost::asio::ip::tcp::endpoint> preferred;
+    std::vector<boost::asio::ip::tcp::endpoint> other;
+
+    bool prefer_v6 = endpoints.front().address().is_v6();
+
+    for (const boost::asio::ip::tcp::endpoint & endpoint : endpoints)
+    {
+        if (endpoint.address().is_v6() == prefer_v6)
+        {
+            preferred.push_back(endpoint);
+        }
+        else
+        {
+            other.push_back(endpoint);
+        }
+    }
+
+    std::vector<boost::asio::ip::tcp::endpoint> result;
+    result.reserve(endpoints.size());
+
+    for (std::size_t i = 0; i < preferred.size() || i < other.size(); i++)
+    {
+        if (i < preferred.size())
+        {
+            result.push_back(preferred[i]);
+        }
+
+        if (i < other.size())
+        {
+            result.push_back(other[i]);
+        }
+    }
+
+    return result;
+}
+
+boost::asio::ip::tcp::socket connect(boost::asio::io_context & io_context,
+                                     const std::vector<boost::asio::ip::tcp::endpoint> & endpoints,
+                                     std::chrono::milliseconds attempt_delay,
+                                     boost::system::error_code & ec,
+                                     const socket_options & options,
+                                     const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    if (endpoints.empty())
+    {
+        ec = boost::asio::error::host_not_found;
+        return boost::asio::ip::tcp::socket(io_context);
+    }
+
+    std::vector<boost::asio::ip::tcp::endpoint> sorted = sort_endpoints(endpoints);
+
+    connection_race race(io_context, sorted, attempt_delay, options);
+
+    return race.run(deadline, ec);
+}
+
+} // namespace ftp::detail::happy_eyeballs
@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/detail/hasher.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <cassert>
+
+namespace ftp::detail
+{
+
+static const EVP_MD * get_message_digest(hash_algorithm algorithm)
+{
+    if (algorithm == hash_algorithm::md5)
+    {
+        return EVP_md5();
+    }
+    else if (algorithm == hash_algorithm::sha1)
+    {
+        return EVP_sha1();
+    }
+    else if (algorithm == hash_algorithm::sha256)
+    {
+        return EVP_sha256();
+    }
+    else if (algorithm == hash_algorithm::sha512)
+    {
+        return EVP_sha512();
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+static std::string to_hex(const unsigned char *data, std::size_t size)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+
+    std::string result;
+    result.reserve(size * 2);
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        result.push_back(digits[data[i] >> 4]);
+        result.push_back(digits[data[i] & 0x0f]);
+    }
+
+    return result;
+}
+
+hasher::hasher(hash_algorithm algorithm)
+    : algorithm_(algorithm),
+      md_ctx_(nullptr)
+{
+    const EVP_MD *md = get_message_digest(algorithm);
+
+    if (!md)
+    {
+        /* CRC-32 is computed by Boost.CRC. */
+        return;
+    }
+
+    md_ctx_ = EVP_MD_CTX_new();
+
+    if (!md_ctx_)
+    {
+        throw ftp_exception("Cannot create message digest context.");
+    }
+
+    if (!EVP_DigestInit_ex(md_ctx_, md, nullptr))
+    {
+        EVP_MD_CTX_free(md_ctx_);
+        throw ftp_exception("Cannot initialize message digest context.");
+    }
+}
+
+hasher::~hasher()
+{
+    if (md_ctx_)
+    {
+        EVP_MD_CTX_free(md_ctx_);
+    }
+}
+
+void hasher::update(const char *buf, std::size_t size)
+{
+    if (md_ctx_)
+    {
+        if (!EVP_DigestUpdate(md_ctx_, buf, size))
+        {
+            throw ftp_exception("Cannot update message digest.");
+        }
+    }
+    else
+    {
+        crc32_.process_bytes(buf, size);
+    }
+}
+
+std::string hasher::finish()
+{
+    if (md_ctx_)
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int size;
+
+        if (!EVP_DigestFinal_ex(md_ctx_, digest, &size))
+        {
+            throw ftp_exception("Cannot finalize message digest.");
+        }
+
+        return to_hex(digest, size);
+    }
+    else
+    {
+        std::uint32_t checksum = crc32_.checksum();
+
+        unsigned char digest[4] = {
+            static_cast<unsigned char>(checksum >> 24),
+            static_cast<unsigned char>(checksum >> 16),
+            static_cast<unsigned char>(checksum >> 8),
+            static_cast<unsigned char>(checksum)
+        };
+
+        return to_hex(digest, sizeof(digest));
+    }
+}
+
+std::string_view hasher::get_name(hash_algorithm algorithm)
+{
+    if (algorithm == hash_algorithm::crc32)
+    {
+        return "CRC32";
+    }
+    else if (algorithm == hash_algorithm::md5)
+    {
+        return "MD5";
+    }
+    else if (algorithm == hash_algorithm::sha1)
+    {
+        return "SHA-1";
+    }
+    else if (algorithm == hash_algorithm::sha256)
+    {
+        return "SHA-256";
+    }
+    else if (algorithm == hash_algorithm::sha512)
+    {
+        return "SHA-512";
+    }
+    else
+    {
+        assert(false);
+        return "";
+    }
+}
+
+std::string_view hasher::get_legacy_command(hash_algorithm algorithm)
+{
+    if (algorithm == hash_algorithm::crc32)
+    {
+        return "XCRC";
+    }
+    else if (algorithm == hash_algorithm::md5)
+    {
+        return "XMD5";
+    }
+    else if (algorithm == hash_algorithm::sha1)
+    {
+        return "XSHA1";
+    }
+    else if (algorithm == hash_algorithm::sha256)
+    {
+        return "XSHA256";
+    }
+    else if (algorithm == hash_algorithm::sha512)
+    {
+        return "XSHA512";
+    }
+    else
+    {
+        assert(false);
+        return "";
+    }
+}
+
+std::size_t hasher::get_hex_length(hash_algorithm algorithm)
+{
+    if (algorithm == hash_algorithm::crc32)
+    {
+        return 8;
+    }
+    else if (algorithm == hash_algorithm::md5)
+    {
+        return 32;
+    }
+    else if (algorithm == hash_algorithm::sha1)
+    {
+        return 40;
+    }
+    else if (algorithm == hash_algorithm::sha256)
+    {
+        return 64;
+    }
+    else if (algorithm == hash_algorithm::sha512)
+    {
+        return 128;
+    }
+    else
+    {
+        assert(false);
+        return 0;
+    }
+}
+
+} // namespace ftp::detail
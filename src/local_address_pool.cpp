@@ -0,0 +1,57 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/local_address_pool.hpp>
+
+namespace ftp
+{
+
+local_address_pool::local_address_pool(std::vector<boost::asio::ip::address> addresses)
+    : addresses_(std::move(addresses)),
+      next_(0)
+{
+}
+
+std::optional<boost::asio::ip::address> local_address_pool::next(const boost::asio::ip::tcp & protocol)
+{
+    for (std::size_t i = 0; i < addresses_.size(); i++)
+    {
+        const boost::asio::ip::address & address = addresses_[next_++ % addresses_.size()];
+
+        if (address.is_v6() == (protocol == boost::asio::ip::tcp::v6()))
+        {
+            return address;
+        }
+    }
+
+    return std::nullopt;
+}
+
+const std::vector<boost::asio::ip::address> & local_address_pool::get_addresses() const
+{
+    return addresses_;
+}
+
+} // namespace ftp
@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/log_ring.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ftp::detail
+{
+
+static std::size_t round_up_capacity(std::size_t capacity)
+{
+    std::size_t result = 2;
+
+    while (result < capacity)
+    {
+        result *= 2;
+    }
+
+    return result;
+}
+
+log_ring::log_ring(std::size_t capacity)
+    : cells_(std::make_unique<cell[]>(round_up_capacity(capacity))),
+      mask_(round_up_capacity(capacity) - 1),
+      push_position_(0),
+      pop_position_(0)
+{
+    for (std::size_t i = 0; i <= mask_; ++i)
+    {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+std::size_t log_ring::get_capacity() const
+{
+    return mask_ + 1;
+}
+
+bool log_ring::try_push(std::int64_t timestamp, std::uint8_t type, std::string_view data)
+{
+    std::uint64_t position = push_position_.load(std::memory_order_relaxed);
+    cell *target;
+
+    for (;;)
+    {
+        target = &cells_[position & mask_];
+
+        std::uint64_t sequence = target->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::int64_t>(sequence - position);
+
+        if (difference == 0)
+        {
+            /* The cell is free, claim it. */
+            if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            /* The consumer has not taken the record pushed a lap ago. */
+            return false;
+        }
+        else
+        {
+            /* Another producer has claimed the cell. */
+            position = push_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t size = std::min(data.size(), max_data_size);
+
+    target->entry.timestamp = timestamp;
+    target->entry.type = type;
+    target->entry.size = static_cast<std::uint16_t>(size);
+    std::memcpy(target->entry.data, data.data(), size);
+
+    /* Publish the record to the consumer. */
+    target->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool log_ring::try_pop(record & record)
+{
+    cell & next = cells_[pop_position_ & mask_];
+
+    if (next.sequence.load(std::memory_order_acquire) != pop_position_ + 1)
+    {
+        return false;
+    }
+
+    record.timestamp = next.entry.timestamp;
+    record.type = next.entry.type;
+    record.size = next.entry.size;
+    std::memcpy(record.data, next.entry.data, next.entry.size);
+
+    /* Free the cell for the push a lap later. */
+    next.sequence.store(pop_position_ + mask_ + 1, std::memory_order_release);
+    ++pop_position_;
+
+    return true;
+}
+
+std::uint64_t log_ring::get_push_count() const
+{
+    return push_position_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t log_ring::get_pop_count() const
+{
+    return pop_position_;
+}
+
+} // namespace ftp::detail
@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/lookup_pool.hpp>
+#include <boost/asio/error.hpp>
+#include <algorithm>
+#include <thread>
+
+namespace ftp::detail
+{
+
+std::shared_ptr<lookup_pool> lookup_pool::create(lookup_function lookup, std::size_t max_thread_count)
+{
+    return std::shared_ptr<lookup_pool>(new lookup_pool(std::move(lookup), max_thread_count));
+}
+
+lookup_pool::lookup_pool(lookup_function lookup, std::size_t max_thread_count)
+    : lookup_(std::move(lookup)),
+      max_thread_count_(std::max<std::size_t>(max_thread_count, 1)),
+      mutex_(),
+      done_cv_(),
+      queue_(),
+      requests_(),
+      thread_count_(0)
+{
+}
+
+lookup_pool::result lookup_pool::lookup(std::string_view hostname,
+                                        std::uint16_t port,
+                                        std::chrono::steady_clock::time_point deadline)
+{
+    std::string key = std::string(hostname) + ':' + std::to_string(port);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::shared_ptr<request> & pending = requests_[key];
+
+    if (!pending)
+    {
+        pending = std::make_shared<request>();
+        pending->key = key;
+        pending->hostname = hostname;
+        pending->port = port;
+
+        queue_.push_back(pending);
+
+        /* The running threads may all be blocked in lookups of other hostnames. */
+        if (thread_count_ < max_thread_count_)
+        {
+            try
+            {
+                std::thread(&lookup_pool::run, shared_from_this()).detach();
+            }
+            catch (...)
+            {
+                queue_.pop_back();
+                requests_.erase(key);
+                throw;
+            }
+
+            ++thread_count_;
+        }
+    }
+
+    std::shared_ptr<request> current = pending;
+
+    ++current->waiters;
+
+    bool done = done_cv_.wait_until(lock, deadline, [&current]()
+    {
+        return current->done;
+    });
+
+    --current->waiters;
+
+    if (!done)
+    {
+        return result({}, boost::asio::error::timed_out);
+    }
+
+    return current->value;
+}
+
+std::size_t lookup_pool::get_thread_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return thread_count_;
+}
+
+void lookup_pool::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!queue_.empty())
+    {
+        std::shared_ptr<request> current = std::move(queue_.front());
+        queue_.pop_front();
+
+        /* All the callers have timed out while the request was queued. */
+        if (current->waiters == 0)
+        {
+            requests_.erase(current->key);
+            continue;
+        }
+
+        lock.unlock();
+
+        result value = lookup_(current->hostname, current->port);
+
+        lock.lock();
+
+        current->value = std::move(value);
+        current->done = true;
+        requests_.erase(current->key);
+
+        done_cv_.notify_all();
+    }
+
+    --thread_count_;
+}
+
+} // namespace ftp::detail
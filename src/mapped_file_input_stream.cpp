@@ -0,0 +1,307 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/mapped_file_input_stream.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ftp
+{
+
+namespace
+{
+
+boost::system::error_code last_error()
+{
+#ifdef _WIN32
+    return boost::system::error_code(static_cast<int>(GetLastError()), boost::system::system_category());
+#else
+    return boost::system::error_code(errno, boost::system::system_category());
+#endif
+}
+
+std::size_t get_granularity()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace
+
+mapped_file_input_stream::mapped_file_input_stream(const std::filesystem::path & path, std::size_t window_size)
+    :
+#ifdef _WIN32
+      file_(INVALID_HANDLE_VALUE),
+      mapping_(nullptr),
+#else
+      fd_(-1),
+#endif
+      size_(0),
+      position_(0),
+      end_(0),
+      window_size_(0),
+      window_(nullptr),
+      window_offset_(0),
+      window_length_(0)
+{
+    std::size_t granularity = get_granularity();
+
+    window_size_ = std::max<std::size_t>((window_size + granularity - 1) / granularity, 1) * granularity;
+
+#ifdef _WIN32
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        throw ftp_exception(last_error(), "Cannot open file '%1%'", path.string());
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file_, &size))
+    {
+        boost::system::error_code ec = last_error();
+        close();
+        throw ftp_exception(ec, "Cannot get size of file '%1%'", path.string());
+    }
+
+    size_ = static_cast<std::uint64_t>(size.QuadPart);
+    end_ = size_;
+
+    /* An empty file cannot be mapped. */
+    if (size_ > 0)
+    {
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (!mapping_)
+        {
+            boost::system::error_code ec = last_error();
+            close();
+            throw ftp_exception(ec, "Cannot map file '%1%'", path.string());
+        }
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd_ == -1)
+    {
+        throw ftp_exception(last_error(), "Cannot open file '%1%'", path.string());
+    }
+
+    struct stat st;
+
+    if (::fstat(fd_, &st) == -1)
+    {
+        boost::system::error_code ec = last_error();
+        close();
+        throw ftp_exception(ec, "Cannot get size of file '%1%'", path.string());
+    }
+
+    if (!S_ISREG(st.st_mode))
+    {
+        close();
+        throw ftp_exception("Cannot open file '%1%': not a regular file.", path.string());
+    }
+
+    size_ = static_cast<std::uint64_t>(st.st_size);
+    end_ = size_;
+#endif
+}
+
+mapped_file_input_stream::~mapped_file_input_stream()
+{
+    close();
+}
+
+std::size_t mapped_file_input_stream::read(char *buf, std::size_t size)
+{
+    std::string_view region = *peek(size);
+
+    std::memcpy(buf, region.data(), region.size());
+    consume(region.size());
+
+    return region.size();
+}
+
+std::optional<std::string_view> mapped_file_input_stream::peek(std::size_t max_size)
+{
+    if (position_ == end_)
+    {
+        return std::string_view();
+    }
+
+    if (!window_)
+    {
+        map_window();
+    }
+
+    std::uint64_t offset = position_ - window_offset_;
+    std::size_t size = std::min<std::uint64_t>({ max_size, window_length_ - offset, end_ - position_ });
+
+    return std::string_view(window_ + offset, size);
+}
+
+void mapped_file_input_stream::consume(std::size_t size)
+{
+    assert(position_ + size <= end_);
+
+    position_ += size;
+
+    /* The consumed window is not needed anymore. */
+    if (window_ && position_ >= window_offset_ + window_length_)
+    {
+        unmap_window();
+    }
+}
+
+std::uint64_t mapped_file_input_stream::get_size() const
+{
+    return size_;
+}
+
+void mapped_file_input_stream::set_range(std::uint64_t offset, std::uint64_t size)
+{
+    if (offset > size_ || size > size_ - offset)
+    {
+        throw ftp_exception("Invalid file range.");
+    }
+
+    if (window_)
+    {
+        unmap_window();
+    }
+
+    position_ = offset;
+    end_ = offset + size;
+}
+
+void mapped_file_input_stream::map_window()
+{
+    /* The offset of a mapping must be a multiple of the granularity,
+     * which the window size is.
+     */
+    window_offset_ = position_ / window_size_ * window_size_;
+    window_length_ = static_cast<std::size_t>(std::min<std::uint64_t>(window_size_, size_ - window_offset_));
+
+#ifdef _WIN32
+    void *window = MapViewOfFile(mapping_, FILE_MAP_READ,
+                                 static_cast<DWORD>(window_offset_ >> 32),
+                                 static_cast<DWORD>(window_offset_ & 0xffffffff),
+                                 window_length_);
+
+    if (!window)
+    {
+        throw ftp_exception(last_error(), "Cannot map file");
+    }
+#else
+    /* Reading a mapped page past the end of a truncated file raises SIGBUS,
+     * fail instead if the file has been truncated before the window is mapped.
+     */
+    struct stat st;
+
+    if (::fstat(fd_, &st) == -1)
+    {
+        throw ftp_exception(last_error(), "Cannot get size of file");
+    }
+
+    if (static_cast<std::uint64_t>(st.st_size) < window_offset_ + window_length_)
+    {
+        throw ftp_exception("Cannot map file: the file has been truncated.");
+    }
+
+    void *window = ::mmap(nullptr, window_length_, PROT_READ, MAP_SHARED,
+                          fd_, static_cast<off_t>(window_offset_));
+
+    if (window == MAP_FAILED)
+    {
+        throw ftp_exception(last_error(), "Cannot map file");
+    }
+
+    /* The window is read once from the start to the end. */
+    ::madvise(window, window_length_, MADV_SEQUENTIAL);
+#endif
+
+    window_ = static_cast<char *>(window);
+}
+
+void mapped_file_input_stream::unmap_window()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(window_);
+#else
+    ::munmap(window_, window_length_);
+#endif
+
+    window_ = nullptr;
+    window_length_ = 0;
+}
+
+void mapped_file_input_stream::close()
+{
+    if (window_)
+    {
+        unmap_window();
+    }
+
+#ifdef _WIN32
+    if (mapping_)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ != -1)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+} // namespace ftp
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/memory_output_stream.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace ftp
+{
+
+memory_output_stream::memory_output_stream()
+    : data_(nullptr),
+      capacity_(0),
+      size_(0),
+      buffer_()
+{
+}
+
+memory_output_stream::memory_output_stream(char *data, std::size_t size)
+    : data_(data),
+      capacity_(size),
+      size_(0),
+      buffer_()
+{
+}
+
+void memory_output_stream::preallocate(std::uint64_t size)
+{
+    if (data_)
+    {
+        if (size > capacity_)
+        {
+            throw ftp_exception("Cannot preallocate memory: the buffer is too small.");
+        }
+    }
+    else
+    {
+        if (size > std::numeric_limits<std::size_t>::max())
+        {
+            throw ftp_exception("Cannot preallocate memory: the size is too large.");
+        }
+
+        if (size > capacity_)
+        {
+            reallocate(static_cast<std::size_t>(size));
+        }
+    }
+}
+
+void memory_output_stream::write(char *buf, std::size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (capacity_ - size_ < size)
+    {
+        if (data_)
+        {
+            throw ftp_exception("Cannot write data: the buffer is too small.");
+        }
+
+        /* Grow geometrically, so that the next receive fits in place. */
+        reallocate(std::max(size_ + size, 2 * capacity_));
+    }
+
+    std::memcpy(get_buffer() + size_, buf, size);
+    size_ += size;
+}
+
+void memory_output_stream::flush()
+{
+}
+
+char * memory_output_stream::prepare(std::size_t & size)
+{
+    /* The memory is lent only if it is not reallocated, the data is written
+     * otherwise, e.g. past the end of a preallocated buffer.
+     */
+    if (capacity_ == size_)
+    {
+        return nullptr;
+    }
+
+    size = std::min(size, capacity_ - size_);
+
+    return get_buffer() + size_;
+}
+
+void memory_output_stream::commit(std::size_t size)
+{
+    size_ += size;
+}
+
+std::string_view memory_output_stream::get_data() const
+{
+    return { get_buffer(), size_ };
+}
+
+std::size_t memory_output_stream::get_size() const
+{
+    return size_;
+}
+
+std::string memory_output_stream::release()
+{
+    std::string result(get_buffer(), size_);
+
+    if (!data_)
+    {
+        buffer_.reset();
+        capacity_ = 0;
+    }
+
+    size_ = 0;
+
+    return result;
+}
+
+char * memory_output_stream::get_buffer() const
+{
+    return data_ ? data_ : buffer_.get();
+}
+
+void memory_output_stream::reallocate(std::size_t capacity)
+{
+    /* Not value-initialized: the received data overwrites it. */
+    std::unique_ptr<char[]> buffer(new char[capacity]);
+
+    if (size_ > 0)
+    {
+        std::memcpy(buffer.get(), buffer_.get(), size_);
+    }
+
+    buffer_ = std::move(buffer);
+    capacity_ = capacity;
+}
+
+} // namespace ftp
@@ -27,6 +27,16 @@
 namespace ftp::detail
 {
 
+net_context::net_context()
+    : io_context_()
+{
+}
+
+net_context::net_context(int concurrency_hint)
+    : io_context_(concurrency_hint)
+{
+}
+
 boost::asio::io_context & net_context::get_io_context()
 {
     return io_context_;
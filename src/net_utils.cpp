@@ -24,6 +24,13 @@
 
 #include <ftp/detail/net_utils.hpp>
 #include <ftp/ftp_exception.hpp>
+#include <boost/asio/detail/socket_option.hpp>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
 
 namespace ftp::detail::net_utils
 {
@@ -40,4 +47,189 @@ std::string address_to_string(const boost::asio::ip::address & address)
     }
 }
 
+static boost::asio::ip::address unmap_address(const boost::asio::ip::address & address)
+{
+    if (address.is_v6() && address.to_v6().is_v4_mapped())
+    {
+        return boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address.to_v6());
+    }
+
+    return address;
+}
+
+bool is_same_address(const boost::asio::ip::address & first, const boost::asio::ip::address & second)
+{
+    return unmap_address(first) == unmap_address(second);
+}
+
+template<int Level, int Name>
+using integer_option = boost::asio::detail::socket_option::integer<Level, Name>;
+
+void set_socket_options(boost::asio::ip::tcp::socket & socket,
+                        const socket_options & options,
+                        boost::system::error_code & ec)
+{
+    ec.clear();
+
+    if (options.no_delay && !ec)
+    {
+        socket.set_option(boost::asio::ip::tcp::no_delay(*options.no_delay), ec);
+    }
+
+    if (options.send_buffer_size && !ec)
+    {
+        socket.set_option(boost::asio::socket_base::send_buffer_size(*options.send_buffer_size), ec);
+    }
+
+    if (options.receive_buffer_size && !ec)
+    {
+        socket.set_option(boost::asio::socket_base::receive_buffer_size(*options.receive_buffer_size), ec);
+    }
+
+    if (options.not_sent_low_watermark && !ec)
+    {
+#ifdef TCP_NOTSENT_LOWAT
+        socket.set_option(integer_option<IPPROTO_TCP, TCP_NOTSENT_LOWAT>(*options.not_sent_low_watermark), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+
+    if (options.congestion_control && !ec)
+    {
+#ifdef TCP_CONGESTION
+        const std::string & name = *options.congestion_control;
+
+        if (::setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_CONGESTION,
+                         name.data(), static_cast<socklen_t>(name.size())) != 0)
+        {
+            ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+        }
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+
+    if (options.keep_alive && !ec)
+    {
+        socket.set_option(boost::asio::socket_base::keep_alive(*options.keep_alive), ec);
+    }
+
+    if (options.keep_alive_idle && !ec)
+    {
+        auto seconds = static_cast<int>(options.keep_alive_idle->count());
+#if defined(TCP_KEEPIDLE)
+        socket.set_option(integer_option<IPPROTO_TCP, TCP_KEEPIDLE>(seconds), ec);
+#elif defined(TCP_KEEPALIVE)
+        socket.set_option(integer_option<IPPROTO_TCP, TCP_KEEPALIVE>(seconds), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+
+    if (options.keep_alive_interval && !ec)
+    {
+        auto seconds = static_cast<int>(options.keep_alive_interval->count());
+#ifdef TCP_KEEPINTVL
+        socket.set_option(integer_option<IPPROTO_TCP, TCP_KEEPINTVL>(seconds), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+
+    if (options.keep_alive_count && !ec)
+    {
+#ifdef TCP_KEEPCNT
+        socket.set_option(integer_option<IPPROTO_TCP, TCP_KEEPCNT>(*options.keep_alive_count), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+
+    if (options.busy_poll && !ec)
+    {
+#ifdef SO_BUSY_POLL
+        auto microseconds = static_cast<int>(options.busy_poll->count());
+        socket.set_option(integer_option<SOL_SOCKET, SO_BUSY_POLL>(microseconds), ec);
+#else
+        ec = boost::asio::error::operation_not_supported;
+#endif
+    }
+}
+
+void bind_socket(boost::asio::ip::tcp::socket & socket,
+                 const boost::asio::ip::tcp & protocol,
+                 const socket_options & options,
+                 boost::system::error_code & ec)
+{
+    ec.clear();
+
+    if (options.bind_device)
+    {
+#ifdef SO_BINDTODEVICE
+        const std::string & name = *options.bind_device;
+
+        if (::setsockopt(socket.native_handle(), SOL_SOCKET, SO_BINDTODEVICE,
+                         name.data(), static_cast<socklen_t>(name.size())) != 0)
+        {
+            ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+            return;
+        }
+#else
+        ec = boost::asio::error::operation_not_supported;
+        return;
+#endif
+    }
+
+    std::optional<boost::asio::ip::address> address = options.local_address;
+
+    if (!address && options.local_address_pool)
+    {
+        address = options.local_address_pool->next(protocol);
+    }
+
+    if (address)
+    {
+        socket.bind(boost::asio::ip::tcp::endpoint(*address, 0), ec);
+    }
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+make_deadline(const std::optional<std::chrono::milliseconds> & timeout,
+              const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    if (!timeout)
+    {
+        return deadline;
+    }
+
+    std::chrono::steady_clock::time_point result = std::chrono::steady_clock::now() + timeout.value();
+
+    if (deadline && deadline.value() < result)
+    {
+        return deadline;
+    }
+
+    return result;
+}
+
+void translate_timeout(boost::system::error_code & ec,
+                       error timeout_error,
+                       const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    if (ec != boost::asio::error::timed_out)
+    {
+        return;
+    }
+
+    if (deadline && std::chrono::steady_clock::now() >= deadline.value())
+    {
+        ec = make_error_code(error::deadline_exceeded);
+    }
+    else
+    {
+        ec = make_error_code(timeout_error);
+    }
+}
+
 } // namespace ftp::detail::net_utils
@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/pipelined_istream.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ftp
+{
+
+pipelined_istream::pipelined_istream(input_stream & src, std::size_t buffer_size, std::size_t buffer_count)
+    : src_(src),
+      ring_(std::max<std::size_t>(buffer_size, 1), std::max<std::size_t>(buffer_count, 1)),
+      current_(nullptr),
+      position_(0),
+      error_(),
+      stopped_(false),
+      thread_(&pipelined_istream::run, this)
+{
+}
+
+pipelined_istream::~pipelined_istream()
+{
+    stopped_ = true;
+    ring_.close();
+    thread_.join();
+}
+
+std::size_t pipelined_istream::read(char *buf, std::size_t size)
+{
+    std::string_view region = *peek(size);
+
+    std::memcpy(buf, region.data(), region.size());
+    consume(region.size());
+
+    return region.size();
+}
+
+std::optional<std::string_view> pipelined_istream::peek(std::size_t max_size)
+{
+    if (!current_)
+    {
+        current_ = ring_.get_filled();
+        position_ = 0;
+
+        if (!current_)
+        {
+            if (error_)
+            {
+                std::rethrow_exception(error_);
+            }
+
+            return std::string_view();
+        }
+    }
+
+    return std::string_view(current_->data.data() + position_,
+                            std::min(max_size, current_->size - position_));
+}
+
+void pipelined_istream::consume(std::size_t size)
+{
+    if (!current_)
+    {
+        return;
+    }
+
+    assert(position_ + size <= current_->size);
+
+    position_ += size;
+
+    if (position_ == current_->size)
+    {
+        ring_.put_free(current_);
+        current_ = nullptr;
+    }
+}
+
+void pipelined_istream::run()
+{
+    while (!stopped_)
+    {
+        detail::buffer_ring::buffer *buffer = ring_.get_free();
+
+        if (!buffer)
+        {
+            return;
+        }
+
+        bool eof = false;
+
+        try
+        {
+            while (buffer->size < buffer->data.size() && !stopped_)
+            {
+                std::size_t size = src_.read(buffer->data.data() + buffer->size,
+                                             buffer->data.size() - buffer->size);
+
+                if (size == 0)
+                {
+                    eof = true;
+                    break;
+                }
+
+                buffer->size += size;
+            }
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+            eof = true;
+        }
+
+        if (buffer->size > 0)
+        {
+            ring_.put_filled(buffer);
+        }
+        else
+        {
+            ring_.put_free(buffer);
+        }
+
+        if (eof)
+        {
+            ring_.finish();
+            return;
+        }
+    }
+}
+
+} // namespace ftp
@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/pipelined_ostream.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace ftp
+{
+
+pipelined_ostream::pipelined_ostream(output_stream & dst, std::size_t buffer_size, std::size_t buffer_count)
+    : dst_(dst),
+      ring_(std::max<std::size_t>(buffer_size, 1), std::max<std::size_t>(buffer_count, 1)),
+      current_(nullptr),
+      error_(),
+      thread_(&pipelined_ostream::run, this)
+{
+}
+
+pipelined_ostream::~pipelined_ostream()
+{
+    if (current_ && current_->size > 0)
+    {
+        ring_.put_filled(current_);
+    }
+
+    ring_.finish();
+    thread_.join();
+}
+
+void pipelined_ostream::write(char *buf, std::size_t size)
+{
+    while (size > 0)
+    {
+        if (!current_)
+        {
+            current_ = ring_.get_free();
+
+            if (!current_)
+            {
+                rethrow_error();
+            }
+        }
+
+        std::size_t copy_size = std::min(size, current_->data.size() - current_->size);
+
+        std::memcpy(current_->data.data() + current_->size, buf, copy_size);
+        current_->size += copy_size;
+        buf += copy_size;
+        size -= copy_size;
+
+        if (current_->size == current_->data.size())
+        {
+            ring_.put_filled(current_);
+            current_ = nullptr;
+        }
+    }
+}
+
+void pipelined_ostream::flush()
+{
+    if (current_)
+    {
+        ring_.put_filled(current_);
+        current_ = nullptr;
+    }
+
+    ring_.wait_consumed();
+
+    if (error_)
+    {
+        rethrow_error();
+    }
+
+    /* The writer thread waits for the next buffer and does not use the destination. */
+    dst_.flush();
+}
+
+char * pipelined_ostream::prepare(std::size_t & size)
+{
+    if (size > ring_.get_buffer_size())
+    {
+        return nullptr;
+    }
+
+    /* Hand over the current buffer if the rest of it is too small. */
+    if (current_ && current_->data.size() - current_->size < size)
+    {
+        ring_.put_filled(current_);
+        current_ = nullptr;
+    }
+
+    if (!current_)
+    {
+        current_ = ring_.get_free();
+
+        if (!current_)
+        {
+            rethrow_error();
+        }
+    }
+
+    return current_->data.data() + current_->size;
+}
+
+void pipelined_ostream::commit(std::size_t size)
+{
+    assert(current_ && current_->size + size <= current_->data.size());
+
+    current_->size += size;
+
+    if (current_->size == current_->data.size())
+    {
+        ring_.put_filled(current_);
+        current_ = nullptr;
+    }
+}
+
+void pipelined_ostream::run()
+{
+    while (detail::buffer_ring::buffer *buffer = ring_.get_filled())
+    {
+        try
+        {
+            dst_.write(buffer->data.data(), buffer->size);
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+            ring_.close();
+            return;
+        }
+
+        ring_.put_free(buffer);
+    }
+}
+
+void pipelined_ostream::rethrow_error()
+{
+    /* The ring is closed only after an error. */
+    std::rethrow_exception(error_);
+}
+
+} // namespace ftp
@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/progress_reporter.hpp>
+#include <algorithm>
+
+namespace ftp
+{
+
+progress_reporter::progress_reporter(std::chrono::milliseconds interval)
+    : interval_(interval),
+      total_size_(),
+      bytes_transferred_(0),
+      next_check_(0),
+      start_(),
+      last_report_(),
+      last_report_bytes_(0),
+      throughput_(0)
+{
+}
+
+void progress_reporter::set_total_size(const std::optional<std::uint64_t> & total_size)
+{
+    total_size_ = total_size;
+}
+
+const std::optional<std::uint64_t> & progress_reporter::get_total_size() const
+{
+    return total_size_;
+}
+
+std::chrono::milliseconds progress_reporter::get_interval() const
+{
+    return interval_;
+}
+
+void progress_reporter::begin()
+{
+    start_ = std::chrono::steady_clock::now();
+    last_report_ = start_;
+    bytes_transferred_ = 0;
+    last_report_bytes_ = 0;
+    next_check_ = 0;
+    throughput_ = 0;
+}
+
+void progress_reporter::notify(std::size_t bytes_transferred)
+{
+    bytes_transferred_ += bytes_transferred;
+
+    if (bytes_transferred_ >= next_check_)
+    {
+        check_time();
+    }
+}
+
+void progress_reporter::end()
+{
+    report(std::chrono::steady_clock::now(), true);
+}
+
+void progress_reporter::check_time()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (now - last_report_ >= interval_)
+    {
+        report(now, false);
+    }
+
+    /* Until the throughput is known, the clock is checked on every notification. */
+    std::chrono::duration<double> check_interval = std::chrono::duration<double>(interval_) / checks_per_interval;
+    auto check_size = static_cast<std::uint64_t>(throughput_ * check_interval.count());
+
+    next_check_ = bytes_transferred_ + check_size;
+}
+
+void progress_reporter::report(std::chrono::steady_clock::time_point now, bool done)
+{
+    std::chrono::duration<double> period = now - last_report_;
+
+    if (period.count() > 0)
+    {
+        double throughput = static_cast<double>(bytes_transferred_ - last_report_bytes_) / period.count();
+
+        /* The first interval starts the average. */
+        if (last_report_ == start_)
+        {
+            throughput_ = throughput;
+        }
+        else
+        {
+            throughput_ = smoothing * throughput + (1 - smoothing) * throughput_;
+        }
+    }
+
+    last_report_ = now;
+    last_report_bytes_ = bytes_transferred_;
+
+    progress progress = { bytes_transferred_, total_size_, now - start_, throughput_, std::nullopt, done };
+
+    if (done)
+    {
+        progress.eta = std::chrono::steady_clock::duration::zero();
+    }
+    else if (total_size_ && throughput_ > 0)
+    {
+        std::uint64_t left = total_size_.value() - std::min(total_size_.value(), bytes_transferred_);
+
+        progress.eta = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(left) / throughput_));
+    }
+
+    on_progress(progress);
+}
+
+} // namespace ftp
@@ -0,0 +1,241 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/rate_limiter.hpp>
+#include <algorithm>
+
+namespace ftp
+{
+
+rate_limiter::rate_limiter(std::uint64_t rate, std::uint64_t burst, rate_limiter_ptr parent)
+    : rate_(rate),
+      burst_(make_burst(rate, burst)),
+      tokens_(static_cast<double>(burst_)),
+      last_refill_(std::chrono::steady_clock::now()),
+      parent_(std::move(parent))
+{
+}
+
+void rate_limiter::set_rate(std::uint64_t rate, std::uint64_t burst)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    /* Account the time elapsed at the previous rate. */
+    refill(std::chrono::steady_clock::now());
+
+    if (rate_ == 0)
+    {
+        /* The bucket has not been used while unlimited. */
+        tokens_ = static_cast<double>(make_burst(rate, burst));
+    }
+
+    rate_ = rate;
+    burst_ = make_burst(rate, burst);
+    tokens_ = std::min(tokens_, static_cast<double>(burst_));
+
+    rate_changed_.notify_all();
+}
+
+std::uint64_t rate_limiter::get_rate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return rate_;
+}
+
+std::uint64_t rate_limiter::get_burst() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return burst_;
+}
+
+const rate_limiter_ptr & rate_limiter::get_parent() const
+{
+    return parent_;
+}
+
+std::chrono::nanoseconds rate_limiter::reserve(std::size_t size)
+{
+    rate_limiter *bottleneck;
+
+    return reserve(size, bottleneck);
+}
+
+void rate_limiter::consume(std::size_t size)
+{
+    rate_limiter *bottleneck;
+    std::chrono::nanoseconds delay = reserve(size, bottleneck);
+
+    if (delay.count() > 0)
+    {
+        bottleneck->wait(delay, nullptr, std::nullopt);
+    }
+}
+
+bool rate_limiter::consume(std::size_t size,
+                           const std::atomic<bool> & stop,
+                           const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    rate_limiter *bottleneck;
+    std::chrono::nanoseconds delay = reserve(size, bottleneck);
+
+    if (delay.count() > 0)
+    {
+        return bottleneck->wait(delay, &stop, deadline);
+    }
+
+    return true;
+}
+
+std::chrono::nanoseconds rate_limiter::reserve(std::size_t size, rate_limiter *& bottleneck)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds delay(0);
+
+    bottleneck = this;
+
+    /* The tokens are taken from all the limiters at once,
+     * the caller waits for the slowest one.
+     */
+    for (rate_limiter *limiter = this; limiter; limiter = limiter->parent_.get())
+    {
+        std::chrono::nanoseconds limiter_delay = limiter->reserve_tokens(size, now);
+
+        if (limiter_delay > delay)
+        {
+            delay = limiter_delay;
+            bottleneck = limiter;
+        }
+    }
+
+    return delay;
+}
+
+std::chrono::nanoseconds rate_limiter::reserve_tokens(std::size_t size, std::chrono::steady_clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (rate_ == 0)
+    {
+        return std::chrono::nanoseconds(0);
+    }
+
+    refill(now);
+
+    tokens_ -= static_cast<double>(size);
+
+    if (tokens_ >= 0)
+    {
+        return std::chrono::nanoseconds(0);
+    }
+
+    double seconds = -tokens_ / static_cast<double>(rate_);
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+}
+
+bool rate_limiter::wait(std::chrono::nanoseconds delay,
+                        const std::atomic<bool> * stop,
+                        const std::optional<std::chrono::steady_clock::time_point> & deadline)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + delay;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::uint64_t rate = rate_;
+
+    for (;;)
+    {
+        if (stop && *stop)
+        {
+            return false;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (rate_ != rate)
+        {
+            if (rate_ == 0)
+            {
+                return true;
+            }
+
+            /* The bytes still owed are paid off at the new rate. */
+            if (end > now)
+            {
+                std::chrono::duration<double> remaining = end - now;
+
+                end = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    remaining * (static_cast<double>(rate) / static_cast<double>(rate_)));
+            }
+
+            rate = rate_;
+        }
+
+        if (now >= end)
+        {
+            return true;
+        }
+
+        if (deadline && now >= deadline.value())
+        {
+            return false;
+        }
+
+        std::chrono::steady_clock::time_point wake_up = std::min(end, now + wait_slice);
+
+        if (deadline)
+        {
+            wake_up = std::min(wake_up, deadline.value());
+        }
+
+        rate_changed_.wait_until(lock, wake_up);
+    }
+}
+
+void rate_limiter::refill(std::chrono::steady_clock::time_point now)
+{
+    if (now > last_refill_)
+    {
+        std::chrono::duration<double> elapsed = now - last_refill_;
+
+        tokens_ = std::min(tokens_ + elapsed.count() * static_cast<double>(rate_),
+                           static_cast<double>(burst_));
+        last_refill_ = now;
+    }
+}
+
+std::uint64_t rate_limiter::make_burst(std::uint64_t rate, std::uint64_t burst)
+{
+    if (burst > 0)
+    {
+        return burst;
+    }
+
+    return std::max<std::uint64_t>(rate / 10, 1);
+}
+
+} // namespace ftp
@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/resolver.hpp>
+#include <utility>
+
+namespace ftp
+{
+
+std::vector<boost::asio::ip::tcp::endpoint>
+resolver::resolve(std::string_view hostname,
+                  std::uint16_t port,
+                  const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                  boost::system::error_code & ec)
+{
+    return resolve(hostname, port, ec);
+}
+
+static std::vector<boost::asio::ip::tcp::endpoint> resolve_hostname(boost::asio::io_context & io_context,
+                                                                    std::string_view hostname,
+                                                                    std::uint16_t port,
+                                                                    boost::system::error_code & ec)
+{
+    boost::asio::ip::tcp::resolver resolver(io_context);
+
+    boost::asio::ip::tcp::resolver::results_type results =
+            resolver.resolve(hostname, std::to_string(port), ec);
+
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+
+    if (ec)
+    {
+        return endpoints;
+    }
+
+    for (const boost::asio::ip::tcp::resolver::results_type::value_type & result : results)
+    {
+        endpoints.push_back(result.endpoint());
+    }
+
+    return endpoints;
+}
+
+system_resolver::system_resolver()
+    : io_context_(),
+      lookup_pool_(detail::lookup_pool::create([](const std::string & hostname, std::uint16_t port)
+      {
+          boost::asio::io_context io_context;
+          boost::system::error_code ec;
+
+          std::vector<boost::asio::ip::tcp::endpoint> endpoints = resolve_hostname(io_context, hostname, port, ec);
+
+          return detail::lookup_pool::result(std::move(endpoints), ec);
+      }))
+{
+}
+
+std::vector<boost::asio::ip::tcp::endpoint> system_resolver::resolve(std::string_view hostname,
+                                                                     std::uint16_t port,
+                                                                     boost::system::error_code & ec)
+{
+    return resolve_hostname(io_context_, hostname, port, ec);
+}
+
+std::vector<boost::asio::ip::tcp::endpoint>
+system_resolver::resolve(std::string_view hostname,
+                         std::uint16_t port,
+                         const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                         boost::system::error_code & ec)
+{
+    if (!deadline)
+    {
+        return resolve(hostname, port, ec);
+    }
+
+    /* getaddrinfo() cannot be interrupted, the lookup outlives a timed out request. */
+    detail::lookup_pool::result result = lookup_pool_->lookup(hostname, port, deadline.value());
+
+    ec = result.second;
+    return std::move(result.first);
+}
+
+caching_resolver::caching_resolver()
+    : caching_resolver(std::make_shared<system_resolver>())
+{
+}
+
+caching_resolver::caching_resolver(resolver_ptr upstream,
+                                   std::chrono::milliseconds ttl,
+                                   std::chrono::milliseconds negative_ttl)
+    : upstream_(std::move(upstream)),
+      ttl_(ttl),
+      negative_ttl_(negative_ttl)
+{
+}
+
+std::vector<boost::asio::ip::tcp::endpoint> caching_resolver::resolve(std::string_view hostname,
+                                                                      std::uint16_t port,
+                                                                      boost::system::error_code & ec)
+{
+    return resolve(hostname, port, std::nullopt, ec);
+}
+
+std::vector<boost::asio::ip::tcp::endpoint>
+caching_resolver::resolve(std::string_view hostname,
+                          std::uint16_t port,
+                          const std::optional<std::chrono::steady_clock::time_point> & deadline,
+                          boost::system::error_code & ec)
+{
+    std::string key(hostname);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+        auto it = entries_.find(key);
+
+        if (it == entries_.end())
+        {
+            break;
+        }
+
+        const entry & entry = it->second;
+
+        if (entry.pending)
+        {
+            /* Another thread is resolving the same hostname. */
+            if (!deadline)
+            {
+                pending_cv_.wait(lock);
+            }
+            else if (pending_cv_.wait_until(lock, deadline.value()) == std::cv_status::timeout)
+            {
+                ec = boost::asio::error::timed_out;
+                return {};
+            }
+
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() < entry.expiry)
+        {
+            ec = entry.ec;
+            return get_endpoints(entry, port);
+        }
+
+        break;
+    }
+
+    entries_[key].pending = true;
+    lock.unlock();
+
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints;
+
+    try
+    {
+        endpoints = upstream_->resolve(hostname, port, deadline, ec);
+    }
+    catch (...)
+    {
+        lock.lock();
+        entries_.erase(key);
+        pending_cv_.notify_all();
+        throw;
+    }
+
+    lock.lock();
+
+    /* The timeout is the one of this request, the others may wait longer. */
+    if (ec == boost::asio::error::timed_out)
+    {
+        entries_.erase(key);
+        pending_cv_.notify_all();
+        return endpoints;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    remove_expired_entries(now);
+
+    entry & entry = entries_[key];
+    entry.endpoints = endpoints;
+    entry.ec = ec;
+    entry.expiry = now + (ec ? negative_ttl_ : ttl_);
+    entry.pending = false;
+
+    pending_cv_.notify_all();
+
+    return endpoints;
+}
+
+void caching_resolver::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        /* Pending entries are owned by the resolving threads. */
+        if (it->second.pending)
+        {
+            ++it;
+        }
+        else
+        {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+void caching_resolver::remove_expired_entries(std::chrono::steady_clock::time_point now)
+{
+    for (auto it = entries_.begin(); it != entries_.end();)
+    {
+        if (!it->second.pending && it->second.expiry <= now)
+        {
+            it = entries_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+std::vector<boost::asio::ip::tcp::endpoint> caching_resolver::get_endpoints(const entry & entry, std::uint16_t port)
+{
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints = entry.endpoints;
+
+    /* The cache is keyed by hostname only. */
+    for (boost::asio::ip::tcp::endpoint & endpoint : endpoints)
+    {
+        endpoint.port(port);
+    }
+
+    return endpoints;
+}
+
+static std::mutex default_resolver_mutex;
+
+static resolver_ptr & get_default_resolver_instance()
+{
+    static resolver_ptr instance = std::make_shared<caching_resolver>();
+    return instance;
+}
+
+resolver_ptr get_default_resolver()
+{
+    std::lock_guard<std::mutex> lock(default_resolver_mutex);
+
+    return get_default_resolver_instance();
+}
+
+void set_default_resolver(resolver_ptr resolver)
+{
+    std::lock_guard<std::mutex> lock(default_resolver_mutex);
+
+    if (resolver)
+    {
+        get_default_resolver_instance() = std::move(resolver);
+    }
+    else
+    {
+        get_default_resolver_instance() = std::make_shared<caching_resolver>();
+    }
+}
+
+} // namespace ftp
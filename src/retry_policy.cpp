@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/retry_policy.hpp>
+#include <ftp/error.hpp>
+#include <algorithm>
+
+namespace ftp
+{
+
+exponential_backoff::exponential_backoff(std::size_t max_attempts,
+                                         std::chrono::milliseconds initial_delay,
+                                         std::chrono::milliseconds max_delay,
+                                         std::vector<std::uint16_t> retryable_codes)
+    : max_attempts_(max_attempts),
+      initial_delay_(initial_delay),
+      max_delay_(std::max(initial_delay, max_delay)),
+      retryable_codes_(std::move(retryable_codes)),
+      random_(std::random_device()())
+{
+}
+
+std::optional<std::chrono::milliseconds> exponential_backoff::get_retry_delay(std::size_t attempt,
+                                                                              const std::optional<reply> & reply,
+                                                                              const boost::system::error_code & ec)
+{
+    if (attempt >= max_attempts_ || !is_retryable(reply, ec))
+    {
+        return std::nullopt;
+    }
+
+    /* Double the delay up to the limit, without overflowing it. */
+    std::chrono::milliseconds delay = initial_delay_;
+
+    for (std::size_t i = 1; i < attempt && delay < max_delay_; i++)
+    {
+        delay = std::min(delay * 2, max_delay_);
+    }
+
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution(delay.count() / 2, delay.count());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return std::chrono::milliseconds(distribution(random_));
+}
+
+std::size_t exponential_backoff::get_max_attempts() const
+{
+    return max_attempts_;
+}
+
+std::chrono::milliseconds exponential_backoff::get_initial_delay() const
+{
+    return initial_delay_;
+}
+
+std::chrono::milliseconds exponential_backoff::get_max_delay() const
+{
+    return max_delay_;
+}
+
+const std::vector<std::uint16_t> & exponential_backoff::get_retryable_codes() const
+{
+    return retryable_codes_;
+}
+
+bool exponential_backoff::is_retryable(const std::optional<reply> & reply, const boost::system::error_code & ec) const
+{
+    if (reply)
+    {
+        return std::find(retryable_codes_.begin(), retryable_codes_.end(), reply->get_code()) != retryable_codes_.end();
+    }
+
+    /* The client has run out of time, the next attempt fails as well. */
+    if (ec == error::deadline_exceeded)
+    {
+        return false;
+    }
+
+    return static_cast<bool>(ec);
+}
+
+} // namespace ftp
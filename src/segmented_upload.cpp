@@ -0,0 +1,397 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/segmented_upload.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace ftp
+{
+
+namespace
+{
+
+/* Calls the function when the data connection of the transfer is open. */
+class begin_callback : public transfer_callback
+{
+public:
+    explicit begin_callback(std::function<void()> function)
+        : function_(std::move(function))
+    {
+    }
+
+    void begin() override
+    {
+        function_();
+    }
+
+private:
+    std::function<void()> function_;
+};
+
+/* Reads a segment of a file. The file is not mapped: if another process
+ * truncates it during the upload, the segment is short and the size of
+ * the remote file is found to differ, instead of a SIGBUS.
+ */
+class file_segment_stream : public input_stream
+{
+public:
+    file_segment_stream(const std::filesystem::path & path, std::uint64_t offset, std::uint64_t size)
+        : ifs_(path, std::ios_base::binary),
+          remaining_(size)
+    {
+        if (!ifs_)
+        {
+            throw ftp_exception("Cannot open file '%1%'.", path.string());
+        }
+
+        ifs_.seekg(static_cast<std::streamoff>(offset));
+
+        if (!ifs_)
+        {
+            throw ftp_exception("Cannot seek file '%1%'.", path.string());
+        }
+    }
+
+    std::size_t read(char *buf, std::size_t size) override
+    {
+        size = static_cast<std::size_t>(std::min<std::uint64_t>(size, remaining_));
+
+        ifs_.read(buf, static_cast<std::streamsize>(size));
+
+        if (ifs_.bad())
+        {
+            throw ftp_exception("Cannot read file.");
+        }
+
+        std::size_t read_size = static_cast<std::size_t>(ifs_.gcount());
+        remaining_ -= read_size;
+
+        return read_size;
+    }
+
+private:
+    std::ifstream ifs_;
+    std::uint64_t remaining_;
+};
+
+} // namespace
+
+segmented_upload::segmented_upload(client_factory factory,
+                                   std::size_t connection_count,
+                                   std::uint64_t min_segment_size)
+    : client_factory_(std::move(factory)),
+      connection_count_(std::max<std::size_t>(connection_count, 1)),
+      min_segment_size_(std::max<std::uint64_t>(min_segment_size, 1)),
+      clients_(),
+      mutex_(),
+      cv_(),
+      segments_(),
+      pending_(),
+      file_created_(false),
+      sequential_(false),
+      error_()
+{
+}
+
+void segmented_upload::upload(const std::filesystem::path & local_path, std::string_view remote_path)
+{
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(local_path, ec);
+
+    if (ec)
+    {
+        throw ftp_exception("Cannot get size of file '%1%': %2%", local_path.string(), ec.message());
+    }
+
+    upload([&local_path](std::uint64_t offset, std::uint64_t size)
+    {
+        return std::make_unique<file_segment_stream>(local_path, offset, size);
+    }, size, remote_path);
+}
+
+void segmented_upload::upload(const source_factory & source, std::uint64_t size, std::string_view remote_path)
+{
+    std::size_t count = static_cast<std::size_t>(
+        std::clamp<std::uint64_t>(size / min_segment_size_, 1, connection_count_));
+
+    segments_.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint64_t offset = size / count * i;
+        std::uint64_t end = (i + 1 == count) ? size : size / count * (i + 1);
+
+        segments_.push_back({ offset, end - offset, false, false });
+    }
+
+    pending_.clear();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        pending_.push_back(i);
+    }
+
+    file_created_ = false;
+    sequential_ = false;
+    error_ = nullptr;
+
+    if (clients_.size() < count)
+    {
+        clients_.resize(count);
+    }
+
+    if (count == 1)
+    {
+        run_worker(clients_[0], source, remote_path);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            workers.emplace_back([this, i, &source, remote_path]()
+            {
+                run_worker(clients_[i], source, remote_path);
+            });
+        }
+
+        for (std::thread & worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    if (error_)
+    {
+        std::rethrow_exception(error_);
+    }
+
+    /* A worker may have found no segment left for it. */
+    auto it = std::find_if(clients_.begin(), clients_.end(), [](const std::unique_ptr<client> & client)
+    {
+        return client != nullptr;
+    });
+
+    file_size_reply reply = (*it)->get_file_size(remote_path);
+
+    if (reply.get_size() != size)
+    {
+        throw ftp_exception("Cannot verify upload. The remote file size is not %1%: '%2%'.",
+                            size, reply.get_status_string());
+    }
+}
+
+void segmented_upload::close()
+{
+    for (std::unique_ptr<client> & client : clients_)
+    {
+        if (client)
+        {
+            client->disconnect();
+        }
+    }
+
+    clients_.clear();
+}
+
+std::size_t segmented_upload::get_connection_count() const
+{
+    return connection_count_;
+}
+
+std::uint64_t segmented_upload::get_min_segment_size() const
+{
+    return min_segment_size_;
+}
+
+void segmented_upload::run_worker(std::unique_ptr<client> & client,
+                                  const source_factory & source,
+                                  std::string_view remote_path)
+{
+    try
+    {
+        std::size_t index;
+
+        while (take_segment(index))
+        {
+            if (!client)
+            {
+                client = client_factory_();
+            }
+
+            if (upload_segment(*client, index, source, remote_path))
+            {
+                complete_segment(index);
+            }
+            else
+            {
+                defer_segment(index);
+            }
+        }
+    }
+    catch (...)
+    {
+        /* The client may be in any state, the next upload opens a new one. */
+        client.reset();
+
+        fail(std::current_exception());
+    }
+}
+
+bool segmented_upload::take_segment(std::size_t & index)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+        if (error_ || pending_.empty())
+        {
+            return false;
+        }
+
+        for (auto it = pending_.begin(); it != pending_.end(); ++it)
+        {
+            if (can_start(*it))
+            {
+                index = *it;
+                pending_.erase(it);
+                return true;
+            }
+        }
+
+        cv_.wait(lock);
+    }
+}
+
+bool segmented_upload::can_start(std::size_t index) const
+{
+    if (index == 0)
+    {
+        return true;
+    }
+
+    if (!file_created_)
+    {
+        return false;
+    }
+
+    if (sequential_ || segments_[index].deferred)
+    {
+        return std::all_of(segments_.begin(), segments_.begin() + index, [](const segment & segment)
+        {
+            return segment.completed;
+        });
+    }
+
+    return true;
+}
+
+bool segmented_upload::upload_segment(client & client,
+                                      std::size_t index,
+                                      const source_factory & source,
+                                      std::string_view remote_path)
+{
+    /* The offset and the size do not change during the upload. */
+    std::uint64_t offset = segments_[index].offset;
+    std::uint64_t size = segments_[index].size;
+
+    input_stream_ptr stream = source(offset, size);
+    replies replies;
+
+    if (index == 0)
+    {
+        /* STOR truncates the file, so the other segments wait until it is open. */
+        begin_callback callback([this]() { set_file_created(); });
+
+        replies = client.upload_file(*stream, remote_path, false, &callback);
+    }
+    else
+    {
+        replies = client.resume_upload(*stream, remote_path, std::to_string(offset));
+    }
+
+    if (replies.is_positive())
+    {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (index > 0 && !segments_[index].deferred)
+        {
+            return false;
+        }
+    }
+
+    throw ftp_exception("Cannot upload segment at offset %1%: '%2%'.", offset, replies.get_status_string());
+}
+
+void segmented_upload::complete_segment(std::size_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    segments_[index].completed = true;
+    cv_.notify_all();
+}
+
+void segmented_upload::defer_segment(std::size_t index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    segments_[index].deferred = true;
+    sequential_ = true;
+
+    /* The pending segments are kept in the order of their offsets. */
+    pending_.insert(std::lower_bound(pending_.begin(), pending_.end(), index), index);
+    cv_.notify_all();
+}
+
+void segmented_upload::fail(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!error_)
+    {
+        error_ = std::move(error);
+    }
+
+    cv_.notify_all();
+}
+
+void segmented_upload::set_file_created()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    file_created_ = true;
+    cv_.notify_all();
+}
+
+} // namespace ftp
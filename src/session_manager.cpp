@@ -0,0 +1,163 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/session_manager.hpp>
+#include <algorithm>
+#include <thread>
+
+namespace ftp
+{
+
+using namespace ftp::detail;
+
+session::session(shard_ptr shard, std::string_view hostname, ssl::context_ptr && ssl_context)
+    : shard_(std::move(shard)),
+      hostname_(hostname),
+      client_(new client(shard_->get_net_context(), std::move(ssl_context)))
+{
+}
+
+session::~session()
+{
+    shard_->remove_session();
+
+    /* The sockets of the client belong to the net context of the shard. */
+    if (shard_->is_current_thread())
+    {
+        client_.reset();
+        return;
+    }
+
+    /* A shard thread does not wait for another one: two shards releasing
+     * the sessions of each other would wait for each other forever.
+     */
+    if (shard::is_shard_thread())
+    {
+        auto client = std::make_shared<std::unique_ptr<ftp::client>>(std::move(client_));
+
+        if (!shard_->post([client]() { client->reset(); }))
+        {
+            client->reset();
+        }
+
+        return;
+    }
+
+    std::promise<void> destroyed;
+    std::future<void> future = destroyed.get_future();
+
+    if (shard_->post([this, &destroyed]()
+        {
+            client_.reset();
+            destroyed.set_value();
+        }))
+    {
+        future.wait();
+    }
+    else
+    {
+        /* The shard is stopped, its thread does not use the net context anymore. */
+        client_.reset();
+    }
+}
+
+const std::string & session::get_hostname() const
+{
+    return hostname_;
+}
+
+std::size_t session::get_shard_index() const
+{
+    return shard_->get_index();
+}
+
+session_manager::session_manager(std::size_t shard_count, bool pin_threads)
+    : shards_(),
+      mutex_()
+{
+    std::size_t cpu_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (shard_count == 0)
+    {
+        shard_count = cpu_count;
+    }
+
+    for (std::size_t i = 0; i < shard_count; ++i)
+    {
+        std::optional<std::size_t> cpu = pin_threads ? std::optional<std::size_t>(i % cpu_count) : std::nullopt;
+
+        shards_.push_back(std::make_shared<shard>(i, cpu));
+    }
+}
+
+session_manager::~session_manager()
+{
+    for (const shard_ptr & shard : shards_)
+    {
+        shard->stop();
+    }
+}
+
+session_ptr session_manager::create_session(std::string_view hostname, ssl::context_ptr && ssl_context)
+{
+    shard_ptr shard = select_shard();
+
+    try
+    {
+        return session_ptr(new session(shard, hostname, std::move(ssl_context)));
+    }
+    catch (...)
+    {
+        shard->remove_session();
+        throw;
+    }
+}
+
+std::size_t session_manager::get_shard_count() const
+{
+    return shards_.size();
+}
+
+std::size_t session_manager::get_session_count(std::size_t shard_index) const
+{
+    return shards_.at(shard_index)->get_session_count();
+}
+
+shard_ptr session_manager::select_shard()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    shard_ptr selected = *std::min_element(shards_.begin(), shards_.end(),
+        [](const shard_ptr & lhs, const shard_ptr & rhs)
+        {
+            return lhs->get_session_count() < rhs->get_session_count();
+        });
+
+    selected->add_session();
+
+    return selected;
+}
+
+} // namespace ftp
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/detail/shard.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ftp::detail
+{
+
+static thread_local bool shard_thread = false;
+
+shard::shard(std::size_t index, const std::optional<std::size_t> & cpu)
+    : index_(index),
+      cpu_(cpu),
+      /* Only the thread of the shard runs the io_context. */
+      net_context_(std::make_shared<net_context>(1)),
+      session_count_(0),
+      mutex_(),
+      cv_(),
+      tasks_(),
+      stopped_(false),
+      thread_(&shard::run, this)
+{
+}
+
+shard::~shard()
+{
+    stop();
+}
+
+std::size_t shard::get_index() const
+{
+    return index_;
+}
+
+net_context_ptr shard::get_net_context() const
+{
+    return net_context_;
+}
+
+bool shard::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (stopped_)
+        {
+            return false;
+        }
+
+        tasks_.push_back(std::move(task));
+    }
+
+    cv_.notify_one();
+
+    return true;
+}
+
+void shard::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+
+    cv_.notify_one();
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+bool shard::is_stopped()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return stopped_;
+}
+
+bool shard::is_current_thread() const
+{
+    return thread_.get_id() == std::this_thread::get_id();
+}
+
+bool shard::is_shard_thread()
+{
+    return shard_thread;
+}
+
+void shard::add_session()
+{
+    session_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void shard::remove_session()
+{
+    session_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::size_t shard::get_session_count() const
+{
+    return session_count_.load(std::memory_order_relaxed);
+}
+
+void shard::run()
+{
+    shard_thread = true;
+
+    if (cpu_)
+    {
+        pin_thread(cpu_.value());
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+        cv_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+
+        if (tasks_.empty())
+        {
+            /* Stopped, all the queued tasks are done. */
+            break;
+        }
+
+        std::function<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+/* Pinning is best effort: a thread that cannot be pinned runs on any CPU. */
+void shard::pin_thread(std::size_t cpu)
+{
+#ifdef _WIN32
+    if (cpu < sizeof(DWORD_PTR) * 8)
+    {
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+    }
+#elif defined(__linux__)
+    if (cpu < CPU_SETSIZE)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    }
+#else
+    (void) cpu;
+#endif
+}
+
+} // namespace ftp::detail
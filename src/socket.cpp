@@ -23,7 +23,6 @@
  */
 
 #include <ftp/detail/socket.hpp>
-#include <boost/asio/connect.hpp>
 
 namespace ftp::detail
 {
@@ -36,14 +35,9 @@ socket::socket(boost::asio::ip::tcp::socket && socket)
     : socket_(std::move(socket))
 {}
 
-void socket::connect(const boost::asio::ip::tcp::resolver::results_type & eps, boost::system::error_code & ec)
-{
-    boost::asio::connect(socket_, eps, ec);
-}
-
 void socket::connect(const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec)
 {
-    socket_.connect(ep, ec);
+    socket_base::connect(socket_, ep, ec);
 }
 
 bool socket::is_connected() const
@@ -82,6 +76,11 @@ std::size_t socket::write(std::string_view buf, boost::system::error_code & ec)
     return socket_base::write(socket_, buf, ec);
 }
 
+std::size_t socket::write(std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec)
+{
+    return socket_base::write(socket_, buffers, ec);
+}
+
 std::size_t socket::read_some(char *buf, std::size_t max_size, boost::system::error_code & ec)
 {
     return socket_base::read_some(socket_, buf, max_size, ec);
@@ -0,0 +1,70 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/span_input_stream.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ftp
+{
+
+span_input_stream::span_input_stream(const char *data, std::size_t size)
+    : data_(data, size),
+      position_(0)
+{
+}
+
+span_input_stream::span_input_stream(std::string_view data)
+    : data_(data),
+      position_(0)
+{
+}
+
+std::size_t span_input_stream::read(char *buf, std::size_t size)
+{
+    std::size_t read_size = std::min(size, data_.size() - position_);
+
+    std::memcpy(buf, data_.data() + position_, read_size);
+    position_ += read_size;
+
+    return read_size;
+}
+
+std::optional<std::string_view> span_input_stream::peek(std::size_t max_size)
+{
+    return data_.substr(position_, max_size);
+}
+
+void span_input_stream::consume(std::size_t size)
+{
+    position_ += std::min(size, data_.size() - position_);
+}
+
+std::size_t span_input_stream::get_size() const
+{
+    return data_.size();
+}
+
+} // namespace ftp
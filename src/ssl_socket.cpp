@@ -23,7 +23,6 @@
  */
 
 #include <ftp/detail/ssl_socket.hpp>
-#include <boost/asio/connect.hpp>
 
 namespace ftp::detail
 {
@@ -39,14 +38,9 @@ ssl_socket::ssl_socket(boost::asio::ip::tcp::socket && socket,
     }
 }
 
-void ssl_socket::connect(const boost::asio::ip::tcp::resolver::results_type & eps, boost::system::error_code & ec)
-{
-    boost::asio::connect(socket_.lowest_layer(), eps, ec);
-}
-
 void ssl_socket::connect(const boost::asio::ip::tcp::endpoint & ep, boost::system::error_code & ec)
 {
-    socket_.lowest_layer().connect(ep, ec);
+    socket_base::connect(socket_, ep, ec);
 }
 
 bool ssl_socket::is_connected() const
@@ -61,11 +55,35 @@ bool ssl_socket::has_ssl_support() const
 
 void ssl_socket::ssl_handshake(boost::asio::ssl::stream_base::handshake_type type, boost::system::error_code & ec)
 {
+    if (deadline_)
+    {
+        run_until_deadline(socket_, [this, type](auto handler)
+        {
+            socket_.async_handshake(type, [handler](const boost::system::error_code & ec) mutable
+            {
+                handler(ec, 0);
+            });
+        }, ec);
+        return;
+    }
+
     socket_.handshake(type, ec);
 }
 
 void ssl_socket::ssl_shutdown(boost::system::error_code & ec)
 {
+    if (deadline_)
+    {
+        run_until_deadline(socket_, [this](auto handler)
+        {
+            socket_.async_shutdown([handler](const boost::system::error_code & ec) mutable
+            {
+                handler(ec, 0);
+            });
+        }, ec);
+        return;
+    }
+
     socket_.shutdown(ec);
 }
 
@@ -84,6 +102,11 @@ std::size_t ssl_socket::write(std::string_view buf, boost::system::error_code &
     return socket_base::write(socket_, buf, ec);
 }
 
+std::size_t ssl_socket::write(std::initializer_list<boost::asio::const_buffer> buffers, boost::system::error_code & ec)
+{
+    return socket_base::write(socket_, buffers, ec);
+}
+
 std::size_t ssl_socket::read_some(char *buf, std::size_t max_size, boost::system::error_code & ec)
 {
     return socket_base::read_some(socket_, buf, max_size, ec);
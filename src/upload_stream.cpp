@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <ftp/stream/upload_stream.hpp>
+#include <ftp/client.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ftp
+{
+
+using namespace ftp::detail;
+
+upload_stream::chunk_istream::chunk_istream()
+    : data_(nullptr),
+      size_(0)
+{
+}
+
+void upload_stream::chunk_istream::reset(const char *data, std::size_t size)
+{
+    data_ = data;
+    size_ = size;
+}
+
+std::size_t upload_stream::chunk_istream::read(char *buf, std::size_t size)
+{
+    std::size_t read_size = std::min(size, size_);
+
+    std::memcpy(buf, data_, read_size);
+    data_ += read_size;
+    size_ -= read_size;
+
+    return read_size;
+}
+
+upload_stream::upload_stream(client & client,
+                             std::unique_lock<command_queue> && lock,
+                             data_connection_ptr && connection,
+                             replies && replies)
+    : client_(client),
+      lock_(std::move(lock)),
+      connection_(std::move(connection)),
+      replies_(std::move(replies)),
+      hasher_(client_.create_transfer_hasher(std::nullopt)),
+      compressor_(),
+      chunk_(),
+      converter_(client_.create_input_stream(chunk_)),
+      converted_(),
+      compressed_(),
+      closed_(false)
+{
+    client_.stream_open_ = true;
+
+    if (connection_)
+    {
+        client_.set_active_connection(connection_.get());
+    }
+
+    if (client_.transmission_mode_ == transmission_mode::zlib)
+    {
+        compressor_ = std::make_unique<zlib_compressor>();
+    }
+
+    if (converter_)
+    {
+        converted_.resize(client_.transfer_buffer_size_);
+    }
+}
+
+upload_stream::~upload_stream()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+        /* The errors are reported by close(). */
+    }
+}
+
+void upload_stream::write(char *buf, std::size_t size)
+{
+    if (!connection_)
+    {
+        throw ftp_exception("Cannot send data over data connection: the stream is closed.");
+    }
+
+    if (!converter_)
+    {
+        send(buf, size);
+        return;
+    }
+
+    chunk_.reset(buf, size);
+
+    for (;;)
+    {
+        std::size_t converted_size = converter_->read(converted_.data(), converted_.size());
+
+        if (converted_size == 0)
+        {
+            break;
+        }
+
+        send(converted_.data(), converted_size);
+    }
+}
+
+void upload_stream::flush()
+{
+}
+
+bool upload_stream::is_open() const
+{
+    return connection_ != nullptr;
+}
+
+replies upload_stream::close()
+{
+    if (closed_)
+    {
+        return replies_;
+    }
+
+    closed_ = true;
+    client_.stream_open_ = false;
+
+    client_.set_active_connection(nullptr);
+
+    if (connection_ && client_.is_abort_requested())
+    {
+        /* The data connection is shut down already. */
+        connection_->close();
+        connection_.reset();
+
+        client_.process_abort(replies_, true);
+    }
+    else if (connection_)
+    {
+        if (compressor_)
+        {
+            compressed_.clear();
+            compressor_->finish(compressed_);
+            connection_->write_some(compressed_.data(), compressed_.size());
+        }
+
+        client_.finish_data_connection(std::move(connection_), replies_);
+        client_.finish_transfer_hash(hasher_.get(), replies_);
+    }
+
+    if (lock_.owns_lock())
+    {
+        lock_.unlock();
+    }
+
+    return replies_;
+}
+
+void upload_stream::send(const char *data, std::size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (client_.is_abort_requested())
+    {
+        throw ftp_exception("Cannot send data over data connection: the transfer is aborted.");
+    }
+
+    if (hasher_)
+    {
+        hasher_->update(data, size);
+    }
+
+    try
+    {
+        if (compressor_)
+        {
+            compressed_.clear();
+            compressor_->compress(data, size, compressed_);
+            connection_->write_some(compressed_.data(), compressed_.size());
+        }
+        else
+        {
+            connection_->write_some(data, size);
+        }
+    }
+    catch (const ftp_exception &)
+    {
+        /* The interrupted socket fails the write. */
+        if (client_.is_abort_requested())
+        {
+            throw ftp_exception("Cannot send data over data connection: the transfer is aborted.");
+        }
+
+        throw;
+    }
+}
+
+} // namespace ftp
@@ -23,6 +23,8 @@
  */
 
 #include <ftp/detail/utils.hpp>
+#include <algorithm>
+#include <cctype>
 
 namespace ftp::detail::utils
 {
@@ -57,6 +59,14 @@ std::vector<std::string> split_string(std::string_view str, char del)
     return result;
 }
 
+bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char a, char b)
+    {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
 bool try_parse_uint8(std::string_view str, std::uint8_t & result)
 {
     std::uint64_t value;
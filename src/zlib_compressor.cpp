@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <ftp/detail/zlib_compressor.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <array>
+
+#ifdef LIBFTP_WITH_ZLIB
+#include <zlib.h>
+#else
+/* Never instantiated, only completes the type for std::unique_ptr. */
+struct z_stream_s {};
+#endif
+
+namespace ftp::detail
+{
+
+#ifdef LIBFTP_WITH_ZLIB
+
+zlib_compressor::zlib_compressor()
+    : stream_(std::make_unique<z_stream>())
+{
+    if (deflateInit(stream_.get(), Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        throw ftp_exception("Cannot initialize deflate stream.");
+    }
+}
+
+zlib_compressor::~zlib_compressor()
+{
+    deflateEnd(stream_.get());
+}
+
+void zlib_compressor::compress(const char *data, std::size_t size, std::vector<char> & output)
+{
+    stream_->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream_->avail_in = static_cast<uInt>(size);
+
+    process(Z_NO_FLUSH, output);
+}
+
+void zlib_compressor::finish(std::vector<char> & output)
+{
+    stream_->next_in = nullptr;
+    stream_->avail_in = 0;
+
+    process(Z_FINISH, output);
+}
+
+bool zlib_compressor::is_available()
+{
+    return true;
+}
+
+void zlib_compressor::process(int flush, std::vector<char> & output)
+{
+    std::array<Bytef, 8192> buf;
+    int result;
+
+    do
+    {
+        stream_->next_out = buf.data();
+        stream_->avail_out = static_cast<uInt>(buf.size());
+
+        result = deflate(stream_.get(), flush);
+
+        if (result == Z_STREAM_ERROR)
+        {
+            throw ftp_exception("Cannot compress data.");
+        }
+
+        std::size_t size = buf.size() - stream_->avail_out;
+        output.insert(output.end(), buf.data(), buf.data() + size);
+    }
+    while (stream_->avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+}
+
+zlib_decompressor::zlib_decompressor()
+    : stream_(std::make_unique<z_stream>()),
+      finished_(false)
+{
+    if (inflateInit(stream_.get()) != Z_OK)
+    {
+        throw ftp_exception("Cannot initialize inflate stream.");
+    }
+}
+
+zlib_decompressor::~zlib_decompressor()
+{
+    inflateEnd(stream_.get());
+}
+
+void zlib_decompressor::set_input(const char *data, std::size_t size)
+{
+    stream_->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream_->avail_in = static_cast<uInt>(size);
+}
+
+std::size_t zlib_decompressor::decompress(char *buf, std::size_t size)
+{
+    /* The data after the end of the compressed stream is ignored. */
+    if (finished_ || size == 0)
+    {
+        return 0;
+    }
+
+    stream_->next_out = reinterpret_cast<Bytef *>(buf);
+    stream_->avail_out = static_cast<uInt>(size);
+
+    /* The output pending in the inflate state is returned even if the input is used up. */
+    int result = inflate(stream_.get(), Z_NO_FLUSH);
+
+    if (result == Z_STREAM_END)
+    {
+        finished_ = true;
+    }
+    else if (result != Z_OK && result != Z_BUF_ERROR)
+    {
+        throw ftp_exception("Cannot decompress data: %1%", stream_->msg ? stream_->msg : "invalid data");
+    }
+
+    return size - stream_->avail_out;
+}
+
+bool zlib_decompressor::is_finished() const
+{
+    return finished_;
+}
+
+#else
+
+zlib_compressor::zlib_compressor()
+{
+    throw ftp_exception("MODE Z is not supported. The library is built without zlib.");
+}
+
+zlib_compressor::~zlib_compressor() = default;
+
+void zlib_compressor::compress(const char *data, std::size_t size, std::vector<char> & output)
+{}
+
+void zlib_compressor::finish(std::vector<char> & output)
+{}
+
+bool zlib_compressor::is_available()
+{
+    return false;
+}
+
+void zlib_compressor::process(int flush, std::vector<char> & output)
+{}
+
+zlib_decompressor::zlib_decompressor()
+    : finished_(false)
+{
+    throw ftp_exception("MODE Z is not supported. The library is built without zlib.");
+}
+
+zlib_decompressor::~zlib_decompressor() = default;
+
+void zlib_decompressor::set_input(const char *data, std::size_t size)
+{}
+
+std::size_t zlib_decompressor::decompress(char *buf, std::size_t size)
+{
+    return 0;
+}
+
+bool zlib_decompressor::is_finished() const
+{
+    return finished_;
+}
+
+#endif
+
+} // namespace ftp::detail
@@ -0,0 +1,253 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/async_logger.hpp>
+#include <ftp/stream/ostream_adapter.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ftp::async_logger;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/* Blocks the writes until it is opened. */
+class gated_ostream : public ftp::output_stream
+{
+public:
+    explicit gated_ostream(ftp::output_stream & dst)
+        : dst_(dst),
+          open_(false),
+          waiting_(false)
+    {
+    }
+
+    void write(char *buf, std::size_t size) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiting_ = true;
+        cv_.notify_all();
+        cv_.wait(lock, [this] { return open_; });
+        dst_.write(buf, size);
+    }
+
+    void flush() override
+    {
+        dst_.flush();
+    }
+
+    void wait_write()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return waiting_; });
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    ftp::output_stream & dst_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool open_;
+    bool waiting_;
+};
+
+class failing_ostream : public ftp::output_stream
+{
+public:
+    void write(char *buf, std::size_t size) override
+    {
+        throw std::runtime_error("write error");
+    }
+
+    void flush() override
+    {
+    }
+};
+
+} // namespace
+
+TEST(async_logger, text)
+{
+    std::ostringstream oss;
+    ftp::ostream_adapter dst(oss);
+
+    {
+        async_logger logger(dst);
+
+        ASSERT_EQ(async_logger::format::text, logger.get_format());
+
+        logger.on_connected("localhost", 2121);
+        logger.on_reply(ftp::reply(220, "220 FTP server is ready."));
+        logger.on_request("USER user");
+        logger.on_request("PASS password");
+        logger.on_reply(ftp::reply(230, "230 Login successful."));
+        logger.flush();
+
+        ASSERT_EQ("-- Connected to localhost on port 2121.\n"
+                  "<- 220 FTP server is ready.\n"
+                  "-> USER user\n"
+                  "-> PASS *****\n"
+                  "<- 230 Login successful.\n", oss.str());
+
+        /* The destruction writes the rest. */
+        logger.on_request("QUIT");
+    }
+
+    ASSERT_EQ(std::string::npos, oss.str().find("password"));
+    ASSERT_EQ(oss.str().size() - 8, oss.str().rfind("-> QUIT\n"));
+}
+
+TEST(async_logger, binary)
+{
+    std::ostringstream oss;
+    ftp::ostream_adapter dst(oss);
+    async_logger logger(dst, async_logger::format::binary);
+
+    logger.on_request("NOOP");
+    logger.flush();
+
+    std::string data = oss.str();
+
+    ASSERT_EQ(8 + 1 + 2 + 4, data.size());
+
+    std::uint64_t timestamp = 0;
+    for (int i = 7; i >= 0; --i)
+    {
+        timestamp = (timestamp << 8) | static_cast<unsigned char>(data[i]);
+    }
+
+    std::uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    ASSERT_LE(timestamp, now);
+    ASSERT_GT(timestamp, now - std::chrono::duration_cast<std::chrono::nanoseconds>(1min).count());
+    ASSERT_EQ(static_cast<char>(async_logger::event_type::request), data[8]);
+    ASSERT_EQ(4, data[9]);
+    ASSERT_EQ(0, data[10]);
+    ASSERT_EQ("NOOP", data.substr(11));
+}
+
+TEST(async_logger, drop_events)
+{
+    std::ostringstream oss;
+    ftp::ostream_adapter adapter(oss);
+    gated_ostream dst(adapter);
+    async_logger logger(dst, async_logger::format::text, 2, 1ms);
+
+    logger.on_request("NOOP 1");
+
+    /* The writer has taken the first event and waits for the destination. */
+    dst.wait_write();
+
+    logger.on_request("NOOP 2");
+    logger.on_request("NOOP 3");
+    logger.on_request("NOOP 4");
+
+    ASSERT_EQ(1, logger.get_dropped_count());
+
+    dst.open();
+    logger.flush();
+
+    ASSERT_EQ("-> NOOP 1\n"
+              "-> NOOP 2\n"
+              "-> NOOP 3\n", oss.str());
+}
+
+TEST(async_logger, truncate_events)
+{
+    std::ostringstream oss;
+    ftp::ostream_adapter dst(oss);
+    async_logger logger(dst);
+
+    logger.on_request(std::string(async_logger::max_event_size + 10, 'x'));
+    logger.flush();
+
+    ASSERT_EQ(1, logger.get_truncated_count());
+    ASSERT_EQ("-> " + std::string(async_logger::max_event_size, 'x') + "\n", oss.str());
+}
+
+TEST(async_logger, error)
+{
+    failing_ostream dst;
+    async_logger logger(dst);
+
+    logger.on_request("NOOP");
+
+    ASSERT_THROW(logger.flush(), std::runtime_error);
+
+    logger.on_request("NOOP");
+
+    ASSERT_THROW(logger.flush(), std::runtime_error);
+    ASSERT_EQ(2, logger.get_dropped_count());
+}
+
+TEST(async_logger, producers)
+{
+    std::ostringstream oss;
+    ftp::ostream_adapter dst(oss);
+    async_logger logger(dst, async_logger::format::text, 1 << 16);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&logger]()
+        {
+            for (int j = 0; j < 1000; ++j)
+            {
+                logger.on_request("NOOP");
+            }
+        });
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    logger.flush();
+
+    ASSERT_EQ(0, logger.get_dropped_count());
+
+    std::string expected;
+    for (int i = 0; i < 4000; ++i)
+    {
+        expected += "-> NOOP\n";
+    }
+
+    ASSERT_EQ(expected, oss.str());
+}
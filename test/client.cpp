@@ -26,13 +26,34 @@
 #include <gmock/gmock.h>
 #include <gmock/gmock-matchers.h>
 #include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <thread>
 #include <ftp/client.hpp>
+#include <ftp/error.hpp>
 #include <ftp/ftp_exception.hpp>
 #include <ftp/observer.hpp>
+#include <ftp/segmented_upload.hpp>
+#include <ftp/session_manager.hpp>
 #include <ftp/ssl.hpp>
+#include <ftp/stream/download_stream.hpp>
+#include <ftp/stream/file_output_stream.hpp>
 #include <ftp/stream/istream_adapter.hpp>
+#include <ftp/stream/mapped_file_input_stream.hpp>
+#include <ftp/stream/memory_output_stream.hpp>
 #include <ftp/stream/ostream_adapter.hpp>
+#include <ftp/stream/pipelined_istream.hpp>
+#include <ftp/stream/pipelined_ostream.hpp>
+#include <ftp/stream/span_input_stream.hpp>
+#include <ftp/stream/upload_stream.hpp>
+#include <ftp/detail/zlib_compressor.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
 #include "test_server.hpp"
 #include "test_utils.hpp"
 
@@ -569,11 +590,12 @@ TEST_F(client, get_help)
     check_reply(client.get_help(),
                 CRLF("214-The following commands are recognized:",
                      " ABOR   ALLO   APPE   CDUP   CWD    DELE   EPRT   EPSV  ",
-                     " FEAT   HELP   LIST   MDTM   MFMT   MKD    MLSD   MLST  ",
-                     " MODE   NLST   NOOP   OPTS   PASS   PASV   PORT   PWD   ",
-                     " QUIT   REIN   REST   RETR   RMD    RNFR   RNTO   SITE  ",
-                     " SIZE   STAT   STOR   STOU   STRU   SYST   TYPE   USER  ",
-                     " XCUP   XCWD   XMKD   XPWD   XRMD  ",
+                     " FEAT   HASH   HELP   LIST   MDTM   MFMT   MKD    MLSD  ",
+                     " MLST   MODE   NLST   NOOP   OPTS   PASS   PASV   PORT  ",
+                     " PWD    QUIT   REIN   REST   RETR   RMD    RNFR   RNTO  ",
+                     " SITE   SIZE   STAT   STOR   STOU   STRU   SYST   TYPE  ",
+                     " USER   XCRC   XCUP   XCWD   XMD5   XMKD   XPWD   XRMD  ",
+                     " XSHA1  XSHA256 XSHA512",
                      "214 Help command successful."));
 
     check_reply(client.get_help("ABOR"), "214 Syntax: ABOR (abort transfer).");
@@ -1076,55 +1098,1766 @@ TEST_F(client, IPv6_open_connection)
     check_reply(client.disconnect(), "221 Goodbye.");
 }
 
+TEST_F(client, open_connection_by_hostname)
+{
+    ftp::client client;
+
+    /* The test server listens on both 127.0.0.1 and ::1. */
+    check_reply(client.connect("localhost", 2121, "user", "password"), CRLF("220 FTP server is ready.",
+                                                                             "331 Username ok, send password.",
+                                                                             "230 Login successful.",
+                                                                             "200 Type set to: Binary."));
+    ASSERT_TRUE(client.is_connected());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, custom_resolver)
+{
+    class test_resolver : public ftp::resolver
+    {
+    public:
+        using ftp::resolver::resolve;
+
+        std::vector<boost::asio::ip::tcp::endpoint> resolve(std::string_view hostname,
+                                                            std::uint16_t port,
+                                                            boost::system::error_code & ec) override
+        {
+            if (hostname == "ftp.test")
+            {
+                return { { boost::asio::ip::make_address("127.0.0.1"), port } };
+            }
+
+            ec = boost::asio::error::host_not_found;
+            return {};
+        }
+    };
+
+    ftp::client client;
+
+    EXPECT_FALSE(client.get_resolver());
+
+    auto resolver = std::make_shared<test_resolver>();
+    client.set_resolver(resolver);
+    EXPECT_EQ(resolver, client.get_resolver());
+
+    check_reply(client.connect("ftp.test", 2121), "220 FTP server is ready.");
+    check_reply(client.disconnect(), "221 Goodbye.");
+
+    ASSERT_THROW(client.connect("nonexistent.test", 2121), ftp::ftp_exception);
+    ASSERT_FALSE(client.is_connected());
+}
+
 TEST_P(client_with_transfer_mode, IPv6_upload_download_file)
 {
     ftp::transfer_mode mode = GetParam();
     ftp::client client(mode);
 
-    check_reply(client.connect("::1", 2121), "220 FTP server is ready.");
+    check_reply(client.connect("::1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data = "content";
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+class client_hash : public client,
+                    public testing::WithParamInterface<std::pair<ftp::hash_algorithm, std::string>>
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(all_algorithms, client_hash,
+                         testing::Values(std::make_pair(ftp::hash_algorithm::crc32,
+                                                        "fec530a9"),
+                                         std::make_pair(ftp::hash_algorithm::md5,
+                                                        "9a0364b9e99bb480dd25e1f0284c8555"),
+                                         std::make_pair(ftp::hash_algorithm::sha1,
+                                                        "040f06fd774092478d450774f5ba30c5da78acc8"),
+                                         std::make_pair(ftp::hash_algorithm::sha256,
+                                                        "ed7002b439e9ac845f22357d822bac14"
+                                                        "44730fbdb6016d3ec9432297b9ec9f73"),
+                                         std::make_pair(ftp::hash_algorithm::sha512,
+                                                        "b2d1d285b5199c85f988d03649c37e44fd3dde01e5d69c50fef90651962f4811"
+                                                        "0e9340b60d49a479c4c0b53f5f07d690686dd87d2481937a512e8b85ee7c617f")));
+
+TEST_P(client_hash, verify_file)
+{
+    auto [algorithm, expected_hash] = GetParam();
+    ftp::client client;
+
+    client.set_transfer_hash_algorithm(algorithm);
+    EXPECT_EQ(algorithm, client.get_transfer_hash_algorithm());
+    EXPECT_FALSE(client.get_last_transfer_hash().has_value());
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::istringstream iss("content");
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+    ASSERT_TRUE(client.get_last_transfer_hash().has_value());
+    EXPECT_EQ(expected_hash, client.get_last_transfer_hash().value());
+
+    EXPECT_TRUE(client.verify_file("file"));
+
+    ftp::file_hash_reply reply = client.get_file_hash("file", algorithm);
+    EXPECT_TRUE(reply.is_positive());
+    EXPECT_EQ(algorithm, reply.get_algorithm());
+    ASSERT_TRUE(reply.get_hash().has_value());
+    EXPECT_EQ(expected_hash, reply.get_hash().value());
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_TRUE(client.get_last_transfer_hash().has_value());
+    EXPECT_EQ(expected_hash, client.get_last_transfer_hash().value());
+
+    std::istringstream other_iss("other content");
+    check_last_reply(client.upload_file(ftp::istream_adapter(other_iss), "file"), "226 Transfer complete.");
+    EXPECT_FALSE(client.verify_file("file", algorithm, expected_hash));
+    EXPECT_TRUE(client.verify_file("file"));
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, verify_file_without_transfer_hash)
+{
+    ftp::client client;
+
+    EXPECT_FALSE(client.get_transfer_hash_algorithm().has_value());
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::istringstream iss("content");
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+    EXPECT_FALSE(client.get_last_transfer_hash().has_value());
+
+    ASSERT_THROW(client.verify_file("file"), ftp::ftp_exception);
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, verify_file_partial_transfer)
+{
+    ftp::client client;
+
+    client.set_transfer_hash_algorithm(ftp::hash_algorithm::sha256);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::istringstream iss("0123456789");
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+    ASSERT_TRUE(client.get_last_transfer_hash().has_value());
+
+    /* The hash of the tail is not the hash of the file. */
+    std::istringstream segment("ab");
+    check_last_reply(client.resume_upload(ftp::istream_adapter(segment), "file", "4"), "226 Transfer complete.");
+    EXPECT_FALSE(client.get_last_transfer_hash().has_value());
+    ASSERT_THROW(client.verify_file("file"), ftp::ftp_exception);
+
+    std::ostringstream oss;
+    check_last_reply(client.resume_download(ftp::ostream_adapter(oss), "file", "4"), "226 Transfer complete.");
+    EXPECT_FALSE(client.get_last_transfer_hash().has_value());
+
+    /* The converted data is not the file as stored. */
+    check_reply(client.set_transfer_type(ftp::transfer_type::ascii), "200 Type set to: ASCII.");
+
+    std::istringstream text("line\n");
+    check_last_reply(client.upload_file(ftp::istream_adapter(text), "text"), "226 Transfer complete.");
+    EXPECT_FALSE(client.get_last_transfer_hash().has_value());
+    ASSERT_THROW(client.verify_file("text"), ftp::ftp_exception);
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, get_file_hash_nonexistent_file)
+{
+    ftp::client client;
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    ftp::file_hash_reply reply = client.get_file_hash("nonexistent", ftp::hash_algorithm::sha256);
+    EXPECT_FALSE(reply.is_positive());
+    EXPECT_FALSE(reply.get_hash().has_value());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, get_features)
+{
+    ftp::client client;
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    ftp::features_reply reply = client.get_features();
+    EXPECT_EQ(211, reply.get_code());
+    EXPECT_TRUE(reply.has_feature("EPRT"));
+    EXPECT_TRUE(reply.has_feature("HASH"));
+    EXPECT_TRUE(reply.has_feature("MODE Z"));
+    EXPECT_FALSE(reply.has_feature("MODE B"));
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, set_transmission_mode)
+{
+    if (!ftp::detail::zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    ftp::client client;
+
+    ASSERT_EQ(ftp::transmission_mode::stream, client.get_transmission_mode());
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::zlib), "200 Transfer mode set to: Z");
+    ASSERT_EQ(ftp::transmission_mode::zlib, client.get_transmission_mode());
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::stream), "200 Transfer mode set to: S");
+    ASSERT_EQ(ftp::transmission_mode::stream, client.get_transmission_mode());
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::zlib), "200 Transfer mode set to: Z");
+
+    /* REIN resets the transmission mode. */
+    check_reply(client.logout(), "230 Ready for new user.");
+    ASSERT_EQ(ftp::transmission_mode::stream, client.get_transmission_mode());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+class client_compressed_transfer : public client,
+                                   public testing::WithParamInterface<std::tuple<ftp::transfer_mode, std::string>>
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(main_dataset, client_compressed_transfer,
+                         testing::Combine(testing::Values(ftp::transfer_mode::active,
+                                                          ftp::transfer_mode::passive),
+                                          testing::Values("",
+                                                          "content",
+                                                          "\rcon\ntent\r\n",
+                                                          std::string(25000, 'a'),
+                                                          std::string(100000, 'a'))));
+
+TEST_P(client_compressed_transfer, upload_download_file)
+{
+    if (!ftp::detail::zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    auto [mode, data] = GetParam();
+    ftp::client client(mode, ftp::transfer_type::binary);
+
+    client.set_transfer_hash_algorithm(ftp::hash_algorithm::sha256);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::zlib), "200 Transfer mode set to: Z");
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    /* The hash covers the uncompressed data. */
+    EXPECT_TRUE(client.verify_file("file"));
+
+    ftp::file_size_reply reply = client.get_file_size("file");
+    ASSERT_TRUE(reply.get_size().has_value());
+    EXPECT_EQ(data.size(), reply.get_size().value());
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    ftp::file_list_reply file_list = client.get_file_list(std::nullopt, true);
+    check_last_reply(file_list, "226 Transfer complete.");
+    EXPECT_THAT(file_list.get_file_list(), ElementsAre("file"));
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, compressed_ascii_transfer)
+{
+    if (!ftp::detail::zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode, ftp::transfer_type::ascii);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: ASCII."));
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::zlib), "200 Transfer mode set to: Z");
+
+    std::string data = "con\ntent\n";
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+class client_block_transfer : public client,
+                              public testing::WithParamInterface<std::tuple<ftp::transfer_mode, std::string>>
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(main_dataset, client_block_transfer,
+                         testing::Combine(testing::Values(ftp::transfer_mode::active,
+                                                          ftp::transfer_mode::passive),
+                                          testing::Values("",
+                                                          "content",
+                                                          "\rcon\ntent\r\n",
+                                                          std::string(4096, 'a'),
+                                                          std::string(25000, 'a'))));
+
+TEST_P(client_block_transfer, upload_download_file)
+{
+    auto [mode, data] = GetParam();
+    ftp::client client(mode, ftp::transfer_type::binary);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::block), "200 Transfer mode set to: B");
+    ASSERT_EQ(ftp::transmission_mode::block, client.get_transmission_mode());
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "250 Transfer complete.");
+
+    /* The data connection is reused. */
+    std::ostringstream oss;
+    check_reply(client.download_file(ftp::ostream_adapter(oss), "file"),
+                CRLF("125 Data connection already open. Transfer starting.",
+                     "250 Transfer complete."));
+    ASSERT_EQ(data, oss.str());
+
+    if (data.empty())
+    {
+        EXPECT_FALSE(client.get_last_restart_marker().has_value());
+    }
+    else
+    {
+        ASSERT_TRUE(client.get_last_restart_marker().has_value());
+        EXPECT_EQ(std::to_string(data.size()), client.get_last_restart_marker().value());
+    }
+
+    iss.clear();
+    iss.str(data);
+    check_reply(client.append_file(ftp::istream_adapter(iss), "file"),
+                CRLF("125 Data connection already open. Transfer starting.",
+                     "250 Transfer complete."));
+
+    ftp::file_list_reply file_list = client.get_file_list(std::nullopt, true);
+    check_reply(file_list, CRLF("125 Data connection already open. Transfer starting.",
+                                "250 Transfer complete."));
+    EXPECT_THAT(file_list.get_file_list(), ElementsAre("file"));
+
+    oss.str("");
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "250 Transfer complete.");
+    ASSERT_EQ(data + data, oss.str());
+
+    /* Switching to stream mode closes the data connection. */
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::stream), "200 Transfer mode set to: S");
+
+    oss.str("");
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data + data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, resume_download)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::block), "200 Transfer mode set to: B");
+
+    std::string data;
+    for (int i = 0; i < 1000; i++)
+    {
+        data.append(std::to_string(i));
+    }
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "250 Transfer complete.");
+
+    std::ostringstream oss;
+    check_reply(client.resume_download(ftp::ostream_adapter(oss), "file", "1000"),
+                CRLF("350 Restarting at position 1000.",
+                     "125 Data connection already open. Transfer starting.",
+                     "250 Transfer complete."));
+    ASSERT_EQ(data.substr(1000), oss.str());
+
+    ASSERT_TRUE(client.get_last_restart_marker().has_value());
+    EXPECT_EQ(std::to_string(data.size()), client.get_last_restart_marker().value());
+
+    /* Resuming works in stream mode too. */
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::stream), "200 Transfer mode set to: S");
+
+    oss.str("");
+    check_last_reply(client.resume_download(ftp::ostream_adapter(oss), "file", "2000"), "226 Transfer complete.");
+    ASSERT_EQ(data.substr(2000), oss.str());
+    EXPECT_FALSE(client.get_last_restart_marker().has_value());
+
+    check_reply(client.resume_download(ftp::ostream_adapter(oss), "file", "invalid"), "501 Invalid parameter.");
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, pipelined_streams)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+    for (int i = 0; i < 100000; i++)
+    {
+        data.append(std::to_string(i));
+    }
+
+    /* The buffers are large enough to be lent to the data connection. */
+    std::istringstream iss(data);
+    ftp::istream_adapter src(iss);
+    check_last_reply(client.upload_file(ftp::pipelined_istream(src, 100000, 2), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    ftp::ostream_adapter dst(oss);
+    check_last_reply(client.download_file(ftp::pipelined_ostream(dst, 100000, 2), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    /* The blocks are received straight into the lent buffers. */
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::block), "200 Transfer mode set to: B");
+
+    iss.clear();
+    iss.str(data);
+    check_last_reply(client.upload_file(ftp::pipelined_istream(src, 100000, 2), "file"), "250 Transfer complete.");
+
+    oss.str("");
+    check_last_reply(client.download_file(ftp::pipelined_ostream(dst, 100000, 2), "file"), "250 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, transfer_buffer_size)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    EXPECT_EQ(8192, client.get_transfer_buffer_size());
+    EXPECT_THROW(client.set_transfer_buffer_size(0), ftp::ftp_exception);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+    for (int i = 0; i < 100000; i++)
+    {
+        data.append(std::to_string(i));
+    }
+
+    for (std::size_t size : { 1024 * 1024, 7 })
+    {
+        client.set_transfer_buffer_size(size);
+        EXPECT_EQ(size, client.get_transfer_buffer_size());
+
+        std::istringstream iss(data);
+        check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+        std::ostringstream oss;
+        check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+        ASSERT_EQ(data, oss.str());
+    }
+
+    /* The chunks larger than a block are split. */
+    client.set_transfer_buffer_size(1024 * 1024);
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::block), "200 Transfer mode set to: B");
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "250 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "250 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, upload_mapped_file)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+    for (int i = 0; i < 100000; i++)
+    {
+        data.append(std::to_string(i));
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "libftp_upload_mapped_file";
+    {
+        std::ofstream ofs(path, std::ios_base::binary);
+        ofs << data;
+    }
+
+    check_last_reply(client.upload_file(ftp::mapped_file_input_stream(path, 1), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.set_transmission_mode(ftp::transmission_mode::block), "200 Transfer mode set to: B");
+
+    check_last_reply(client.upload_file(ftp::mapped_file_input_stream(path, 1), "file"), "250 Transfer complete.");
+
+    oss.str("");
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "250 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    std::filesystem::remove(path);
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, download_to_file)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+    for (int i = 0; i < 300000; i++)
+    {
+        data.append(std::to_string(i));
+    }
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    ftp::file_size_reply size_reply = client.get_file_size("file");
+    ASSERT_TRUE(size_reply.get_size().has_value());
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "libftp_download_to_file";
+
+    for (auto cache_mode : { ftp::file_output_stream::cache_mode::buffered,
+                             ftp::file_output_stream::cache_mode::direct })
+    {
+        {
+            ftp::file_output_stream dst(path, cache_mode);
+            dst.preallocate(size_reply.get_size().value());
+
+            check_last_reply(client.download_file(dst, "file"), "226 Transfer complete.");
+        }
+
+        std::ifstream ifs(path, std::ios_base::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        ASSERT_EQ(data, oss.str());
+    }
+
+    std::filesystem::remove(path);
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, rate_limit)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    /* The per-client limit is looser than the shared one. */
+    auto shared_limiter = std::make_shared<ftp::rate_limiter>(200000, 10000);
+    auto client_limiter = std::make_shared<ftp::rate_limiter>(1000000, 10000, shared_limiter);
+
+    client.set_rate_limiter(client_limiter);
+    EXPECT_EQ(client_limiter, client.get_rate_limiter());
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data(50000, 'a');
+
+    /* 10000 bytes from the bucket, then 40000 bytes at 200000 bytes/s. */
+    auto start = std::chrono::steady_clock::now();
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    start = std::chrono::steady_clock::now();
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    /* Remove the limit. */
+    client.set_rate_limiter(nullptr);
+    EXPECT_EQ(nullptr, client.get_rate_limiter());
+
+    start = std::chrono::steady_clock::now();
+
+    oss.str("");
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+/* Produces data without an end. */
+class endless_istream : public ftp::input_stream
+{
+public:
+    std::size_t read(char *buf, std::size_t size) override
+    {
+        std::fill_n(buf, size, 'a');
+        return size;
+    }
+};
+
+TEST_P(client_with_transfer_mode, abort_download)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data(2000000, 'a');
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    /* The download would take 10 seconds. */
+    client.set_rate_limiter(std::make_shared<ftp::rate_limiter>(200000, 10000));
+
+    for (bool urgent_abort : { false, true })
+    {
+        client.set_urgent_abort(urgent_abort);
+        ASSERT_EQ(urgent_abort, client.get_urgent_abort());
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread aborter([&client]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            client.abort_transfer();
+        });
+
+        std::ostringstream oss;
+        ftp::replies replies = client.download_file(ftp::ostream_adapter(oss), "file");
+
+        aborter.join();
+
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+        ASSERT_LT(oss.str().size(), data.size());
+        ASSERT_TRUE(replies.get_replies().back().is_positive()) << replies.get_status_string();
+
+        /* The control connection is in sync. */
+        check_reply(client.send_noop(), "200 I successfully did nothing'.");
+    }
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, abort_upload)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    for (bool urgent_abort : { false, true })
+    {
+        client.set_urgent_abort(urgent_abort);
+
+        std::thread aborter([&client]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            client.abort_transfer();
+        });
+
+        ftp::replies replies = client.upload_file(endless_istream(), "file");
+
+        aborter.join();
+
+        ASSERT_TRUE(replies.get_replies().back().is_positive()) << replies.get_status_string();
+
+        check_reply(client.send_noop(), "200 I successfully did nothing'.");
+    }
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, abort_streams)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data(2000000, 'a');
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    /* The transfers would take 10 seconds, the stream blocks in the throttled reads and writes. */
+    client.set_rate_limiter(std::make_shared<ftp::rate_limiter>(200000, 10000));
+
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        ftp::download_stream_ptr stream = client.open_download("file");
+        ASSERT_TRUE(stream->is_open());
+
+        std::thread aborter([&client]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            client.abort_transfer();
+        });
+
+        std::vector<char> buf(8192);
+        std::size_t size = 0;
+        std::size_t read_size;
+
+        while ((read_size = stream->read(buf.data(), buf.size())) > 0)
+        {
+            size += read_size;
+        }
+
+        aborter.join();
+
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+        ASSERT_LT(size, data.size());
+
+        ftp::replies replies = stream->close();
+        ASSERT_TRUE(replies.get_replies().back().is_positive()) << replies.get_status_string();
+
+        check_reply(client.send_noop(), "200 I successfully did nothing'.");
+    }
+
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        ftp::upload_stream_ptr stream = client.open_upload("file");
+        ASSERT_TRUE(stream->is_open());
+
+        std::thread aborter([&client]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            client.abort_transfer();
+        });
+
+        std::vector<char> buf(8192, 'a');
+
+        auto write_endless = [&]()
+        {
+            for (;;)
+            {
+                stream->write(buf.data(), buf.size());
+            }
+        };
+
+        ASSERT_THROW(write_endless(), ftp::ftp_exception);
+
+        aborter.join();
+
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+        ftp::replies replies = stream->close();
+        ASSERT_TRUE(replies.get_replies().back().is_positive()) << replies.get_status_string();
+
+        check_reply(client.send_noop(), "200 I successfully did nothing'.");
+    }
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+class eprt_observer : public ftp::observer
+{
+public:
+    void on_request(std::string_view command) override
+    {
+        if (command.substr(0, 4) == "EPRT")
+        {
+            commands_.emplace_back(command);
+        }
+    }
+
+    [[nodiscard]] const std::vector<std::string> & get_commands() const
+    {
+        return commands_;
+    }
+
+private:
+    std::vector<std::string> commands_;
+};
+
+TEST_F(client, active_port_range)
+{
+    ftp::client client(ftp::transfer_mode::active);
+
+    EXPECT_EQ(std::make_pair(std::uint16_t(0), std::uint16_t(0)), client.get_active_port_range());
+
+    client.set_active_port_range(50100, 50109);
+    client.set_active_listen_backlog(4);
+
+    EXPECT_EQ(std::make_pair(std::uint16_t(50100), std::uint16_t(50109)), client.get_active_port_range());
+    EXPECT_EQ(4, client.get_active_listen_backlog());
+
+    ASSERT_THROW(client.set_active_port_range(50109, 50100), ftp::ftp_exception);
+
+    auto observer = std::make_shared<eprt_observer>();
+    client.add_observer(observer);
+
+    check_reply(client.connect("127.0.0.1", 2121, "user", "password"),
+                CRLF("220 FTP server is ready.",
+                     "331 Username ok, send password.",
+                     "230 Login successful.",
+                     "200 Type set to: Binary."));
+
+    std::istringstream iss("content");
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    /* The server connects on EPRT and rejects RETR, the connection must not
+     * be taken by the next transfer.
+     */
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "nonexistent"), "550 No such file or directory.");
+
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ("content", oss.str());
+
+    /* Another client takes another port in the range. */
+    ftp::client other_client(ftp::transfer_mode::active);
+    auto other_observer = std::make_shared<eprt_observer>();
+
+    other_client.set_active_port_range(50100, 50109);
+    other_client.add_observer(other_observer);
+
+    check_last_reply(other_client.connect("127.0.0.1", 2121, "user", "password"), "200 Type set to: Binary.");
+    check_last_reply(other_client.get_file_list(), "226 Transfer complete.");
+    check_reply(other_client.disconnect(), "221 Goodbye.");
+
+    /* The listening socket is reused. */
+    ASSERT_EQ(3, observer->get_commands().size());
+    EXPECT_THAT(observer->get_commands()[0], testing::MatchesRegex("EPRT \\|1\\|127\\.0\\.0\\.1\\|5010[0-9]\\|"));
+    EXPECT_EQ(observer->get_commands()[0], observer->get_commands()[1]);
+    EXPECT_EQ(observer->get_commands()[0], observer->get_commands()[2]);
+
+    ASSERT_EQ(1, other_observer->get_commands().size());
+    EXPECT_THAT(other_observer->get_commands()[0], testing::MatchesRegex("EPRT \\|1\\|127\\.0\\.0\\.1\\|5010[0-9]\\|"));
+    EXPECT_NE(observer->get_commands()[0], other_observer->get_commands()[0]);
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, socket_options)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    ftp::socket_options control_options;
+    control_options.no_delay = true;
+    control_options.keep_alive = true;
+
+    ftp::socket_options data_options;
+    data_options.send_buffer_size = 262144;
+    data_options.receive_buffer_size = 262144;
+
+    client.set_control_socket_options(control_options);
+    client.set_data_socket_options(data_options);
+
+    EXPECT_EQ(true, client.get_control_socket_options().no_delay);
+    EXPECT_EQ(262144, client.get_data_socket_options().receive_buffer_size);
+
+    check_last_reply(client.connect("127.0.0.1", 2121, "user", "password"), "200 Type set to: Binary.");
+
+    std::string data(100000, 'a');
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+
+    /* A data connection fails if an option cannot be set. */
+    data_options.congestion_control = "nonexistent";
+    client.set_data_socket_options(data_options);
+
+    check_last_reply(client.connect("127.0.0.1", 2121, "user", "password"), "200 Type set to: Binary.");
+    ASSERT_THROW(client.download_file(ftp::ostream_adapter(oss), "file"), ftp::ftp_exception);
+    client.disconnect(false);
+
+    /* The control connection too. */
+    control_options.congestion_control = "nonexistent";
+    client.set_control_socket_options(control_options);
+
+    ASSERT_THROW(client.connect("127.0.0.1", 2121), ftp::ftp_exception);
+}
+
+TEST_P(client_with_transfer_mode, local_address_pool)
+{
+#ifndef __linux__
+    GTEST_SKIP() << "Skip. Only Linux routes the whole 127.0.0.0/8 to the loopback interface.";
+#endif
+
+    ftp::transfer_mode mode = GetParam();
+
+    auto pool = std::make_shared<ftp::local_address_pool>(
+        std::vector<boost::asio::ip::address>{ boost::asio::ip::make_address("127.0.0.2"),
+                                               boost::asio::ip::make_address("127.0.0.3") });
+
+    ftp::socket_options options;
+    options.local_address_pool = pool;
+
+    for (std::string_view local_address : { "127.0.0.2", "127.0.0.3" })
+    {
+        ftp::client client(mode);
+        auto observer = std::make_shared<eprt_observer>();
+
+        client.set_control_socket_options(options);
+        client.add_observer(observer);
+
+        check_last_reply(client.connect("127.0.0.1", 2121, "user", "password"), "200 Type set to: Binary.");
+
+        /* The server rejects data connections from an address other than the client's one. */
+        std::string data = "content";
+        std::istringstream iss(data);
+        check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+        std::ostringstream oss;
+        check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+        ASSERT_EQ(data, oss.str());
+
+        for (const std::string & command : observer->get_commands())
+        {
+            EXPECT_EQ(0, command.find("EPRT |1|" + std::string(local_address) + "|"));
+        }
+
+        check_reply(client.disconnect(), "221 Goodbye.");
+    }
+}
+
+TEST_F(client, configure_rfc2428_support)
+{
+    ftp::client client;
+
+    EXPECT_TRUE(client.get_rfc2428_support());
+
+    client.set_rfc2428_support(false);
+    EXPECT_FALSE(client.get_rfc2428_support());
+
+    client.set_rfc2428_support(true);
+    EXPECT_TRUE(client.get_rfc2428_support());
+}
+
+TEST_P(client_with_transfer_mode, disable_rfc2428_support)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    client.set_rfc2428_support(false);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data = "content";
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, thread_safe_client)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    client.set_thread_safe(true);
+    ASSERT_TRUE(client.is_thread_safe());
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data(256 * 1024, 'x');
+    std::atomic<bool> done = false;
+    std::vector<std::thread> threads;
+
+    /* Each thread checks its replies, so a reply read by another thread is noticed. */
+    threads.emplace_back([&]()
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            std::istringstream iss(data);
+            check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+            std::ostringstream oss;
+            check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+            EXPECT_EQ(data, oss.str());
+        }
+    });
+
+    for (int i = 0; i < 3; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int j = 0; j < 50; ++j)
+            {
+                check_reply(client.get_current_directory(), R"(257 "/" is the current directory.)");
+                check_reply(client.send_noop(), "200 I successfully did nothing'.");
+                EXPECT_EQ(mode, client.get_transfer_mode());
+            }
+        });
+    }
+
+    std::thread observers_thread([&]()
+    {
+        while (!done)
+        {
+            std::shared_ptr<test_observer> observer = std::make_shared<test_observer>("observer");
+            client.add_observer(observer);
+            std::this_thread::yield();
+            client.remove_observer(observer);
+        }
+    });
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    done = true;
+    observers_thread.join();
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, session_manager)
+{
+    ftp::session_manager manager(2, true);
+    std::vector<ftp::session_ptr> sessions;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        sessions.push_back(manager.create_session("127.0.0.1"));
+    }
+
+    ASSERT_EQ(2, manager.get_session_count(0));
+    ASSERT_EQ(2, manager.get_session_count(1));
+
+    std::vector<std::future<std::string>> futures;
+
+    for (std::size_t i = 0; i < sessions.size(); ++i)
+    {
+        futures.push_back(sessions[i]->submit([i](ftp::client & client)
+        {
+            client.connect("127.0.0.1", 2121, "user", "password");
+
+            std::string path = "file" + std::to_string(i);
+            std::string data(64 * 1024, static_cast<char>('a' + i));
+            std::istringstream iss(data);
+            client.upload_file(ftp::istream_adapter(iss), path);
+
+            std::ostringstream oss;
+            client.download_file(ftp::ostream_adapter(oss), path);
+
+            client.disconnect();
+
+            return oss.str();
+        }));
+    }
+
+    for (std::size_t i = 0; i < futures.size(); ++i)
+    {
+        ASSERT_EQ(std::string(64 * 1024, static_cast<char>('a' + i)), futures[i].get());
+    }
+}
+
+TEST_F(client, resume_upload)
+{
+    ftp::client client;
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::istringstream iss("0123456789");
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    /* The data is written at the offset, the rest of the file is kept. */
+    std::istringstream segment("ab");
+    ftp::replies replies = client.resume_upload(ftp::istream_adapter(segment), "file", "4");
+    ASSERT_EQ(350, replies.get_replies().front().get_code());
+    check_last_reply(replies, "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ("0123ab6789", oss.str());
+
+    /* The server does not accept an offset past the end of the file. */
+    std::istringstream past_end("cd");
+    ASSERT_FALSE(client.resume_upload(ftp::istream_adapter(past_end), "file", "20").is_positive());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+class string_istream : public ftp::input_stream
+{
+public:
+    explicit string_istream(std::string data)
+        : data_(std::move(data)),
+          position_(0)
+    {
+    }
+
+    std::size_t read(char *buf, std::size_t size) override
+    {
+        std::size_t copied = data_.copy(buf, size, position_);
+        position_ += copied;
+        return copied;
+    }
+
+private:
+    std::string data_;
+    std::size_t position_;
+};
+
+TEST_F(client, segmented_upload)
+{
+    ftp::segmented_upload upload([]()
+    {
+        auto client = std::make_unique<ftp::client>();
+        client->connect("127.0.0.1", 2121, "user", "password");
+        return client;
+    }, 4, 64 * 1024);
+
+    std::string data;
+    for (int i = 0; i < 1000000; ++i)
+    {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "libftp_segmented_upload";
+    {
+        std::ofstream ofs(path, std::ios_base::binary);
+        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    /* Twice, the second upload reuses the clients and truncates the file. */
+    upload.upload(path, "file");
+    upload.upload([&data](std::uint64_t offset, std::uint64_t size)
+    {
+        return std::make_unique<string_istream>(data.substr(offset, size));
+    }, data.size(), "file");
+
+    std::filesystem::remove(path);
+
+    ftp::client client;
+    client.connect("127.0.0.1", 2121, "user", "password");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+
+    upload.close();
+}
+
+TEST_P(client_with_transfer_mode, download_stream)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    client.set_transfer_hash_algorithm(ftp::hash_algorithm::sha256);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        data += std::to_string(i);
+    }
+
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    ftp::download_stream_ptr stream = client.open_download("file");
+    ASSERT_TRUE(stream->is_open());
+
+    /* The data is read in chunks smaller than the transfer buffer. */
+    std::string received;
+    std::array<char, 1000> buf;
+
+    for (;;)
+    {
+        std::size_t size = stream->read(buf.data(), buf.size());
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        received.append(buf.data(), size);
+    }
+
+    ASSERT_EQ(data, received);
+    check_last_reply(stream->close(), "226 Transfer complete.");
+    ASSERT_FALSE(stream->is_open());
+    EXPECT_TRUE(client.verify_file("file"));
+
+    /* The server refuses the transfer. */
+    stream = client.open_download("nonexistent");
+    ASSERT_FALSE(stream->is_open());
+    ASSERT_EQ(0, stream->read(buf.data(), buf.size()));
+    ASSERT_FALSE(stream->close().is_positive());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_P(client_with_transfer_mode, upload_stream)
+{
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
+
+    client.set_transfer_hash_algorithm(ftp::hash_algorithm::sha256);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
+
+    std::string data;
+    ftp::upload_stream_ptr stream = client.open_upload("file");
+    ASSERT_TRUE(stream->is_open());
+
+    for (int i = 0; i < 20000; i++)
+    {
+        std::string chunk = std::to_string(i);
+
+        stream->write(chunk.data(), chunk.size());
+        data += chunk;
+    }
+
+    check_last_reply(stream->close(), "226 Transfer complete.");
+    ASSERT_FALSE(stream->is_open());
+    EXPECT_TRUE(client.verify_file("file"));
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, ascii_streams)
+{
+    std::vector<ftp::transmission_mode> modes = { ftp::transmission_mode::stream };
+
+    if (ftp::detail::zlib_compressor::is_available())
+    {
+        modes.push_back(ftp::transmission_mode::zlib);
+    }
+
+    ftp::client client(ftp::transfer_mode::passive, ftp::transfer_type::ascii);
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
+
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: ASCII."));
+
+    for (ftp::transmission_mode transmission_mode : modes)
+    {
+        ASSERT_TRUE(client.set_transmission_mode(transmission_mode).is_positive());
+
+        /* The line endings are converted across the writes. */
+        std::string data = "con\r\ntent\n\nline\r\n";
+        ftp::upload_stream_ptr upload = client.open_upload("file");
+
+        for (char ch : data)
+        {
+            upload->write(&ch, 1);
+        }
+
+        check_last_reply(upload->close(), "226 Transfer complete.");
+
+        ftp::download_stream_ptr download = client.open_download("file");
+        std::string received;
+        char ch;
+
+        while (download->read(&ch, 1) == 1)
+        {
+            received.push_back(ch);
+        }
+
+        check_last_reply(download->close(), "226 Transfer complete.");
+        ASSERT_EQ("con\ntent\n\nline\n", received);
+    }
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+TEST_F(client, calls_while_stream_open)
+{
+    ftp::client client;
+
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
 
     check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
                                                        "230 Login successful.",
                                                        "200 Type set to: Binary."));
 
     std::string data = "content";
-    std::istringstream iss(data);
-    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+    ftp::upload_stream_ptr upload = client.open_upload("file");
+    ASSERT_TRUE(upload->is_open());
+    upload->write(data.data(), data.size());
 
-    std::ostringstream oss;
-    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
-    ASSERT_EQ(data, oss.str());
+    /* The control connection is busy with the transfer. */
+    ASSERT_THROW(client.send_noop(), ftp::ftp_exception);
+    ASSERT_THROW(client.open_download("file"), ftp::ftp_exception);
+
+    check_last_reply(upload->close(), "226 Transfer complete.");
+    check_reply(client.send_noop(), "200 I successfully did nothing'.");
+
+    ftp::download_stream_ptr download = client.open_download("file");
+    ASSERT_TRUE(download->is_open());
+    ASSERT_THROW(client.get_current_directory(), ftp::ftp_exception);
+    download.reset();
+
+    /* A destroyed stream releases the client. */
+    check_reply(client.send_noop(), "200 I successfully did nothing'.");
 
     check_reply(client.disconnect(), "221 Goodbye.");
 }
 
-TEST_F(client, configure_rfc2428_support)
+TEST_P(client_with_transfer_mode, memory_streams)
 {
-    ftp::client client;
+    ftp::transfer_mode mode = GetParam();
+    ftp::client client(mode);
 
-    EXPECT_TRUE(client.get_rfc2428_support());
+    check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
 
-    client.set_rfc2428_support(false);
-    EXPECT_FALSE(client.get_rfc2428_support());
+    check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
+                                                       "230 Login successful.",
+                                                       "200 Type set to: Binary."));
 
-    client.set_rfc2428_support(true);
-    EXPECT_TRUE(client.get_rfc2428_support());
+    std::string data;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        data += std::to_string(i);
+    }
+
+    check_last_reply(client.upload_file(ftp::span_input_stream(data), "file"), "226 Transfer complete.");
+
+    ftp::file_size_reply size_reply = client.get_file_size("file");
+    ASSERT_TRUE(size_reply.get_size().has_value());
+
+    /* The data is received in the buffer allocated from the file size. */
+    ftp::memory_output_stream stream;
+    stream.preallocate(size_reply.get_size().value());
+    const char *buffer = stream.get_data().data();
+
+    check_last_reply(client.download_file(stream, "file"), "226 Transfer complete.");
+    EXPECT_EQ(buffer, stream.get_data().data());
+    ASSERT_EQ(data, stream.get_data());
+
+    /* The buffer of the caller. */
+    std::vector<char> target(data.size());
+    ftp::memory_output_stream target_stream(target.data(), target.size());
+
+    check_last_reply(client.download_file(target_stream, "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, std::string(target.begin(), target.end()));
+
+    check_reply(client.disconnect(), "221 Goodbye.");
 }
 
-TEST_P(client_with_transfer_mode, disable_rfc2428_support)
+TEST_P(client_with_transfer_mode, close_download_stream_early)
 {
     ftp::transfer_mode mode = GetParam();
     ftp::client client(mode);
 
-    client.set_rfc2428_support(false);
-
     check_reply(client.connect("127.0.0.1", 2121), "220 FTP server is ready.");
 
     check_reply(client.login("user", "password"), CRLF("331 Username ok, send password.",
                                                        "230 Login successful.",
                                                        "200 Type set to: Binary."));
 
-    std::string data = "content";
+    std::string data(2000000, 'a');
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    ftp::download_stream_ptr stream = client.open_download("file");
+
+    std::array<char, 10> buf;
+    ASSERT_LT(0, stream->read(buf.data(), buf.size()));
+
+    /* The rest of the file is not received. */
+    ftp::replies replies = stream->close();
+    ASSERT_TRUE(replies.get_replies().back().is_positive()) << replies.get_status_string();
+
+    /* The control connection is in sync. */
+    check_reply(client.send_noop(), "200 I successfully did nothing'.");
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
+/* A scripted FTP server for the failures the test server cannot produce.
+ * It greets the client, enters the passive mode on EPSV and passes the other
+ * commands to the handler. The handler runs on the server thread.
+ */
+class fake_server
+{
+public:
+    using handler = std::function<void(fake_server & server, const std::string & command)>;
+
+    explicit fake_server(handler handler)
+        : handler_(std::move(handler)),
+          acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+          data_acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+          control_socket_(io_context_),
+          data_socket_(io_context_),
+          connections_(0)
+    {
+        accept();
+
+        thread_ = std::thread([this]() { io_context_.run(); });
+    }
+
+    ~fake_server()
+    {
+        io_context_.stop();
+        thread_.join();
+    }
+
+    [[nodiscard]] std::uint16_t get_port() const
+    {
+        return acceptor_.local_endpoint().port();
+    }
+
+    [[nodiscard]] std::uint16_t get_data_port() const
+    {
+        return data_acceptor_.local_endpoint().port();
+    }
+
+    /* The number of the accepted control connections. */
+    [[nodiscard]] int get_connections() const
+    {
+        return connections_;
+    }
+
+    void reply(const std::string & reply)
+    {
+        boost::system::error_code ignored;
+        boost::asio::write(control_socket_, boost::asio::buffer(reply + "\r\n"), ignored);
+    }
+
+    /* Accepts the data connection, it is left open. */
+    void accept_data()
+    {
+        boost::system::error_code ignored;
+        data_socket_.close(ignored);
+        data_acceptor_.accept(data_socket_, ignored);
+    }
+
+    /* Accepts the data connection, sends the data and closes it. */
+    void send_data(const std::string & data)
+    {
+        boost::system::error_code ignored;
+        accept_data();
+        boost::asio::write(data_socket_, boost::asio::buffer(data), ignored);
+        data_socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+        data_socket_.close(ignored);
+    }
+
+    /* Closes the control connection and waits for the next one. */
+    void close_control()
+    {
+        boost::system::error_code ignored;
+        control_socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+        control_socket_.close(ignored);
+    }
+
+private:
+    void accept()
+    {
+        acceptor_.async_accept(control_socket_, [this](const boost::system::error_code & ec)
+        {
+            if (!ec)
+            {
+                connections_++;
+                buffer_.clear();
+                reply("220 FTP server is ready.");
+                read_command();
+            }
+        });
+    }
+
+    void read_command()
+    {
+        boost::asio::async_read_until(control_socket_, boost::asio::dynamic_buffer(buffer_), "\r\n",
+                                      [this](const boost::system::error_code & ec, std::size_t size)
+        {
+            if (ec)
+            {
+                accept_next();
+                return;
+            }
+
+            std::string command = buffer_.substr(0, size - 2);
+            buffer_.erase(0, size);
+
+            if (command == "EPSV")
+            {
+                reply("229 Entering extended passive mode (|||" + std::to_string(get_data_port()) + "|).");
+            }
+            else
+            {
+                handler_(*this, command);
+            }
+
+            if (control_socket_.is_open())
+            {
+                read_command();
+            }
+            else
+            {
+                accept_next();
+            }
+        });
+    }
+
+    void accept_next()
+    {
+        boost::system::error_code ignored;
+        control_socket_.close(ignored);
+        accept();
+    }
+
+    handler handler_;
+    boost::asio::io_context io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    boost::asio::ip::tcp::acceptor data_acceptor_;
+    boost::asio::ip::tcp::socket control_socket_;
+    boost::asio::ip::tcp::socket data_socket_;
+    std::atomic<int> connections_;
+    std::string buffer_;
+    std::thread thread_;
+};
+
+/* Accepts the data connection of RETR, but never sends the data,
+ * and never replies to the other commands.
+ */
+void stall(fake_server & server, const std::string & command)
+{
+    if (command.rfind("RETR", 0) == 0)
+    {
+        server.accept_data();
+        server.reply("125 Data connection already open. Transfer starting.");
+    }
+}
+
+TEST_F(client, reply_timeout)
+{
+    fake_server server(stall);
+    ftp::client client;
+
+    ftp::timeouts timeouts;
+    timeouts.reply = std::chrono::milliseconds(200);
+    client.set_timeouts(timeouts);
+    ASSERT_EQ(std::chrono::milliseconds(200), client.get_timeouts().reply);
+
+    check_reply(client.connect("127.0.0.1", server.get_port()), "220 FTP server is ready.");
+
+    try
+    {
+        client.send_noop();
+        FAIL() << "The NOOP command is expected to time out.";
+    }
+    catch (const ftp::ftp_exception & ex)
+    {
+        ASSERT_EQ(ftp::error::reply_timeout, ex.get_error_code());
+    }
+}
+
+TEST_F(client, transfer_timeout)
+{
+    fake_server server(stall);
+    ftp::client client;
+
+    ftp::timeouts timeouts;
+    timeouts.connect = std::chrono::seconds(5);
+    timeouts.reply = std::chrono::seconds(5);
+    timeouts.transfer = std::chrono::milliseconds(200);
+    client.set_timeouts(timeouts);
+
+    check_reply(client.connect("127.0.0.1", server.get_port()), "220 FTP server is ready.");
+
+    std::ostringstream oss;
+
+    try
+    {
+        client.download_file(ftp::ostream_adapter(oss), "file");
+        FAIL() << "The download is expected to time out.";
+    }
+    catch (const ftp::ftp_exception & ex)
+    {
+        ASSERT_EQ(ftp::error::transfer_timeout, ex.get_error_code());
+    }
+}
+
+TEST_F(client, deadline_exceeded)
+{
+    fake_server server(stall);
+    ftp::client client;
+
+    ftp::timeouts timeouts;
+    timeouts.reply = std::chrono::seconds(5);
+    client.set_timeouts(timeouts);
+    client.set_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(300));
+    ASSERT_TRUE(client.get_deadline());
+
+    check_reply(client.connect("127.0.0.1", server.get_port()), "220 FTP server is ready.");
+
+    try
+    {
+        client.send_noop();
+        FAIL() << "The NOOP command is expected to exceed the deadline.";
+    }
+    catch (const ftp::ftp_exception & ex)
+    {
+        ASSERT_EQ(ftp::error::deadline_exceeded, ex.get_error_code());
+    }
+}
+
+TEST_F(client, timeouts_do_not_affect_transfers)
+{
+    ftp::client client;
+
+    ftp::timeouts timeouts;
+    timeouts.connect = std::chrono::seconds(5);
+    timeouts.reply = std::chrono::seconds(5);
+    timeouts.transfer = std::chrono::seconds(5);
+    client.set_timeouts(timeouts);
+    client.set_deadline(std::chrono::steady_clock::now() + std::chrono::minutes(1));
+
+    check_reply(client.connect("127.0.0.1", 2121, "user", "password"), CRLF("220 FTP server is ready.",
+                                                                            "331 Username ok, send password.",
+                                                                            "230 Login successful.",
+                                                                            "200 Type set to: Binary."));
+
+    std::string data(100000, 'x');
     std::istringstream iss(data);
     check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
 
@@ -1132,9 +2865,181 @@ TEST_P(client_with_transfer_mode, disable_rfc2428_support)
     check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
     ASSERT_EQ(data, oss.str());
 
+    client.set_deadline(std::nullopt);
+    ASSERT_FALSE(client.get_deadline());
+
     check_reply(client.disconnect(), "221 Goodbye.");
 }
 
+std::string make_download_content()
+{
+    std::string content;
+
+    for (int i = 0; i < 100000; i++)
+    {
+        content.push_back(static_cast<char>(i % 251));
+    }
+
+    return content;
+}
+
+TEST_F(client, retry_download)
+{
+    std::string content = make_download_content();
+    std::atomic<int> retrievals = 0;
+    std::atomic<std::uint64_t> offset = 0;
+
+    fake_server server([&](fake_server & server, const std::string & command)
+    {
+        if (command.rfind("REST ", 0) == 0)
+        {
+            offset = std::stoull(command.substr(5));
+            server.reply("350 Restarting at " + command.substr(5) + ". End with RETR.");
+        }
+        else if (command == "RETR file")
+        {
+            server.reply("125 Data connection already open. Transfer starting.");
+
+            if (retrievals++ == 0)
+            {
+                /* Break the first transfer in the middle. */
+                server.send_data(content.substr(0, 40000));
+                server.reply("426 Connection closed; transfer aborted.");
+            }
+            else
+            {
+                server.send_data(content.substr(offset));
+                server.reply("226 Transfer complete.");
+            }
+        }
+    });
+
+    ftp::client client;
+    client.set_retry_policy(std::make_shared<ftp::exponential_backoff>(3, std::chrono::milliseconds(10)));
+    ASSERT_TRUE(client.get_retry_policy());
+
+    check_reply(client.connect("127.0.0.1", server.get_port()), "220 FTP server is ready.");
+
+    std::ostringstream oss;
+    check_reply(client.download_file(ftp::ostream_adapter(oss), "file"),
+                CRLF("350 Restarting at 40000. End with RETR.",
+                     "229 Entering extended passive mode (|||" + std::to_string(server.get_data_port()) + "|).",
+                     "125 Data connection already open. Transfer starting.",
+                     "226 Transfer complete."));
+
+    ASSERT_EQ(2, retrievals);
+    ASSERT_EQ(40000, offset);
+    ASSERT_EQ(content, oss.str());
+    ASSERT_EQ(1, server.get_connections());
+}
+
+TEST_F(client, retry_download_reconnects)
+{
+    std::string content = make_download_content();
+    std::atomic<int> retrievals = 0;
+    std::atomic<int> directory_changes = 0;
+    std::atomic<std::uint64_t> offset = 0;
+
+    fake_server server([&](fake_server & server, const std::string & command)
+    {
+        if (command == "USER user")
+        {
+            server.reply("331 Username ok, send password.");
+        }
+        else if (command == "PASS password")
+        {
+            server.reply("230 Login successful.");
+        }
+        else if (command == "TYPE I")
+        {
+            server.reply("200 Type set to: Binary.");
+        }
+        else if (command == "CWD dir")
+        {
+            directory_changes++;
+            server.reply("250 \"/dir\" is the current directory.");
+        }
+        else if (command.rfind("REST ", 0) == 0)
+        {
+            offset = std::stoull(command.substr(5));
+            server.reply("350 Restarting at " + command.substr(5) + ". End with RETR.");
+        }
+        else if (command == "RETR file")
+        {
+            server.reply("125 Data connection already open. Transfer starting.");
+
+            if (retrievals++ == 0)
+            {
+                /* Drop the session in the middle of the first transfer. */
+                server.send_data(content.substr(0, 40000));
+                server.reply("421 Service not available, closing control connection.");
+                server.close_control();
+            }
+            else
+            {
+                server.send_data(content.substr(offset));
+                server.reply("226 Transfer complete.");
+            }
+        }
+    });
+
+    ftp::client client;
+    client.set_retry_policy(std::make_shared<ftp::exponential_backoff>(3, std::chrono::milliseconds(10)));
+
+    check_reply(client.connect("127.0.0.1", server.get_port(), "user", "password"),
+                CRLF("220 FTP server is ready.",
+                     "331 Username ok, send password.",
+                     "230 Login successful.",
+                     "200 Type set to: Binary."));
+
+    check_reply(client.change_current_directory("dir"), "250 \"/dir\" is the current directory.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+
+    ASSERT_EQ(2, retrievals);
+    ASSERT_EQ(40000, offset);
+    ASSERT_EQ(content, oss.str());
+
+    /* The session is restored on the new control connection. */
+    ASSERT_EQ(2, server.get_connections());
+    ASSERT_EQ(2, directory_changes);
+    ASSERT_TRUE(client.is_connected());
+}
+
+TEST_F(client, retry_download_gives_up)
+{
+    std::atomic<int> retrievals = 0;
+
+    fake_server server([&](fake_server & server, const std::string & command)
+    {
+        if (command == "RETR busy")
+        {
+            retrievals++;
+            server.reply("450 File unavailable.");
+        }
+        else if (command == "RETR missing")
+        {
+            retrievals++;
+            server.reply("550 No such file or directory.");
+        }
+    });
+
+    ftp::client client;
+    client.set_retry_policy(std::make_shared<ftp::exponential_backoff>(3, std::chrono::milliseconds(1)));
+
+    check_reply(client.connect("127.0.0.1", server.get_port()), "220 FTP server is ready.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "busy"), "450 File unavailable.");
+    ASSERT_EQ(3, retrievals);
+
+    /* Not a transient failure. */
+    retrievals = 0;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "missing"), "550 No such file or directory.");
+    ASSERT_EQ(1, retrievals);
+}
+
 class ssl_client : public client_base<2142, true>
 {
 };
@@ -1292,11 +3197,12 @@ TEST_F(ssl_client, get_help)
     check_reply(client.get_help(),
         CRLF("214-The following commands are recognized:",
              " ABOR   ALLO   APPE   AUTH   CDUP   CWD    DELE   EPRT  ",
-             " EPSV   FEAT   HELP   LIST   MDTM   MFMT   MKD    MLSD  ",
-             " MLST   MODE   NLST   NOOP   OPTS   PASS   PASV   PBSZ  ",
-             " PORT   PROT   PWD    QUIT   REIN   REST   RETR   RMD   ",
-             " RNFR   RNTO   SITE   SIZE   STAT   STOR   STOU   STRU  ",
-             " SYST   TYPE   USER   XCUP   XCWD   XMKD   XPWD   XRMD  ",
+             " EPSV   FEAT   HASH   HELP   LIST   MDTM   MFMT   MKD   ",
+             " MLSD   MLST   MODE   NLST   NOOP   OPTS   PASS   PASV  ",
+             " PBSZ   PORT   PROT   PWD    QUIT   REIN   REST   RETR  ",
+             " RMD    RNFR   RNTO   SITE   SIZE   STAT   STOR   STOU  ",
+             " STRU   SYST   TYPE   USER   XCRC   XCUP   XCWD   XMD5  ",
+             " XMKD   XPWD   XRMD   XSHA1  XSHA256 XSHA512",
              "214 Help command successful."));
 
     check_reply(client.get_help("AUTH"), "214 Syntax: AUTH <SP> TLS|SSL (set up secure control channel).");
@@ -1304,6 +3210,41 @@ TEST_F(ssl_client, get_help)
     check_reply(client.disconnect(), "221 Goodbye.");
 }
 
+TEST_F(ssl_client, timeouts_do_not_affect_transfers)
+{
+    ftp::ssl::context_ptr ssl_context = ftp::ssl::create_context(ftp::ssl::context::tls_client);
+    ssl_context->load_verify_file(ftp::test::server::get_root_ca_cert_path().string());
+    ssl_context->load_verify_file(ftp::test::server::get_ca_cert_path().string());
+    ssl_context->set_verify_mode(ftp::ssl::verify_peer);
+
+    ftp::client client(std::move(ssl_context));
+
+    ftp::timeouts timeouts;
+    timeouts.connect = std::chrono::seconds(5);
+    timeouts.reply = std::chrono::seconds(5);
+    timeouts.transfer = std::chrono::seconds(5);
+    client.set_timeouts(timeouts);
+    client.set_deadline(std::chrono::steady_clock::now() + std::chrono::minutes(1));
+
+    check_reply(client.connect("127.0.0.1", 2142, "user", "password"), CRLF("220 FTP server is ready.",
+                                                                            "234 AUTH TLS successful.",
+                                                                            "331 Username ok, send password.",
+                                                                            "230 Login successful.",
+                                                                            "200 PBSZ=0 successful.",
+                                                                            "200 Protection set to Private",
+                                                                            "200 Type set to: Binary."));
+
+    std::string data(100000, 'x');
+    std::istringstream iss(data);
+    check_last_reply(client.upload_file(ftp::istream_adapter(iss), "file"), "226 Transfer complete.");
+
+    std::ostringstream oss;
+    check_last_reply(client.download_file(ftp::ostream_adapter(oss), "file"), "226 Transfer complete.");
+    ASSERT_EQ(data, oss.str());
+
+    check_reply(client.disconnect(), "221 Goodbye.");
+}
+
 class ssl_client_parameterized : public ssl_client,
                                  public testing::WithParamInterface<std::tuple<ftp::transfer_mode,
                                                                                ftp::transfer_type,
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/detail/command_queue.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using ftp::detail::command_queue;
+using namespace std::chrono_literals;
+
+TEST(command_queue, nested_commands)
+{
+    command_queue queue;
+
+    std::unique_lock<command_queue> outer(queue);
+    {
+        std::unique_lock<command_queue> inner(queue);
+    }
+
+    /* The queue is still held by the outer command. */
+    bool locked = false;
+    std::thread thread([&]()
+    {
+        std::unique_lock<command_queue> lock(queue);
+        locked = true;
+    });
+
+    std::this_thread::sleep_for(50ms);
+    outer.unlock();
+    thread.join();
+
+    ASSERT_TRUE(locked);
+}
+
+TEST(command_queue, submission_order)
+{
+    command_queue queue;
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+
+    std::unique_lock<command_queue> first(queue);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            std::unique_lock<command_queue> lock(queue);
+            std::lock_guard<std::mutex> order_lock(order_mutex);
+            order.push_back(i);
+        });
+
+        /* Let the thread take its place in the queue. */
+        std::this_thread::sleep_for(20ms);
+    }
+
+    first.unlock();
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(std::vector<int>({ 0, 1, 2, 3, 4 }), order);
+}
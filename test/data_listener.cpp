@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/ftp_exception.hpp>
+#include <ftp/detail/data_listener.hpp>
+
+using ftp::detail::data_connection;
+using ftp::detail::data_listener;
+using ftp::detail::net_context;
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+
+TEST(data_listener, ephemeral_port)
+{
+    net_context context;
+    data_listener listener(context);
+
+    ASSERT_FALSE(listener.is_open());
+
+    tcp::endpoint endpoint = listener.listen(make_address("127.0.0.1"));
+
+    ASSERT_TRUE(listener.is_open());
+    ASSERT_NE(0, endpoint.port());
+
+    /* The acceptor is reused. */
+    ASSERT_EQ(endpoint, listener.listen(make_address("127.0.0.1")));
+
+    listener.close();
+    ASSERT_FALSE(listener.is_open());
+}
+
+TEST(data_listener, port_range)
+{
+    net_context context;
+    data_listener first(context);
+    data_listener second(context);
+    data_listener third(context);
+
+    first.set_port_range(50200, 50201);
+    second.set_port_range(50200, 50201);
+    third.set_port_range(50200, 50201);
+
+    ASSERT_EQ(50200, first.listen(make_address("127.0.0.1")).port());
+    ASSERT_EQ(50201, second.listen(make_address("127.0.0.1")).port());
+
+    /* All the ports in the range are taken. */
+    ASSERT_THROW(third.listen(make_address("127.0.0.1")), ftp::ftp_exception);
+    ASSERT_FALSE(third.is_open());
+
+    first.close();
+    ASSERT_EQ(50200, third.listen(make_address("127.0.0.1")).port());
+}
+
+TEST(data_listener, change_address)
+{
+    net_context context;
+    data_listener listener(context);
+
+    listener.set_port_range(50210, 50210);
+
+    ASSERT_EQ(make_address("127.0.0.1"), listener.listen(make_address("127.0.0.1")).address());
+    ASSERT_EQ(make_address("::1"), listener.listen(make_address("::1")).address());
+    ASSERT_EQ(50210, listener.listen(make_address("::1")).port());
+}
+
+TEST(data_listener, accept)
+{
+    net_context context;
+    data_listener listener(context);
+
+    tcp::endpoint endpoint = listener.listen(make_address("127.0.0.1"));
+
+    /* A connection left from a failed transfer. */
+    tcp::socket stale(context.get_io_context());
+    stale.connect(endpoint);
+
+    ASSERT_EQ(endpoint, listener.listen(make_address("127.0.0.1")));
+
+    tcp::socket socket(context.get_io_context());
+    socket.connect(endpoint);
+
+    data_connection connection(context);
+    listener.accept(connection, make_address("127.0.0.1"));
+
+    /* The stale connection has been dropped. */
+    char ch;
+    boost::system::error_code ec;
+    stale.read_some(boost::asio::buffer(&ch, 1), ec);
+    ASSERT_EQ(boost::asio::error::eof, ec);
+
+    socket.close();
+    connection.disconnect();
+}
+
+TEST(data_listener, accept_server_only)
+{
+    net_context context;
+    data_listener listener(context);
+
+    tcp::endpoint endpoint = listener.listen(make_address("127.0.0.1"));
+
+    /* A connection from another host than the server. */
+    tcp::socket foreign(context.get_io_context());
+    foreign.connect(endpoint);
+
+    /* The server connects from the other loopback address. */
+    boost::system::error_code ec;
+    tcp::socket socket(context.get_io_context());
+    socket.open(tcp::v4());
+    socket.bind(tcp::endpoint(make_address("127.0.0.2"), 0), ec);
+
+    if (ec)
+    {
+        GTEST_SKIP() << "127.0.0.2 is not available: " << ec.message();
+    }
+
+    socket.connect(endpoint);
+
+    data_connection connection(context);
+    listener.accept(connection, make_address("::ffff:127.0.0.2"));
+
+    /* The foreign connection has been closed. */
+    char ch;
+    foreign.read_some(boost::asio::buffer(&ch, 1), ec);
+    ASSERT_EQ(boost::asio::error::eof, ec);
+
+    socket.close();
+    connection.disconnect();
+}
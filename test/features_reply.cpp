@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <ftp/features_reply.hpp>
+#include "test_utils.hpp"
+
+namespace
+{
+
+using namespace ftp::test;
+using testing::ElementsAre;
+
+TEST(features_reply, construct)
+{
+    {
+        ftp::features_reply reply(ftp::reply(211, CRLF("211-Features supported:",
+                                                       " EPRT",
+                                                       " HASH SHA-1*;SHA-256",
+                                                       " mode z",
+                                                       " REST STREAM ",
+                                                       "211 End FEAT.")));
+        EXPECT_EQ(211, reply.get_code());
+        EXPECT_THAT(reply.get_features(), ElementsAre("EPRT", "HASH SHA-1*;SHA-256", "mode z", "REST STREAM"));
+
+        EXPECT_TRUE(reply.has_feature("EPRT"));
+        EXPECT_TRUE(reply.has_feature("HASH"));
+        EXPECT_TRUE(reply.has_feature("MODE Z"));
+        EXPECT_TRUE(reply.has_feature("REST"));
+        EXPECT_TRUE(reply.has_feature("REST STREAM"));
+        EXPECT_FALSE(reply.has_feature("MODE B"));
+        EXPECT_FALSE(reply.has_feature("EPSV"));
+        EXPECT_FALSE(reply.has_feature("REST STR"));
+    }
+
+    {
+        ftp::features_reply reply(ftp::reply(211, "211 No features."));
+        EXPECT_THAT(reply.get_features(), ElementsAre());
+    }
+
+    {
+        ftp::features_reply reply(ftp::reply(500, "500 Command \"FEAT\" not understood."));
+        EXPECT_FALSE(reply.is_positive());
+        EXPECT_THAT(reply.get_features(), ElementsAre());
+        EXPECT_FALSE(reply.has_feature("FEAT"));
+    }
+
+    {
+        ftp::features_reply reply;
+        EXPECT_THAT(reply.get_features(), ElementsAre());
+    }
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <ftp/file_hash_reply.hpp>
+
+namespace
+{
+
+using ftp::hash_algorithm;
+
+TEST(file_hash_reply, construct)
+{
+    {
+        ftp::file_hash_reply reply({213, "213 SHA-256 0-7 ED7002B439E9AC845F22357D822BAC1444730FBDB6016D3EC9432297B9EC9F73 /my file"},
+                                   hash_algorithm::sha256);
+        EXPECT_EQ(213, reply.get_code());
+        EXPECT_TRUE(reply.is_positive());
+        EXPECT_EQ(hash_algorithm::sha256, reply.get_algorithm());
+        EXPECT_TRUE(reply.get_hash().has_value());
+        EXPECT_EQ("ed7002b439e9ac845f22357d822bac1444730fbdb6016d3ec9432297b9ec9f73", reply.get_hash().value());
+    }
+
+    {
+        ftp::file_hash_reply reply({250, "250 9A0364B9E99BB480DD25E1F0284C8555"}, hash_algorithm::md5);
+        EXPECT_EQ(250, reply.get_code());
+        EXPECT_TRUE(reply.is_positive());
+        EXPECT_TRUE(reply.get_hash().has_value());
+        EXPECT_EQ("9a0364b9e99bb480dd25e1f0284c8555", reply.get_hash().value());
+    }
+
+    {
+        ftp::file_hash_reply reply({250, "250 7B71F08"}, hash_algorithm::crc32);
+        EXPECT_TRUE(reply.get_hash().has_value());
+        EXPECT_EQ("07b71f08", reply.get_hash().value());
+    }
+
+    {
+        /* Unexpected hash length. */
+        ftp::file_hash_reply reply({250, "250 7B71F08D"}, hash_algorithm::md5);
+        EXPECT_TRUE(reply.is_positive());
+        EXPECT_FALSE(reply.get_hash().has_value());
+    }
+
+    {
+        ftp::file_hash_reply reply({213, "213 SHA-1 0-7 not-a-hash /file"}, hash_algorithm::sha1);
+        EXPECT_FALSE(reply.get_hash().has_value());
+    }
+
+    {
+        ftp::file_hash_reply reply({550, "550 /file is not retrievable."}, hash_algorithm::sha1);
+        EXPECT_EQ(550, reply.get_code());
+        EXPECT_FALSE(reply.is_positive());
+        EXPECT_FALSE(reply.get_hash().has_value());
+    }
+
+    {
+        ftp::file_hash_reply reply;
+        EXPECT_FALSE(reply.get_hash().has_value());
+    }
+}
+
+} // namespace
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <ftp/ftp_exception.hpp>
+#include <ftp/stream/file_output_stream.hpp>
+
+namespace
+{
+
+class file_output_stream : public testing::TestWithParam<ftp::file_output_stream::cache_mode>
+{
+protected:
+    void SetUp() override
+    {
+        path_ = std::filesystem::temp_directory_path() / "libftp_file_output_stream";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path_);
+    }
+
+    std::string read_file()
+    {
+        std::ifstream ifs(path_, std::ios_base::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return oss.str();
+    }
+
+    static std::string make_data(std::size_t size)
+    {
+        std::string data;
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            data.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        return data;
+    }
+
+    std::filesystem::path path_;
+};
+
+INSTANTIATE_TEST_SUITE_P(all_modes, file_output_stream,
+                         testing::Values(ftp::file_output_stream::cache_mode::buffered,
+                                         ftp::file_output_stream::cache_mode::drop_behind,
+                                         ftp::file_output_stream::cache_mode::direct));
+
+TEST_P(file_output_stream, write)
+{
+    /* Several buffers with an unaligned tail. */
+    std::string data = make_data(3 * ftp::file_output_stream::buffer_size + 1234);
+
+    {
+        ftp::file_output_stream stream(path_, GetParam());
+
+        for (std::size_t pos = 0; pos < data.size(); pos += 10000)
+        {
+            std::string chunk = data.substr(pos, 10000);
+            stream.write(chunk.data(), chunk.size());
+        }
+
+        stream.flush();
+        EXPECT_EQ(data, read_file());
+    }
+
+    EXPECT_EQ(data, read_file());
+}
+
+TEST_P(file_output_stream, prepare_commit)
+{
+    std::string data = make_data(2 * ftp::file_output_stream::buffer_size + 4321);
+
+    {
+        ftp::file_output_stream stream(path_, GetParam());
+
+        std::size_t too_large = ftp::file_output_stream::buffer_size + 1;
+        EXPECT_EQ(nullptr, stream.prepare(too_large));
+
+        std::size_t pos = 0;
+        while (pos < data.size())
+        {
+            std::size_t size = std::min<std::size_t>(8191, data.size() - pos);
+            char *buf = stream.prepare(size);
+            ASSERT_NE(nullptr, buf);
+
+            std::copy(data.data() + pos, data.data() + pos + size, buf);
+            stream.commit(size);
+            pos += size;
+
+            /* Mixed with write(). */
+            if (pos < data.size())
+            {
+                stream.write(data.data() + pos, 1);
+                pos += 1;
+            }
+        }
+    }
+
+    EXPECT_EQ(data, read_file());
+}
+
+TEST_P(file_output_stream, flush_and_continue)
+{
+    std::string data = make_data(10000);
+
+    ftp::file_output_stream stream(path_, GetParam());
+
+    /* In the direct mode the unaligned tail is written padded and truncated. */
+    stream.write(data.data(), 5000);
+    stream.flush();
+    EXPECT_EQ(data.substr(0, 5000), read_file());
+
+    stream.write(data.data() + 5000, 5000);
+    stream.flush();
+    EXPECT_EQ(data, read_file());
+}
+
+TEST_P(file_output_stream, preallocate)
+{
+    std::string data = make_data(1000);
+
+    ftp::file_output_stream stream(path_, GetParam());
+
+    /* The file size is not changed. */
+    stream.preallocate(10 * 1024 * 1024);
+    EXPECT_EQ(0, std::filesystem::file_size(path_));
+
+    stream.write(data.data(), data.size());
+    stream.flush();
+    EXPECT_EQ(data, read_file());
+}
+
+TEST_P(file_output_stream, truncate_existing_file)
+{
+    {
+        std::ofstream ofs(path_, std::ios_base::binary);
+        ofs << make_data(10000);
+    }
+
+    {
+        ftp::file_output_stream stream(path_, GetParam());
+    }
+
+    EXPECT_EQ("", read_file());
+}
+
+TEST_P(file_output_stream, nonexistent_directory)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "libftp_nonexistent" / "file";
+
+    EXPECT_THROW(ftp::file_output_stream stream(path, GetParam()), ftp::ftp_exception);
+}
+
+} // namespace
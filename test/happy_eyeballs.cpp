@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <ftp/detail/happy_eyeballs.hpp>
+
+namespace
+{
+
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+using namespace ftp::detail;
+
+tcp::endpoint make_endpoint(std::string_view address, std::uint16_t port)
+{
+    return { make_address(address), port };
+}
+
+/* Returns a loopback port on which nobody listens. */
+std::uint16_t get_closed_port(boost::asio::io_context & io_context, const tcp::endpoint & endpoint)
+{
+    tcp::acceptor acceptor(io_context, endpoint);
+    return acceptor.local_endpoint().port();
+}
+
+TEST(happy_eyeballs, sort_endpoints)
+{
+    EXPECT_TRUE(happy_eyeballs::sort_endpoints({}).empty());
+
+    EXPECT_EQ(std::vector<tcp::endpoint>({ make_endpoint("::1", 21),
+                                           make_endpoint("127.0.0.1", 21),
+                                           make_endpoint("::2", 21),
+                                           make_endpoint("127.0.0.2", 21),
+                                           make_endpoint("127.0.0.3", 21) }),
+              happy_eyeballs::sort_endpoints({ make_endpoint("::1", 21),
+                                               make_endpoint("::2", 21),
+                                               make_endpoint("127.0.0.1", 21),
+                                               make_endpoint("127.0.0.2", 21),
+                                               make_endpoint("127.0.0.3", 21) }));
+
+    EXPECT_EQ(std::vector<tcp::endpoint>({ make_endpoint("127.0.0.1", 21),
+                                           make_endpoint("::1", 21),
+                                           make_endpoint("127.0.0.2", 21) }),
+              happy_eyeballs::sort_endpoints({ make_endpoint("127.0.0.1", 21),
+                                               make_endpoint("127.0.0.2", 21),
+                                               make_endpoint("::1", 21) }));
+
+    EXPECT_EQ(std::vector<tcp::endpoint>({ make_endpoint("::1", 21),
+                                           make_endpoint("::2", 21) }),
+              happy_eyeballs::sort_endpoints({ make_endpoint("::1", 21),
+                                               make_endpoint("::2", 21) }));
+}
+
+TEST(happy_eyeballs, connect)
+{
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, make_endpoint("127.0.0.1", 0));
+    boost::system::error_code ec;
+
+    tcp::socket socket = happy_eyeballs::connect(io_context,
+                                                 { acceptor.local_endpoint() },
+                                                 happy_eyeballs::default_attempt_delay,
+                                                 ec);
+
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(acceptor.local_endpoint(), socket.remote_endpoint());
+}
+
+TEST(happy_eyeballs, connect_fallback_on_refused_connection)
+{
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, make_endpoint("127.0.0.1", 0));
+    boost::system::error_code ec;
+
+    std::uint16_t closed_port = get_closed_port(io_context, make_endpoint("::1", 0));
+
+    tcp::socket socket = happy_eyeballs::connect(io_context,
+                                                 { make_endpoint("::1", closed_port),
+                                                   acceptor.local_endpoint() },
+                                                 std::chrono::seconds(60),
+                                                 ec);
+
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(acceptor.local_endpoint(), socket.remote_endpoint());
+}
+
+TEST(happy_eyeballs, connect_fallback_on_stalled_connection)
+{
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, make_endpoint("::1", 0));
+    boost::system::error_code ec;
+
+    /* A listener that never accepts and has a full backlog drops incoming
+     * SYN segments, which looks like a blackholed address to the client.
+     */
+    tcp::acceptor stalled_acceptor(io_context);
+    stalled_acceptor.open(tcp::v4());
+    stalled_acceptor.bind(make_endpoint("127.0.0.1", 0));
+    stalled_acceptor.listen(0);
+
+    tcp::socket queued(io_context);
+    queued.connect(stalled_acceptor.local_endpoint());
+
+    tcp::socket socket = happy_eyeballs::connect(io_context,
+                                                 { stalled_acceptor.local_endpoint(),
+                                                   acceptor.local_endpoint() },
+                                                 std::chrono::milliseconds(50),
+                                                 ec);
+
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(acceptor.local_endpoint(), socket.remote_endpoint());
+}
+
+TEST(happy_eyeballs, connect_failure)
+{
+    boost::asio::io_context io_context;
+    boost::system::error_code ec;
+
+    std::uint16_t closed_port_v4 = get_closed_port(io_context, make_endpoint("127.0.0.1", 0));
+    std::uint16_t closed_port_v6 = get_closed_port(io_context, make_endpoint("::1", 0));
+
+    tcp::socket socket = happy_eyeballs::connect(io_context,
+                                                 { make_endpoint("::1", closed_port_v6),
+                                                   make_endpoint("127.0.0.1", closed_port_v4) },
+                                                 happy_eyeballs::default_attempt_delay,
+                                                 ec);
+
+    EXPECT_EQ(boost::asio::error::connection_refused, ec);
+    EXPECT_FALSE(socket.is_open());
+
+    socket = happy_eyeballs::connect(io_context, {}, happy_eyeballs::default_attempt_delay, ec);
+
+    EXPECT_EQ(boost::asio::error::host_not_found, ec);
+    EXPECT_FALSE(socket.is_open());
+}
+
+} // namespace
@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <ftp/detail/hasher.hpp>
+
+namespace
+{
+
+using ftp::hash_algorithm;
+using ftp::detail::hasher;
+
+std::string compute_hash(hash_algorithm algorithm, std::string_view data)
+{
+    hasher hasher(algorithm);
+
+    /* Feed the data in chunks to check the incremental update. */
+    for (std::size_t pos = 0; pos < data.size(); pos += 2)
+    {
+        std::string_view chunk = data.substr(pos, 2);
+        hasher.update(chunk.data(), chunk.size());
+    }
+
+    return hasher.finish();
+}
+
+TEST(hasher, finish)
+{
+    EXPECT_EQ("352441c2", compute_hash(hash_algorithm::crc32, "abc"));
+    EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72", compute_hash(hash_algorithm::md5, "abc"));
+    EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", compute_hash(hash_algorithm::sha1, "abc"));
+    EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+              compute_hash(hash_algorithm::sha256, "abc"));
+    EXPECT_EQ("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+              "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+              compute_hash(hash_algorithm::sha512, "abc"));
+
+    EXPECT_EQ("00000000", compute_hash(hash_algorithm::crc32, ""));
+    EXPECT_EQ("d41d8cd98f00b204e9800998ecf8427e", compute_hash(hash_algorithm::md5, ""));
+}
+
+TEST(hasher, get_hex_length)
+{
+    for (hash_algorithm algorithm : { hash_algorithm::crc32,
+                                      hash_algorithm::md5,
+                                      hash_algorithm::sha1,
+                                      hash_algorithm::sha256,
+                                      hash_algorithm::sha512 })
+    {
+        EXPECT_EQ(hasher::get_hex_length(algorithm), compute_hash(algorithm, "content").size());
+    }
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/local_address_pool.hpp>
+
+using ftp::local_address_pool;
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+
+TEST(local_address_pool, round_robin)
+{
+    local_address_pool pool({ make_address("10.0.0.1"), make_address("10.0.0.2"), make_address("10.0.0.3") });
+
+    EXPECT_EQ(make_address("10.0.0.1"), pool.next(tcp::v4()));
+    EXPECT_EQ(make_address("10.0.0.2"), pool.next(tcp::v4()));
+    EXPECT_EQ(make_address("10.0.0.3"), pool.next(tcp::v4()));
+    EXPECT_EQ(make_address("10.0.0.1"), pool.next(tcp::v4()));
+}
+
+TEST(local_address_pool, address_family)
+{
+    local_address_pool pool({ make_address("10.0.0.1"), make_address("fd00::1"), make_address("10.0.0.2") });
+
+    EXPECT_EQ(make_address("10.0.0.1"), pool.next(tcp::v4()));
+    EXPECT_EQ(make_address("10.0.0.2"), pool.next(tcp::v4()));
+    EXPECT_EQ(make_address("fd00::1"), pool.next(tcp::v6()));
+    EXPECT_EQ(make_address("fd00::1"), pool.next(tcp::v6()));
+
+    local_address_pool v4_pool({ make_address("10.0.0.1") });
+
+    EXPECT_EQ(std::nullopt, v4_pool.next(tcp::v6()));
+}
+
+TEST(local_address_pool, empty)
+{
+    local_address_pool pool({});
+
+    EXPECT_TRUE(pool.get_addresses().empty());
+    EXPECT_EQ(std::nullopt, pool.next(tcp::v4()));
+}
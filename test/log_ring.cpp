@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/detail/log_ring.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ftp::detail::log_ring;
+
+TEST(log_ring, push_pop)
+{
+    log_ring ring(3);
+    log_ring::record record;
+
+    ASSERT_EQ(4, ring.get_capacity());
+    ASSERT_FALSE(ring.try_pop(record));
+
+    ASSERT_TRUE(ring.try_push(1, 2, "data"));
+    ASSERT_EQ(1, ring.get_push_count());
+
+    ASSERT_TRUE(ring.try_pop(record));
+    ASSERT_EQ(1, record.timestamp);
+    ASSERT_EQ(2, record.type);
+    ASSERT_EQ("data", std::string(record.data, record.size));
+    ASSERT_EQ(1, ring.get_pop_count());
+
+    ASSERT_FALSE(ring.try_pop(record));
+}
+
+TEST(log_ring, full)
+{
+    log_ring ring(2);
+    log_ring::record record;
+
+    /* Go around the ring several times. */
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(ring.try_push(i, 0, "first"));
+        ASSERT_TRUE(ring.try_push(i, 0, "second"));
+        ASSERT_FALSE(ring.try_push(i, 0, "third"));
+
+        ASSERT_TRUE(ring.try_pop(record));
+        ASSERT_EQ("first", std::string(record.data, record.size));
+        ASSERT_TRUE(ring.try_pop(record));
+        ASSERT_EQ("second", std::string(record.data, record.size));
+        ASSERT_FALSE(ring.try_pop(record));
+    }
+}
+
+TEST(log_ring, truncate)
+{
+    log_ring ring(2);
+    log_ring::record record;
+
+    ASSERT_TRUE(ring.try_push(0, 0, std::string(log_ring::max_data_size + 1, 'x')));
+
+    ASSERT_TRUE(ring.try_pop(record));
+    ASSERT_EQ(std::string(log_ring::max_data_size, 'x'), std::string(record.data, record.size));
+}
+
+TEST(log_ring, producers)
+{
+    const int producer_count = 4;
+    const int record_count = 10000;
+
+    log_ring ring(64);
+    std::vector<std::thread> producers;
+
+    for (int i = 0; i < producer_count; ++i)
+    {
+        producers.emplace_back([&ring, i]()
+        {
+            for (int j = 0; j < record_count; ++j)
+            {
+                std::string data = std::to_string(j);
+
+                while (!ring.try_push(j, static_cast<std::uint8_t>(i), data))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    /* The records of each producer are taken in its order. */
+    std::vector<int> next(producer_count, 0);
+    log_ring::record record;
+
+    for (int taken = 0; taken < producer_count * record_count;)
+    {
+        if (!ring.try_pop(record))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ASSERT_EQ(next[record.type], record.timestamp);
+        ASSERT_EQ(std::to_string(next[record.type]), std::string(record.data, record.size));
+        ++next[record.type];
+        ++taken;
+    }
+
+    for (std::thread & producer : producers)
+    {
+        producer.join();
+    }
+}
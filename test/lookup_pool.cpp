@@ -0,0 +1,184 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/detail/lookup_pool.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ftp::detail::lookup_pool;
+using boost::asio::ip::tcp;
+
+namespace
+{
+
+/* Blocks the lookups until it is opened. */
+class gate
+{
+public:
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        open_ = true;
+        cv_.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        cv_.wait(lock, [this]()
+        {
+            return open_;
+        });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool open_ = false;
+};
+
+std::chrono::steady_clock::time_point after(std::chrono::milliseconds timeout)
+{
+    return std::chrono::steady_clock::now() + timeout;
+}
+
+void wait_for_threads_exit(const lookup_pool & pool)
+{
+    for (int i = 0; i < 500 && pool.get_thread_count() > 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+} // namespace
+
+TEST(lookup_pool, lookup)
+{
+    std::shared_ptr<lookup_pool> pool = lookup_pool::create([](const std::string & hostname, std::uint16_t port)
+    {
+        boost::system::error_code ec;
+
+        if (hostname != "localhost")
+        {
+            ec = boost::asio::error::host_not_found;
+            return lookup_pool::result({}, ec);
+        }
+
+        return lookup_pool::result({ tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port) }, ec);
+    });
+
+    lookup_pool::result result = pool->lookup("localhost", 21, after(std::chrono::seconds(5)));
+    ASSERT_FALSE(result.second);
+    ASSERT_EQ(1, result.first.size());
+    ASSERT_EQ(21, result.first[0].port());
+
+    result = pool->lookup("nonexistent", 21, after(std::chrono::seconds(5)));
+    ASSERT_EQ(boost::asio::error::host_not_found, result.second);
+
+    wait_for_threads_exit(*pool);
+    ASSERT_EQ(0, pool->get_thread_count());
+}
+
+TEST(lookup_pool, join_running_lookup)
+{
+    gate gate;
+    std::atomic<int> lookups = 0;
+
+    std::shared_ptr<lookup_pool> pool = lookup_pool::create([&](const std::string &, std::uint16_t port)
+    {
+        lookups++;
+        gate.wait();
+
+        return lookup_pool::result({ tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), port) }, {});
+    });
+
+    /* The caller gives up, the lookup goes on. */
+    lookup_pool::result result = pool->lookup("localhost", 21, after(std::chrono::milliseconds(50)));
+    ASSERT_EQ(boost::asio::error::timed_out, result.second);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> resolved = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            if (!pool->lookup("localhost", 21, after(std::chrono::seconds(5))).second)
+            {
+                resolved++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.open();
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(4, resolved);
+    ASSERT_EQ(1, lookups);
+}
+
+TEST(lookup_pool, bounded_threads)
+{
+    gate gate;
+    std::atomic<int> lookups = 0;
+
+    std::shared_ptr<lookup_pool> pool = lookup_pool::create([&](const std::string &, std::uint16_t)
+    {
+        lookups++;
+        gate.wait();
+
+        return lookup_pool::result({}, boost::asio::error::host_not_found);
+    }, 2);
+
+    /* The DNS server does not respond. */
+    for (int i = 0; i < 10; ++i)
+    {
+        std::string hostname = "host" + std::to_string(i);
+
+        lookup_pool::result result = pool->lookup(hostname, 21, after(std::chrono::milliseconds(10)));
+        ASSERT_EQ(boost::asio::error::timed_out, result.second);
+        ASSERT_LE(pool->get_thread_count(), 2);
+    }
+
+    gate.open();
+    wait_for_threads_exit(*pool);
+
+    ASSERT_EQ(0, pool->get_thread_count());
+
+    /* The queued requests nobody waits for are dropped. */
+    ASSERT_LE(lookups, 2);
+}
@@ -0,0 +1,178 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <ftp/ftp_exception.hpp>
+#include <ftp/stream/mapped_file_input_stream.hpp>
+
+namespace
+{
+
+class mapped_file_input_stream : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = std::filesystem::temp_directory_path() / "libftp_mapped_file_input_stream";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path_);
+    }
+
+    void write_file(const std::string & data)
+    {
+        std::ofstream ofs(path_, std::ios_base::binary);
+        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    static std::string make_data(std::size_t size)
+    {
+        std::string data;
+
+        for (std::size_t i = 0; i < size; i++)
+        {
+            data.push_back(static_cast<char>('a' + i % 26));
+        }
+
+        return data;
+    }
+
+    std::filesystem::path path_;
+};
+
+TEST_F(mapped_file_input_stream, read)
+{
+    /* Several windows of the smallest size. */
+    std::string data = make_data(100000);
+    write_file(data);
+
+    ftp::mapped_file_input_stream stream(path_, 1);
+    EXPECT_EQ(data.size(), stream.get_size());
+
+    std::string result;
+    std::string buf(1000, '\0');
+
+    while (std::size_t size = stream.read(buf.data(), buf.size()))
+    {
+        result.append(buf.data(), size);
+    }
+
+    EXPECT_EQ(data, result);
+}
+
+TEST_F(mapped_file_input_stream, peek_consume)
+{
+    std::string data = make_data(100000);
+    write_file(data);
+
+    ftp::mapped_file_input_stream stream(path_, 1);
+    std::string result;
+
+    for (;;)
+    {
+        std::optional<std::string_view> region = stream.peek(10000);
+        ASSERT_TRUE(region.has_value());
+        ASSERT_LE(region->size(), 10000);
+
+        if (region->empty())
+        {
+            break;
+        }
+
+        result.append(region->data(), region->size());
+        stream.consume(region->size());
+    }
+
+    EXPECT_EQ(data, result);
+}
+
+TEST_F(mapped_file_input_stream, empty_file)
+{
+    write_file("");
+
+    ftp::mapped_file_input_stream stream(path_);
+    EXPECT_EQ(0, stream.get_size());
+
+    char buf[16];
+    EXPECT_EQ(0, stream.read(buf, sizeof(buf)));
+}
+
+TEST_F(mapped_file_input_stream, range)
+{
+    std::string data = make_data(100000);
+    write_file(data);
+
+    ftp::mapped_file_input_stream stream(path_, 1);
+
+    /* The range starts and ends within windows. */
+    stream.set_range(12345, 50000);
+
+    std::string result;
+    std::string buf(1000, '\0');
+
+    while (std::size_t size = stream.read(buf.data(), buf.size()))
+    {
+        result.append(buf.data(), size);
+    }
+
+    EXPECT_EQ(data.substr(12345, 50000), result);
+
+    EXPECT_THROW(stream.set_range(50000, 50001), ftp::ftp_exception);
+    EXPECT_THROW(stream.set_range(100001, 0), ftp::ftp_exception);
+}
+
+#ifndef _WIN32
+TEST_F(mapped_file_input_stream, truncated_file)
+{
+    std::string data = make_data(100000);
+    write_file(data);
+
+    ftp::mapped_file_input_stream stream(path_, 1);
+
+    std::string buf(1000, '\0');
+    ASSERT_EQ(buf.size(), stream.read(buf.data(), buf.size()));
+
+    /* The next windows are not mapped past the end of the file. */
+    std::filesystem::resize_file(path_, 1000);
+
+    EXPECT_THROW(
+        while (stream.read(buf.data(), buf.size()) > 0)
+        {
+        },
+        ftp::ftp_exception);
+}
+#endif
+
+TEST_F(mapped_file_input_stream, nonexistent_file)
+{
+    EXPECT_THROW(ftp::mapped_file_input_stream stream(path_), ftp::ftp_exception);
+}
+
+} // namespace
@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <ftp/ftp_exception.hpp>
+#include <ftp/stream/memory_output_stream.hpp>
+
+namespace
+{
+
+std::string make_data(std::size_t size)
+{
+    std::string data;
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+
+    return data;
+}
+
+TEST(memory_output_stream, write)
+{
+    std::string data = make_data(100000);
+    ftp::memory_output_stream stream;
+
+    for (std::size_t pos = 0; pos < data.size(); pos += 1000)
+    {
+        stream.write(data.data() + pos, 1000);
+    }
+
+    stream.flush();
+
+    EXPECT_EQ(data.size(), stream.get_size());
+    EXPECT_EQ(data, stream.get_data());
+    EXPECT_EQ(data, stream.release());
+    EXPECT_EQ(0, stream.get_size());
+}
+
+TEST(memory_output_stream, prepare_commit)
+{
+    std::string data = make_data(1000);
+    ftp::memory_output_stream stream;
+
+    stream.preallocate(data.size());
+
+    std::size_t pos = 0;
+    while (pos < data.size())
+    {
+        std::size_t size = std::min<std::size_t>(30, data.size() - pos);
+        char *buf = stream.prepare(size);
+        ASSERT_NE(nullptr, buf);
+
+        /* A discarded buffer. */
+        std::fill(buf, buf + size, 'x');
+        buf = stream.prepare(size);
+        ASSERT_NE(nullptr, buf);
+        ASSERT_EQ(std::min<std::size_t>(30, data.size() - pos), size);
+
+        std::copy(data.data() + pos, data.data() + pos + size, buf);
+        stream.commit(size);
+        pos += size;
+
+        /* Mixed with write(). */
+        if (pos < data.size())
+        {
+            stream.write(data.data() + pos, 1);
+            pos += 1;
+        }
+    }
+
+    /* The preallocated buffer is full, it is not reallocated to lend memory. */
+    std::size_t size = 1;
+    EXPECT_EQ(nullptr, stream.prepare(size));
+
+    std::string result = stream.release();
+    EXPECT_EQ(data, result);
+}
+
+TEST(memory_output_stream, preallocated_buffer_is_kept)
+{
+    std::string data = make_data(10000);
+    ftp::memory_output_stream stream;
+
+    stream.preallocate(data.size());
+
+    const char *buffer = stream.get_data().data();
+    std::size_t pos = 0;
+
+    while (pos < data.size())
+    {
+        /* The tail shorter than a whole receive is lent as well. */
+        std::size_t size = 4096;
+        char *buf = stream.prepare(size);
+        ASSERT_NE(nullptr, buf);
+        ASSERT_EQ(std::min<std::size_t>(4096, data.size() - pos), size);
+
+        std::copy(data.data() + pos, data.data() + pos + size, buf);
+        stream.commit(size);
+        pos += size;
+    }
+
+    EXPECT_EQ(buffer, stream.get_data().data());
+    EXPECT_EQ(data, stream.get_data());
+
+    /* More data than expected is written to a reallocated buffer. */
+    std::size_t size = 4096;
+    EXPECT_EQ(nullptr, stream.prepare(size));
+
+    stream.write(data.data(), data.size());
+    EXPECT_EQ(data + data, stream.get_data());
+}
+
+TEST(memory_output_stream, caller_buffer)
+{
+    std::string data = make_data(100);
+    std::vector<char> buffer(data.size());
+    ftp::memory_output_stream stream(buffer.data(), buffer.size());
+
+    stream.preallocate(buffer.size());
+    EXPECT_THROW(stream.preallocate(buffer.size() + 1), ftp::ftp_exception);
+
+    std::size_t size = 60;
+    char *buf = stream.prepare(size);
+    ASSERT_EQ(buffer.data(), buf);
+    ASSERT_EQ(60, size);
+    std::copy(data.data(), data.data() + 60, buf);
+    stream.commit(60);
+
+    /* The rest of the buffer is lent. */
+    buf = stream.prepare(size);
+    ASSERT_EQ(buffer.data() + 60, buf);
+    ASSERT_EQ(40, size);
+    std::copy(data.data() + 60, data.data() + 100, buf);
+    stream.commit(40);
+
+    EXPECT_EQ(nullptr, stream.prepare(size));
+
+    EXPECT_EQ(buffer.data(), stream.get_data().data());
+    EXPECT_EQ(data, stream.get_data());
+    EXPECT_THROW(stream.write(data.data(), 1), ftp::ftp_exception);
+
+    EXPECT_EQ(data, stream.release());
+    EXPECT_EQ(0, stream.get_size());
+}
+
+} // namespace
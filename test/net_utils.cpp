@@ -24,6 +24,9 @@
 
 #include <gtest/gtest.h>
 #include <ftp/detail/net_utils.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 namespace
 {
@@ -43,4 +46,94 @@ TEST(net_utils, address_to_string)
               ftp::detail::net_utils::address_to_string(make_address("2345:425:2CA1::567:5673:23B5")));
 }
 
+TEST(net_utils, set_socket_options)
+{
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.open(boost::asio::ip::tcp::v4());
+
+    ftp::socket_options options;
+    options.no_delay = true;
+    options.send_buffer_size = 65536;
+    options.receive_buffer_size = 65536;
+    options.keep_alive = true;
+
+    boost::system::error_code ec;
+    ftp::detail::net_utils::set_socket_options(socket, options, ec);
+    ASSERT_FALSE(ec) << ec.message();
+
+    boost::asio::ip::tcp::no_delay no_delay;
+    socket.get_option(no_delay);
+    EXPECT_TRUE(no_delay.value());
+
+    boost::asio::socket_base::keep_alive keep_alive;
+    socket.get_option(keep_alive);
+    EXPECT_TRUE(keep_alive.value());
+
+    /* The system may round the size up, e.g. Linux doubles it. */
+    boost::asio::socket_base::receive_buffer_size receive_buffer_size;
+    socket.get_option(receive_buffer_size);
+    EXPECT_GE(receive_buffer_size.value(), 65536);
+
+    /* Nothing to set. */
+    ftp::detail::net_utils::set_socket_options(socket, ftp::socket_options(), ec);
+    ASSERT_FALSE(ec);
+}
+
+TEST(net_utils, set_invalid_socket_options)
+{
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.open(boost::asio::ip::tcp::v4());
+
+    ftp::socket_options options;
+    options.congestion_control = "nonexistent";
+
+    boost::system::error_code ec;
+    ftp::detail::net_utils::set_socket_options(socket, options, ec);
+    ASSERT_TRUE(ec);
+}
+
+TEST(net_utils, run_until_timed_out)
+{
+    boost::asio::io_context io_context;
+    boost::asio::steady_timer timer(io_context, std::chrono::hours(1));
+    boost::system::error_code ec;
+
+    ftp::detail::net_utils::run_until(io_context, std::chrono::steady_clock::now() + std::chrono::milliseconds(10),
+        [&timer](auto handler)
+        {
+            timer.async_wait([handler](const boost::system::error_code & ec) mutable
+            {
+                handler(ec, 0);
+            });
+        }, [&timer]()
+        {
+            timer.cancel();
+        }, ec);
+
+    EXPECT_EQ(boost::asio::error::timed_out, ec);
+}
+
+TEST(net_utils, run_until_completed_at_deadline)
+{
+    boost::asio::io_context io_context;
+    boost::system::error_code ec;
+
+    /* The operation completes, but its handler runs only after the deadline. */
+    std::size_t size = ftp::detail::net_utils::run_until(io_context, std::chrono::steady_clock::now(),
+        [&io_context](auto handler)
+        {
+            boost::asio::post(io_context, [handler]() mutable
+            {
+                handler(boost::system::error_code(), 42);
+            });
+        }, []()
+        {
+        }, ec);
+
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(42, size);
+}
+
 } // namespace
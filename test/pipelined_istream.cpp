@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <ftp/stream/istream_adapter.hpp>
+#include <ftp/stream/pipelined_istream.hpp>
+
+namespace
+{
+
+class throwing_istream : public ftp::input_stream
+{
+public:
+    explicit throwing_istream(std::size_t size)
+        : size_(size)
+    {
+    }
+
+    std::size_t read(char *buf, std::size_t size) override
+    {
+        if (size_ == 0)
+        {
+            throw std::runtime_error("read failed");
+        }
+
+        size = std::min(size, size_);
+        std::fill(buf, buf + size, 'a');
+        size_ -= size;
+
+        return size;
+    }
+
+private:
+    std::size_t size_;
+};
+
+std::string read_all(ftp::input_stream & stream, std::size_t block_size)
+{
+    std::string result;
+    std::string buf(block_size, '\0');
+
+    while (std::size_t size = stream.read(buf.data(), buf.size()))
+    {
+        result.append(buf.data(), size);
+    }
+
+    return result;
+}
+
+std::string make_data(std::size_t size)
+{
+    std::string data;
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+
+    return data;
+}
+
+TEST(pipelined_istream, read)
+{
+    std::string data = make_data(10000);
+    std::istringstream iss(data);
+    ftp::istream_adapter adapter(iss);
+    ftp::pipelined_istream stream(adapter, 100, 3);
+
+    EXPECT_EQ(data, read_all(stream, 37));
+
+    /* EOF is sticky. */
+    char buf[16];
+    EXPECT_EQ(0, stream.read(buf, sizeof(buf)));
+}
+
+TEST(pipelined_istream, peek_consume)
+{
+    std::string data = make_data(1000);
+    std::istringstream iss(data);
+    ftp::istream_adapter adapter(iss);
+    ftp::pipelined_istream stream(adapter, 100, 3);
+    std::string result;
+
+    for (;;)
+    {
+        std::optional<std::string_view> region = stream.peek(64);
+        ASSERT_TRUE(region.has_value());
+        ASSERT_LE(region->size(), 64);
+
+        if (region->empty())
+        {
+            break;
+        }
+
+        /* Consume a part of the region, mixed with read(). */
+        std::size_t size = (region->size() + 1) / 2;
+        result.append(region->data(), size);
+        stream.consume(size);
+
+        char c;
+        if (stream.read(&c, 1) == 1)
+        {
+            result.push_back(c);
+        }
+    }
+
+    EXPECT_EQ(data, result);
+}
+
+TEST(pipelined_istream, read_empty)
+{
+    std::istringstream iss;
+    ftp::istream_adapter adapter(iss);
+    ftp::pipelined_istream stream(adapter);
+
+    EXPECT_EQ("", read_all(stream, 16));
+}
+
+TEST(pipelined_istream, error)
+{
+    throwing_istream src(250);
+    ftp::pipelined_istream stream(src, 100, 2);
+    std::string buf(1000, '\0');
+    std::size_t total = 0;
+
+    /* The data read before the error is returned first. */
+    EXPECT_THROW(
+        while (true)
+        {
+            total += stream.read(buf.data(), buf.size());
+        },
+        std::runtime_error);
+
+    EXPECT_EQ(250, total);
+}
+
+TEST(pipelined_istream, destroy_unread)
+{
+    std::string data = make_data(10000);
+    std::istringstream iss(data);
+    ftp::istream_adapter adapter(iss);
+    ftp::pipelined_istream stream(adapter, 100, 2);
+    char buf[10];
+
+    EXPECT_EQ(10, stream.read(buf, sizeof(buf)));
+}
+
+} // namespace
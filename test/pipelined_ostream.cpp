@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <ftp/stream/ostream_adapter.hpp>
+#include <ftp/stream/pipelined_ostream.hpp>
+
+namespace
+{
+
+class throwing_ostream : public ftp::output_stream
+{
+public:
+    void write(char *buf, std::size_t size) override
+    {
+        throw std::runtime_error("write failed");
+    }
+
+    void flush() override
+    {
+    }
+};
+
+std::string make_data(std::size_t size)
+{
+    std::string data;
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        data.push_back(static_cast<char>('a' + i % 26));
+    }
+
+    return data;
+}
+
+TEST(pipelined_ostream, write)
+{
+    std::string data = make_data(10000);
+    std::ostringstream oss;
+    ftp::ostream_adapter adapter(oss);
+
+    {
+        ftp::pipelined_ostream stream(adapter, 100, 3);
+
+        for (std::size_t pos = 0; pos < data.size(); pos += 37)
+        {
+            std::string chunk = data.substr(pos, 37);
+            stream.write(chunk.data(), chunk.size());
+        }
+
+        stream.flush();
+        EXPECT_EQ(data, oss.str());
+    }
+
+    EXPECT_EQ(data, oss.str());
+}
+
+TEST(pipelined_ostream, write_on_destruction)
+{
+    std::string data = make_data(250);
+    std::ostringstream oss;
+    ftp::ostream_adapter adapter(oss);
+
+    {
+        ftp::pipelined_ostream stream(adapter, 100, 2);
+        stream.write(data.data(), data.size());
+    }
+
+    EXPECT_EQ(data, oss.str());
+}
+
+TEST(pipelined_ostream, prepare_commit)
+{
+    std::string data = make_data(1000);
+    std::ostringstream oss;
+    ftp::ostream_adapter adapter(oss);
+
+    {
+        ftp::pipelined_ostream stream(adapter, 100, 2);
+
+        /* Larger than a buffer. */
+        std::size_t too_large = 101;
+        EXPECT_EQ(nullptr, stream.prepare(too_large));
+
+        std::size_t pos = 0;
+        while (pos < data.size())
+        {
+            std::size_t size = std::min<std::size_t>(30, data.size() - pos);
+            char *buf = stream.prepare(size);
+            ASSERT_NE(nullptr, buf);
+
+            /* A discarded buffer. */
+            std::fill(buf, buf + size, 'x');
+            buf = stream.prepare(size);
+            ASSERT_NE(nullptr, buf);
+
+            std::copy(data.data() + pos, data.data() + pos + size, buf);
+            stream.commit(size);
+            pos += size;
+
+            /* Mixed with write(). */
+            if (pos < data.size())
+            {
+                stream.write(data.data() + pos, 1);
+                pos += 1;
+            }
+        }
+
+        stream.flush();
+    }
+
+    EXPECT_EQ(data, oss.str());
+}
+
+TEST(pipelined_ostream, error)
+{
+    throwing_ostream dst;
+    ftp::pipelined_ostream stream(dst, 100, 2);
+    std::string data = make_data(100);
+
+    /* The first full buffer fails on the writer thread. */
+    stream.write(data.data(), data.size());
+
+    EXPECT_THROW(stream.flush(), std::runtime_error);
+    EXPECT_THROW(stream.write(data.data(), data.size()), std::runtime_error);
+}
+
+} // namespace
@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <ftp/progress_reporter.hpp>
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+class recording_reporter : public ftp::progress_reporter
+{
+public:
+    explicit recording_reporter(std::chrono::milliseconds interval)
+        : progress_reporter(interval)
+    {}
+
+    [[nodiscard]] const std::vector<ftp::progress> & get_reports() const
+    {
+        return reports_;
+    }
+
+protected:
+    void on_progress(const ftp::progress & progress) override
+    {
+        reports_.push_back(progress);
+    }
+
+private:
+    std::vector<ftp::progress> reports_;
+};
+
+} // namespace
+
+TEST(progress_reporter, coalesces_notifications)
+{
+    recording_reporter reporter(50ms);
+    reporter.set_total_size(1000000);
+
+    reporter.begin();
+
+    /* 100 notifications of 1000 bytes in about 200 ms. */
+    for (int i = 0; i < 100; i++)
+    {
+        reporter.notify(1000);
+        std::this_thread::sleep_for(2ms);
+    }
+
+    reporter.end();
+
+    const std::vector<ftp::progress> & reports = reporter.get_reports();
+
+    ASSERT_GE(reports.size(), 2);
+    ASSERT_LE(reports.size(), 10);
+
+    for (std::size_t i = 0; i + 1 < reports.size(); i++)
+    {
+        ASSERT_FALSE(reports[i].done);
+        ASSERT_TRUE(reports[i].eta);
+        ASSERT_GT(reports[i].throughput, 0);
+        ASSERT_EQ(1000000, reports[i].total_size);
+    }
+
+    const ftp::progress & last = reports.back();
+
+    ASSERT_TRUE(last.done);
+    ASSERT_EQ(100000, last.bytes_transferred);
+    ASSERT_GE(last.elapsed, 200ms);
+    ASSERT_EQ(std::chrono::steady_clock::duration::zero(), last.eta);
+}
+
+TEST(progress_reporter, estimates_throughput)
+{
+    recording_reporter reporter(20ms);
+    reporter.set_total_size(200000);
+
+    reporter.begin();
+
+    /* About 100000 bytes per second. */
+    for (int i = 0; i < 50; i++)
+    {
+        std::this_thread::sleep_for(2ms);
+        reporter.notify(200);
+    }
+
+    const std::vector<ftp::progress> & reports = reporter.get_reports();
+
+    ASSERT_FALSE(reports.empty());
+
+    /* Sleeping takes at least the requested time, so the throughput is not higher. */
+    const ftp::progress & progress = reports.back();
+    ASSERT_LE(progress.throughput, 110000);
+    ASSERT_GT(progress.throughput, 10000);
+
+    /* The time left is the rest of the size at the throughput. */
+    double expected = static_cast<double>(200000 - progress.bytes_transferred) / progress.throughput;
+    ASSERT_NEAR(expected, std::chrono::duration<double>(progress.eta.value()).count(), 0.01);
+}
+
+TEST(progress_reporter, unknown_size)
+{
+    recording_reporter reporter(1ms);
+
+    reporter.begin();
+    std::this_thread::sleep_for(2ms);
+    reporter.notify(100);
+    reporter.end();
+
+    const std::vector<ftp::progress> & reports = reporter.get_reports();
+
+    ASSERT_EQ(2, reports.size());
+    ASSERT_FALSE(reports[0].total_size);
+    ASSERT_FALSE(reports[0].eta);
+    ASSERT_TRUE(reports[1].done);
+}
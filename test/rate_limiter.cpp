@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/rate_limiter.hpp>
+#include <atomic>
+#include <thread>
+
+using ftp::rate_limiter;
+using namespace std::chrono_literals;
+
+TEST(rate_limiter, unlimited)
+{
+    rate_limiter limiter(0);
+
+    ASSERT_EQ(0ns, limiter.reserve(1000000000));
+    ASSERT_EQ(0ns, limiter.reserve(1000000000));
+}
+
+TEST(rate_limiter, burst)
+{
+    rate_limiter limiter(1000, 500);
+
+    ASSERT_EQ(500, limiter.get_burst());
+    ASSERT_EQ(0ns, limiter.reserve(500));
+
+    /* The bucket is empty, 1000 bytes take one second at the rate. */
+    std::chrono::nanoseconds delay = limiter.reserve(1000);
+
+    ASSERT_GT(delay, 990ms);
+    ASSERT_LE(delay, 1s);
+}
+
+TEST(rate_limiter, default_burst)
+{
+    rate_limiter limiter(1000);
+
+    ASSERT_EQ(100, limiter.get_burst());
+
+    limiter.set_rate(5);
+
+    ASSERT_EQ(1, limiter.get_burst());
+}
+
+TEST(rate_limiter, debt)
+{
+    rate_limiter limiter(1000, 100);
+
+    /* A transfer larger than the burst is delayed, not rejected. */
+    ASSERT_GT(limiter.reserve(1100), 990ms);
+
+    /* The next transfer waits for the debt to be paid off too. */
+    ASSERT_GT(limiter.reserve(1000), 1990ms);
+}
+
+TEST(rate_limiter, parent)
+{
+    auto global = std::make_shared<rate_limiter>(1000, 1000);
+    rate_limiter first(1000000, 1000000, global);
+    rate_limiter second(1000000, 1000000, global);
+
+    ASSERT_EQ(global, first.get_parent());
+    ASSERT_EQ(0ns, first.reserve(1000));
+
+    /* The parent is shared, it has no tokens left. */
+    ASSERT_GT(second.reserve(1000), 990ms);
+}
+
+TEST(rate_limiter, set_rate)
+{
+    rate_limiter limiter(1000, 100);
+
+    ASSERT_EQ(0ns, limiter.reserve(100));
+
+    limiter.set_rate(0);
+
+    ASSERT_EQ(0, limiter.get_rate());
+    ASSERT_EQ(0ns, limiter.reserve(1000000));
+
+    /* The bucket is full after the limit is restored. */
+    limiter.set_rate(1000, 100);
+
+    ASSERT_EQ(0ns, limiter.reserve(100));
+    ASSERT_GT(limiter.reserve(100), 90ms);
+}
+
+TEST(rate_limiter, consume)
+{
+    rate_limiter limiter(100000, 1000);
+
+    auto start = std::chrono::steady_clock::now();
+
+    /* 1000 bytes from the bucket, then 10000 bytes at 100000 bytes/s. */
+    for (int i = 0; i < 11; i++)
+    {
+        limiter.consume(1000);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_GE(elapsed, 100ms);
+    ASSERT_LT(elapsed, 1s);
+}
+
+TEST(rate_limiter, consume_stop)
+{
+    rate_limiter limiter(1000, 1);
+    std::atomic<bool> stop(false);
+
+    std::thread thread([&stop]()
+    {
+        std::this_thread::sleep_for(100ms);
+        stop = true;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    /* 10 seconds at the rate. */
+    ASSERT_FALSE(limiter.consume(10000, stop, std::nullopt));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+
+    thread.join();
+}
+
+TEST(rate_limiter, consume_deadline)
+{
+    rate_limiter limiter(1000, 1);
+    std::atomic<bool> stop(false);
+
+    auto start = std::chrono::steady_clock::now();
+
+    ASSERT_FALSE(limiter.consume(10000, stop, start + 100ms));
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_GE(elapsed, 100ms);
+    ASSERT_LT(elapsed, 1s);
+}
+
+TEST(rate_limiter, consume_set_rate)
+{
+    auto global = std::make_shared<rate_limiter>(1000, 1);
+    rate_limiter limiter(0, 0, global);
+
+    std::thread thread([&global]()
+    {
+        std::this_thread::sleep_for(100ms);
+        global->set_rate(0);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    /* The parent limit is lifted during the wait. */
+    limiter.consume(10000);
+
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+
+    thread.join();
+}
@@ -0,0 +1,238 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <ftp/resolver.hpp>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+
+class test_resolver : public ftp::resolver
+{
+public:
+    using ftp::resolver::resolve;
+
+    std::vector<tcp::endpoint> resolve(std::string_view hostname,
+                                       std::uint16_t port,
+                                       boost::system::error_code & ec) override
+    {
+        requests_++;
+
+        std::this_thread::sleep_for(delay_);
+
+        if (hostname == "localhost")
+        {
+            ec.clear();
+            return { { make_address("::1"), port }, { make_address("127.0.0.1"), port } };
+        }
+        else
+        {
+            ec = boost::asio::error::host_not_found;
+            return {};
+        }
+    }
+
+    void set_delay(std::chrono::milliseconds delay)
+    {
+        delay_ = delay;
+    }
+
+    [[nodiscard]] int get_requests() const
+    {
+        return requests_;
+    }
+
+private:
+    std::atomic<int> requests_ = 0;
+    std::chrono::milliseconds delay_ = std::chrono::milliseconds(0);
+};
+
+TEST(caching_resolver, resolve)
+{
+    auto upstream = std::make_shared<test_resolver>();
+    ftp::caching_resolver resolver(upstream);
+    boost::system::error_code ec;
+
+    std::vector<tcp::endpoint> endpoints = resolver.resolve("localhost", 21, ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(std::vector<tcp::endpoint>({ { make_address("::1"), 21 },
+                                           { make_address("127.0.0.1"), 21 } }), endpoints);
+    EXPECT_EQ(1, upstream->get_requests());
+
+    /* The cached result is reused for any port. */
+    endpoints = resolver.resolve("localhost", 2121, ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(std::vector<tcp::endpoint>({ { make_address("::1"), 2121 },
+                                           { make_address("127.0.0.1"), 2121 } }), endpoints);
+    EXPECT_EQ(1, upstream->get_requests());
+
+    resolver.clear();
+
+    endpoints = resolver.resolve("localhost", 21, ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(2, endpoints.size());
+    EXPECT_EQ(2, upstream->get_requests());
+}
+
+TEST(caching_resolver, negative_caching)
+{
+    auto upstream = std::make_shared<test_resolver>();
+    ftp::caching_resolver resolver(upstream);
+    boost::system::error_code ec;
+
+    std::vector<tcp::endpoint> endpoints = resolver.resolve("nonexistent", 21, ec);
+    EXPECT_EQ(boost::asio::error::host_not_found, ec);
+    EXPECT_TRUE(endpoints.empty());
+    EXPECT_EQ(1, upstream->get_requests());
+
+    endpoints = resolver.resolve("nonexistent", 21, ec);
+    EXPECT_EQ(boost::asio::error::host_not_found, ec);
+    EXPECT_TRUE(endpoints.empty());
+    EXPECT_EQ(1, upstream->get_requests());
+}
+
+TEST(caching_resolver, expiry)
+{
+    auto upstream = std::make_shared<test_resolver>();
+    ftp::caching_resolver resolver(upstream, std::chrono::milliseconds(50), std::chrono::milliseconds(0));
+    boost::system::error_code ec;
+
+    resolver.resolve("localhost", 21, ec);
+    resolver.resolve("localhost", 21, ec);
+    EXPECT_EQ(1, upstream->get_requests());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    resolver.resolve("localhost", 21, ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(2, upstream->get_requests());
+
+    /* Zero negative TTL disables negative caching. */
+    resolver.resolve("nonexistent", 21, ec);
+    resolver.resolve("nonexistent", 21, ec);
+    EXPECT_EQ(boost::asio::error::host_not_found, ec);
+    EXPECT_EQ(4, upstream->get_requests());
+}
+
+TEST(caching_resolver, concurrent_requests)
+{
+    auto upstream = std::make_shared<test_resolver>();
+    upstream->set_delay(std::chrono::milliseconds(100));
+    ftp::caching_resolver resolver(upstream);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> resolved = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&resolver, &resolved]()
+        {
+            boost::system::error_code ec;
+
+            if (resolver.resolve("localhost", 21, ec).size() == 2 && !ec)
+            {
+                resolved++;
+            }
+        });
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(8, resolved);
+    EXPECT_EQ(1, upstream->get_requests());
+}
+
+TEST(caching_resolver, deadline)
+{
+    auto upstream = std::make_shared<test_resolver>();
+    upstream->set_delay(std::chrono::milliseconds(500));
+    ftp::caching_resolver resolver(upstream);
+
+    std::thread thread([&resolver]()
+    {
+        boost::system::error_code ec;
+        resolver.resolve("localhost", 21, ec);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    /* The request waiting for the pending one stops at its deadline. */
+    auto start = std::chrono::steady_clock::now();
+    boost::system::error_code ec;
+
+    EXPECT_TRUE(resolver.resolve("localhost", 21, start + std::chrono::milliseconds(50), ec).empty());
+    EXPECT_EQ(boost::asio::error::timed_out, ec);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+
+    thread.join();
+
+    EXPECT_EQ(2, resolver.resolve("localhost", 21, ec).size());
+    EXPECT_EQ(1, upstream->get_requests());
+}
+
+TEST(system_resolver, resolve)
+{
+    ftp::system_resolver resolver;
+    boost::system::error_code ec;
+
+    std::vector<tcp::endpoint> endpoints = resolver.resolve("127.0.0.1", 2121, ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(std::vector<tcp::endpoint>({ { make_address("127.0.0.1"), 2121 } }), endpoints);
+}
+
+TEST(system_resolver, resolve_deadline)
+{
+    ftp::system_resolver resolver;
+    boost::system::error_code ec;
+
+    std::vector<tcp::endpoint> endpoints =
+        resolver.resolve("127.0.0.1", 2121, std::chrono::steady_clock::now() + std::chrono::seconds(10), ec);
+    ASSERT_FALSE(ec);
+    EXPECT_EQ(std::vector<tcp::endpoint>({ { make_address("127.0.0.1"), 2121 } }), endpoints);
+}
+
+TEST(default_resolver, set_default_resolver)
+{
+    ftp::resolver_ptr resolver = ftp::get_default_resolver();
+    ASSERT_TRUE(resolver);
+    EXPECT_EQ(resolver, ftp::get_default_resolver());
+
+    auto custom = std::make_shared<test_resolver>();
+    ftp::set_default_resolver(custom);
+    EXPECT_EQ(custom, ftp::get_default_resolver());
+
+    ftp::set_default_resolver(nullptr);
+    ASSERT_TRUE(ftp::get_default_resolver());
+    EXPECT_NE(custom, ftp::get_default_resolver());
+}
+
+} // namespace
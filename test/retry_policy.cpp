@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/error.hpp>
+#include <ftp/retry_policy.hpp>
+#include <boost/asio/error.hpp>
+
+using ftp::exponential_backoff;
+using namespace std::chrono_literals;
+
+TEST(exponential_backoff, defaults)
+{
+    exponential_backoff policy;
+
+    ASSERT_EQ(exponential_backoff::default_max_attempts, policy.get_max_attempts());
+    ASSERT_EQ(exponential_backoff::default_initial_delay, policy.get_initial_delay());
+    ASSERT_EQ(exponential_backoff::default_max_delay, policy.get_max_delay());
+    ASSERT_EQ(std::vector<std::uint16_t>({ 421, 425, 426, 450 }), policy.get_retryable_codes());
+}
+
+TEST(exponential_backoff, delays)
+{
+    exponential_backoff policy(10, 100ms, 1s);
+    ftp::reply reply(426, "426 Connection closed; transfer aborted.");
+
+    /* Each delay is between a half and the whole of the doubled delay. */
+    std::chrono::milliseconds expected = 100ms;
+
+    for (std::size_t attempt = 1; attempt < 10; attempt++)
+    {
+        std::optional<std::chrono::milliseconds> delay = policy.get_retry_delay(attempt, reply, {});
+
+        ASSERT_TRUE(delay);
+        ASSERT_GE(delay.value(), expected / 2);
+        ASSERT_LE(delay.value(), expected);
+
+        expected = std::min(expected * 2, std::chrono::milliseconds(1s));
+    }
+}
+
+TEST(exponential_backoff, max_attempts)
+{
+    exponential_backoff policy(3, 1ms, 1ms);
+    ftp::reply reply(421, "421 Service not available, closing control connection.");
+
+    ASSERT_TRUE(policy.get_retry_delay(1, reply, {}));
+    ASSERT_TRUE(policy.get_retry_delay(2, reply, {}));
+    ASSERT_FALSE(policy.get_retry_delay(3, reply, {}));
+}
+
+TEST(exponential_backoff, retryable_failures)
+{
+    exponential_backoff policy(5, 1ms, 1ms, { 450 });
+
+    ASSERT_TRUE(policy.get_retry_delay(1, ftp::reply(450, "450 File unavailable."), {}));
+    ASSERT_FALSE(policy.get_retry_delay(1, ftp::reply(550, "550 No such file or directory."), {}));
+
+    /* Network errors and timeouts are retried, unless the deadline is exceeded. */
+    ASSERT_TRUE(policy.get_retry_delay(1, std::nullopt, boost::asio::error::connection_reset));
+    ASSERT_TRUE(policy.get_retry_delay(1, std::nullopt, ftp::error::transfer_timeout));
+    ASSERT_FALSE(policy.get_retry_delay(1, std::nullopt, ftp::error::deadline_exceeded));
+
+    /* An exception without an error code, e.g. a malformed reply. */
+    ASSERT_FALSE(policy.get_retry_delay(1, std::nullopt, {}));
+}
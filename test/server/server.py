@@ -23,13 +23,303 @@
 
 import os
 import sys
+import zlib
+import socket
+import hashlib
 import logging
 import argparse
 from pyftpdlib.authorizers import DummyAuthorizer
+from pyftpdlib.handlers import DTPHandler
 from pyftpdlib.handlers import FTPHandler
+from pyftpdlib.handlers import TLS_DTPHandler
 from pyftpdlib.handlers import TLS_FTPHandler
 from pyftpdlib.servers import FTPServer
 
+class FileHashMixin:
+    """Implements the HASH command (draft-bryan-ftpext-hash-02) and
+    the legacy XCRC, XMD5, XSHA1, XSHA256, XSHA512 commands.
+
+    HASH does not support CRC32 on purpose, so that clients have
+    to fall back to the legacy commands.
+    """
+
+    hash_algorithms = {'SHA-1': 'sha1', 'SHA-256': 'sha256', 'SHA-512': 'sha512', 'MD5': 'md5'}
+    legacy_hash_commands = {'XCRC': 'crc32', 'XMD5': 'md5', 'XSHA1': 'sha1', 'XSHA256': 'sha256', 'XSHA512': 'sha512'}
+
+    proto_cmds = dict(FTPHandler.proto_cmds)
+    proto_cmds['HASH'] = dict(perm='r', auth=True, arg=True,
+                              help='Syntax: HASH <SP> file-name (get file hash).')
+    for command in legacy_hash_commands:
+        proto_cmds[command] = dict(perm='r', auth=True, arg=True,
+                                   help='Syntax: %s <SP> file-name (get file hash).' % command)
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self._hash_algorithm = 'SHA-1'
+        self._extra_feats.append('HASH ' + ';'.join(name + '*' if name == self._hash_algorithm else name
+                                                    for name in self.hash_algorithms))
+
+    def ftp_OPTS(self, line):
+        cmd, _, arg = line.partition(' ')
+        if cmd.upper() != 'HASH':
+            return super().ftp_OPTS(line)
+        if not arg:
+            self.respond('200 %s' % self._hash_algorithm)
+        elif arg.upper() in self.hash_algorithms:
+            self._hash_algorithm = arg.upper()
+            self.respond('200 %s' % self._hash_algorithm)
+        else:
+            self.respond('501 Unknown algorithm, current selection not changed.')
+
+    def ftp_HASH(self, path):
+        digest = self._get_file_hash(path, self.hash_algorithms[self._hash_algorithm])
+        if digest is not None:
+            size = os.path.getsize(path)
+            self.respond('213 %s 0-%d %s %s' % (self._hash_algorithm, size, digest, self.fs.fs2ftp(path)))
+
+    def ftp_XCRC(self, path):
+        self._process_legacy_hash_command('XCRC', path)
+
+    def ftp_XMD5(self, path):
+        self._process_legacy_hash_command('XMD5', path)
+
+    def ftp_XSHA1(self, path):
+        self._process_legacy_hash_command('XSHA1', path)
+
+    def ftp_XSHA256(self, path):
+        self._process_legacy_hash_command('XSHA256', path)
+
+    def ftp_XSHA512(self, path):
+        self._process_legacy_hash_command('XSHA512', path)
+
+    def _process_legacy_hash_command(self, command, path):
+        digest = self._get_file_hash(path, self.legacy_hash_commands[command])
+        if digest is not None:
+            self.respond('250 %s' % digest.upper())
+
+    def _get_file_hash(self, path, algorithm):
+        if not self.fs.isfile(self.fs.realpath(path)):
+            self.respond('550 %s is not retrievable.' % self.fs.fs2ftp(path))
+            return None
+        with open(path, 'rb') as file:
+            data = file.read()
+        if algorithm == 'crc32':
+            return '%08x' % zlib.crc32(data)
+        return hashlib.new(algorithm, data).hexdigest()
+
+
+class CompressingProducer:
+    """Compresses the data of a producer with deflate."""
+
+    def __init__(self, producer):
+        self._producer = producer
+        self._compressor = zlib.compressobj()
+        self._finished = False
+
+    def more(self):
+        while not self._finished:
+            data = self._producer.more()
+            if not data:
+                self._finished = True
+                return self._compressor.flush()
+            data = self._compressor.compress(data)
+            if data:
+                return data
+        return b''
+
+
+class BytesProducer:
+    """Producer for the data passed to push()."""
+
+    def __init__(self, data):
+        self._data = data
+
+    def more(self):
+        data, self._data = self._data, b''
+        return data
+
+
+class BlockProducer:
+    """Sends the data of a producer in blocks (MODE B) followed by
+    the EOF block. In the binary type each block is followed by
+    a restart marker holding the file position.
+    """
+
+    max_block_size = 4096
+
+    def __init__(self, producer, dtp):
+        self._producer = producer
+        self._dtp = dtp
+        self._position = None
+        file = getattr(producer, 'file', None)
+        if file is not None and dtp.cmd_channel._current_type == 'i':
+            self._position = file.tell()
+        self._finished = False
+
+    def more(self):
+        if self._finished:
+            return b''
+        data = self._producer.more()
+        if not data:
+            self._finished = True
+            self._dtp.ioloop.call_later(0, self._dtp.complete_block_transfer)
+            return make_block(BLOCK_EOF, b'')
+        blocks = []
+        for pos in range(0, len(data), self.max_block_size):
+            block = data[pos:pos + self.max_block_size]
+            blocks.append(make_block(0, block))
+            if self._position is not None:
+                self._position += len(block)
+                blocks.append(make_block(BLOCK_RESTART_MARKER, str(self._position).encode()))
+        return b''.join(blocks)
+
+
+BLOCK_EOF = 64
+BLOCK_RESTART_MARKER = 16
+
+
+def make_block(descriptor, data):
+    return bytes([descriptor]) + len(data).to_bytes(2, 'big') + bytes(data)
+
+
+class TransmissionModeDTPMixin:
+    """Compresses and decompresses the transferred data in MODE Z.
+    Sends and receives the data in blocks in MODE B, keeping the data
+    connection open after the transfer.
+    """
+
+    def __init__(self, *args, **kwargs):
+        self._block_buffer = b''
+        self._block_idle = False
+        super().__init__(*args, **kwargs)
+
+    def _transmission_mode(self):
+        return self.cmd_channel._transmission_mode
+
+    def use_sendfile(self):
+        return self._transmission_mode() == 'S' and super().use_sendfile()
+
+    def push(self, data):
+        if self._transmission_mode() == 'B':
+            self.push_with_producer(BytesProducer(data))
+            return
+        if self._transmission_mode() == 'Z':
+            compressor = zlib.compressobj()
+            data = compressor.compress(data) + compressor.flush()
+        super().push(data)
+
+    def push_with_producer(self, producer):
+        if self._transmission_mode() == 'Z':
+            producer = CompressingProducer(producer)
+        elif self._transmission_mode() == 'B':
+            self._block_idle = False
+            self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            producer = BlockProducer(producer, self)
+        super().push_with_producer(producer)
+
+    def close_when_done(self):
+        # In MODE B the data connection stays open after the transfer.
+        if self._transmission_mode() != 'B':
+            super().close_when_done()
+
+    def enable_receiving(self, type, cmd):
+        super().enable_receiving(type, cmd)
+        data_wrapper = self._data_wrapper
+
+        def wrap(chunk):
+            return data_wrapper(chunk) if data_wrapper is not None else chunk
+
+        if self._transmission_mode() == 'Z':
+            decompressor = zlib.decompressobj()
+            self._data_wrapper = lambda chunk: wrap(decompressor.decompress(chunk))
+        elif self._transmission_mode() == 'B':
+            self._block_idle = False
+            self._block_buffer = b''
+            self._data_wrapper = lambda chunk: wrap(self._parse_blocks(chunk))
+
+    def _parse_blocks(self, chunk):
+        self._block_buffer += chunk
+        data = []
+        while len(self._block_buffer) >= 3 and self.receive:
+            descriptor = self._block_buffer[0]
+            size = int.from_bytes(self._block_buffer[1:3], 'big')
+            if len(self._block_buffer) < 3 + size:
+                break
+            block = self._block_buffer[3:3 + size]
+            self._block_buffer = self._block_buffer[3 + size:]
+            if not descriptor & BLOCK_RESTART_MARKER:
+                data.append(block)
+            if descriptor & BLOCK_EOF:
+                # Complete the transfer after the data is written to the file.
+                self.receive = False
+                self.ioloop.call_later(0, self.complete_block_transfer)
+        return b''.join(data)
+
+    def complete_block_transfer(self):
+        if self._closed:
+            return
+        if self.file_obj is not None and not self.file_obj.closed:
+            self.file_obj.close()
+        self.file_obj = None
+        self.receive = False
+        self.transfer_finished = False
+        self._data_wrapper = None
+        self._resp = ()
+        self._block_idle = True
+        self.cmd_channel.respond('250 Transfer complete.')
+
+    def handle_close(self):
+        if self._block_idle:
+            # The client has closed the idle data connection.
+            self.close()
+        else:
+            super().handle_close()
+
+
+class TransmissionModeMixin:
+    """Implements the block (MODE B) and compressed (MODE Z,
+    draft-preston-ftpext-deflate-04) transmission modes.
+    """
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self._transmission_mode = 'S'
+        self._extra_feats.append('MODE Z')
+
+    def ftp_MODE(self, line):
+        mode = line.upper()
+        if mode in ('S', 'B', 'Z'):
+            # Close the data connection kept open in MODE B.
+            if self.data_channel is not None:
+                self.data_channel.close()
+                self.data_channel = None
+            self._transmission_mode = mode
+            self.respond('200 Transfer mode set to: %s' % mode)
+        else:
+            super().ftp_MODE(line)
+
+    def ftp_REIN(self, line):
+        self._transmission_mode = 'S'
+        super().ftp_REIN(line)
+
+
+class ExtendedDTPHandler(TransmissionModeDTPMixin, DTPHandler):
+    pass
+
+
+class ExtendedTLS_DTPHandler(TransmissionModeDTPMixin, TLS_DTPHandler):
+    pass
+
+
+class ExtendedFTPHandler(FileHashMixin, TransmissionModeMixin, FTPHandler):
+    dtp_handler = ExtendedDTPHandler
+
+
+class ExtendedTLS_FTPHandler(FileHashMixin, TransmissionModeMixin, TLS_FTPHandler):
+    dtp_handler = ExtendedTLS_DTPHandler
+    proto_cmds = {**TLS_FTPHandler.proto_cmds, **FileHashMixin.proto_cmds}
+
+
 def main():
     arg_parser = argparse.ArgumentParser()
     arg_parser.add_argument('root_directory')
@@ -52,14 +342,14 @@ def main():
     authorizer.add_user("alice", "password", args.root_directory, perm = "elradfmwM")
 
     if args.use_ssl == 'yes':
-        handler = TLS_FTPHandler
+        handler = ExtendedTLS_FTPHandler
         handler.certfile = os.path.join(sys.path[0], 'certs/server_cert.pem')
         handler.keyfile = os.path.join(sys.path[0], 'certs/server_cert.key')
         handler.tls_control_required = True
         handler.tls_data_required = True
         log_filename = "ssl_server.log"
     else:
-        handler = FTPHandler
+        handler = ExtendedFTPHandler
         log_filename = "server.log"
 
     handler.authorizer = authorizer
@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <ftp/session_manager.hpp>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ftp::session_manager;
+using ftp::session_ptr;
+
+TEST(session_manager, shard_count)
+{
+    session_manager manager(0, false);
+
+    ASSERT_EQ(std::max(std::thread::hardware_concurrency(), 1u), manager.get_shard_count());
+}
+
+TEST(session_manager, least_loaded_shard)
+{
+    session_manager manager(4, false);
+    std::vector<session_ptr> sessions;
+    std::set<std::size_t> shards;
+
+    /* The sessions to the same host do not share a shard while another one is free. */
+    for (int i = 0; i < 4; ++i)
+    {
+        sessions.push_back(manager.create_session("ftp.example.com"));
+        shards.insert(sessions.back()->get_shard_index());
+        ASSERT_EQ("ftp.example.com", sessions.back()->get_hostname());
+    }
+
+    ASSERT_EQ(4, shards.size());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        sessions.push_back(manager.create_session("ftp.example.org"));
+    }
+
+    for (std::size_t i = 0; i < manager.get_shard_count(); ++i)
+    {
+        ASSERT_EQ(2, manager.get_session_count(i));
+    }
+
+    /* A freed shard takes the next session. */
+    std::size_t freed_shard = sessions.front()->get_shard_index();
+    sessions.erase(sessions.begin());
+
+    sessions.push_back(manager.create_session("ftp.example.com"));
+    ASSERT_EQ(freed_shard, sessions.back()->get_shard_index());
+
+    sessions.clear();
+
+    for (std::size_t i = 0; i < manager.get_shard_count(); ++i)
+    {
+        ASSERT_EQ(0, manager.get_session_count(i));
+    }
+}
+
+TEST(session_manager, submit)
+{
+    session_manager manager(2, false);
+    session_ptr session = manager.create_session("localhost");
+
+    std::thread::id shard_thread = session->submit([](ftp::client &)
+    {
+        return std::this_thread::get_id();
+    }).get();
+
+    ASSERT_NE(std::this_thread::get_id(), shard_thread);
+
+    /* The operations of a session run in the order of submission on the same thread. */
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        futures.push_back(session->submit([&order, i, shard_thread](ftp::client & client)
+        {
+            EXPECT_EQ(shard_thread, std::this_thread::get_id());
+            EXPECT_FALSE(client.is_connected());
+            order.push_back(i);
+        }));
+    }
+
+    for (std::future<void> & future : futures)
+    {
+        future.get();
+    }
+
+    ASSERT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }), order);
+
+    std::future<int> failed = session->submit([](ftp::client &) -> int
+    {
+        throw std::runtime_error("failed");
+    });
+
+    ASSERT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(session_manager, release_sessions_across_shards)
+{
+    session_manager manager(2, false);
+    session_ptr first = manager.create_session("localhost");
+    session_ptr second = manager.create_session("localhost");
+
+    ASSERT_NE(first->get_shard_index(), second->get_shard_index());
+
+    /* Each shard releases the last reference to the session of the other one at the same time. */
+    std::atomic<int> started = 0;
+
+    auto release = [&started](session_ptr other)
+    {
+        return [&started, other = std::move(other)](ftp::client &) mutable
+        {
+            started++;
+
+            while (started < 2)
+            {
+                std::this_thread::yield();
+            }
+
+            other.reset();
+        };
+    };
+
+    std::future<void> first_released = second->submit(release(first));
+    std::future<void> second_released = first->submit(release(second));
+
+    first.reset();
+    second.reset();
+
+    ASSERT_EQ(std::future_status::ready, first_released.wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(std::future_status::ready, second_released.wait_for(std::chrono::seconds(5)));
+}
+
+TEST(session_manager, session_outlives_manager)
+{
+    session_ptr session;
+
+    {
+        session_manager manager(1, false);
+        session = manager.create_session("localhost");
+    }
+
+    ASSERT_THROW(session->submit([](ftp::client &) { }), ftp::ftp_exception);
+}
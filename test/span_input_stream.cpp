@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <string>
+#include <ftp/stream/span_input_stream.hpp>
+
+namespace
+{
+
+TEST(span_input_stream, read)
+{
+    std::string data = "0123456789";
+    ftp::span_input_stream stream(data.data(), data.size());
+
+    EXPECT_EQ(data.size(), stream.get_size());
+
+    std::string result;
+    std::string buf(3, '\0');
+
+    for (;;)
+    {
+        std::size_t size = stream.read(buf.data(), buf.size());
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        result.append(buf.data(), size);
+    }
+
+    EXPECT_EQ(data, result);
+}
+
+TEST(span_input_stream, peek_consume)
+{
+    std::string data = "0123456789";
+    ftp::span_input_stream stream(data);
+
+    std::optional<std::string_view> region = stream.peek(4);
+    ASSERT_TRUE(region.has_value());
+    EXPECT_EQ("0123", region.value());
+
+    /* The memory of the caller is exposed. */
+    EXPECT_EQ(data.data(), region->data());
+
+    stream.consume(2);
+
+    /* Mixed with read(). */
+    std::string buf(3, '\0');
+    ASSERT_EQ(3, stream.read(buf.data(), buf.size()));
+    EXPECT_EQ("234", buf);
+
+    region = stream.peek(100);
+    ASSERT_TRUE(region.has_value());
+    EXPECT_EQ("56789", region.value());
+
+    stream.consume(region->size());
+
+    region = stream.peek(100);
+    ASSERT_TRUE(region.has_value());
+    EXPECT_TRUE(region->empty());
+    EXPECT_EQ(0, stream.read(buf.data(), buf.size()));
+}
+
+} // namespace
@@ -55,6 +55,16 @@ TEST(utils, split_string)
                 ElementsAre("127", "0", "0", "1", "198", "65"));
 }
 
+TEST(utils, equals_ignore_case)
+{
+    EXPECT_TRUE(ftp::detail::utils::equals_ignore_case("", ""));
+    EXPECT_TRUE(ftp::detail::utils::equals_ignore_case("abc", "abc"));
+    EXPECT_TRUE(ftp::detail::utils::equals_ignore_case("MODE Z", "mode z"));
+    EXPECT_FALSE(ftp::detail::utils::equals_ignore_case("abc", "abd"));
+    EXPECT_FALSE(ftp::detail::utils::equals_ignore_case("abc", "ab"));
+    EXPECT_FALSE(ftp::detail::utils::equals_ignore_case("", "a"));
+}
+
 TEST(utils, try_parse_uint8)
 {
     std::uint8_t result;
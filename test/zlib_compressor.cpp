@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Denis Kovalchuk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <ftp/detail/zlib_compressor.hpp>
+#include <ftp/ftp_exception.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using ftp::detail::zlib_compressor;
+using ftp::detail::zlib_decompressor;
+
+std::vector<char> compress(const std::string & data)
+{
+    zlib_compressor compressor;
+    std::vector<char> output;
+
+    /* Feed the data in chunks to check the streaming compression. */
+    for (std::size_t pos = 0; pos < data.size(); pos += 1000)
+    {
+        std::string chunk = data.substr(pos, 1000);
+        compressor.compress(chunk.data(), chunk.size(), output);
+    }
+
+    compressor.finish(output);
+
+    return output;
+}
+
+/* Inflates the data into a buffer of the given size. Returns the largest output of one call. */
+std::size_t decompress(zlib_decompressor & decompressor, const char *data, std::size_t size,
+                       std::size_t buffer_size, std::string & output)
+{
+    std::vector<char> buf(buffer_size);
+    std::size_t max_size = 0;
+
+    decompressor.set_input(data, size);
+
+    while (std::size_t out_size = decompressor.decompress(buf.data(), buf.size()))
+    {
+        output.append(buf.data(), out_size);
+        max_size = std::max(max_size, out_size);
+    }
+
+    return max_size;
+}
+
+TEST(zlib_compressor, compress_decompress)
+{
+    if (!zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    for (const std::string & data : { std::string(),
+                                      std::string("content"),
+                                      std::string(100000, 'a') })
+    {
+        std::vector<char> compressed = compress(data);
+
+        if (data.size() > 1000)
+        {
+            EXPECT_LT(compressed.size(), data.size() / 10);
+        }
+
+        zlib_decompressor decompressor;
+        std::string output;
+
+        /* Feed the compressed data byte by byte. */
+        for (char ch : compressed)
+        {
+            EXPECT_FALSE(decompressor.is_finished());
+            decompress(decompressor, &ch, 1, 8192, output);
+        }
+
+        EXPECT_TRUE(decompressor.is_finished());
+        EXPECT_EQ(data, output);
+    }
+}
+
+TEST(zlib_compressor, bounded_output)
+{
+    if (!zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    std::string data(1000000, 'a');
+    std::vector<char> compressed = compress(data);
+
+    zlib_decompressor decompressor;
+    std::string output;
+
+    /* The whole stream is inflated from one chunk, one buffer per call. */
+    EXPECT_EQ(1000, decompress(decompressor, compressed.data(), compressed.size(), 1000, output));
+    EXPECT_TRUE(decompressor.is_finished());
+    EXPECT_EQ(data, output);
+}
+
+TEST(zlib_compressor, truncated_data)
+{
+    if (!zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    std::vector<char> compressed = compress(std::string(10000, 'a'));
+
+    zlib_decompressor decompressor;
+    std::string output;
+    decompress(decompressor, compressed.data(), compressed.size() - 1, 8192, output);
+
+    EXPECT_FALSE(decompressor.is_finished());
+}
+
+TEST(zlib_compressor, invalid_data)
+{
+    if (!zlib_compressor::is_available())
+    {
+        GTEST_SKIP() << "The library is built without zlib.";
+    }
+
+    std::string data = "not compressed data";
+
+    zlib_decompressor decompressor;
+    std::string output;
+
+    ASSERT_THROW(decompress(decompressor, data.data(), data.size(), 8192, output), ftp::ftp_exception);
+}
+
+} // namespace